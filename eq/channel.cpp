@@ -32,6 +32,7 @@
 #ifndef EQ_2_0_API
 #  include "configEvent.h"
 #endif
+#include "detail/compressorSelector.h"
 #include "detail/fileFrameWriter.h"
 #include "error.h"
 #include "frame.h"
@@ -45,6 +46,7 @@
 #include "nodeFactory.h"
 #include "pipe.h"
 #include "pixelData.h"
+#include "roiFinder.h"
 #include "server.h"
 #include "systemWindow.h"
 #include "view.h"
@@ -60,8 +62,8 @@
 #include <co/connectionDescription.h>
 #include <co/exception.h>
 #include <co/objectICommand.h>
-#include <co/queueSlave.h>
 #include <co/sendToken.h>
+#include <lunchbox/clock.h>
 #include <lunchbox/rng.h>
 #include <lunchbox/scopedMutex.h>
 #include <pression/plugins/compressor.h>
@@ -91,6 +93,359 @@ using detail::STATE_RUNNING;
 using detail::STATE_FAILED;
 /** @endcond */
 
+namespace
+{
+/** The prepared pixel data of one image for transmission. */
+struct TransmitData
+{
+    explicit TransmitData( Image* image_ )
+        : image( image_ ), buffers( Frame::BUFFER_NONE ), size( 0 ) {}
+
+    Image* image;
+    uint32_t buffers;
+    std::vector< const PixelData* > pixelDatas;
+    std::vector< float > qualities;
+    uint64_t size; //!< image headers, chunk sizes and chunks
+};
+
+/**
+ * Sends command payload on a locked connection.
+ *
+ * In gather mode, headers and small chunks are collected and sent together
+ * with the next large chunk, which reduces the number of send calls for
+ * frames with many small images.
+ */
+class TransmitBuffer
+{
+public:
+    TransmitBuffer( co::ConnectionPtr connection, const bool gather )
+        : _connection( connection ), _gather( gather ), _nSends( 0 )
+        , _nBytes( 0 ) {}
+
+    ~TransmitBuffer() { LBASSERT( _buffer.empty( )); }
+
+    void send( const void* data, const uint64_t size )
+    {
+        _nBytes += size;
+        if( _gather && size < _gatherSize )
+        {
+            if( _buffer.size() + size > _gatherSize )
+                flush();
+            const uint8_t* bytes = static_cast< const uint8_t* >( data );
+            _buffer.insert( _buffer.end(), bytes, bytes + size );
+            return;
+        }
+
+        flush();
+        _connection->send( data, size, true );
+        ++_nSends;
+    }
+
+    void flush()
+    {
+        if( _buffer.empty( ))
+            return;
+        _connection->send( _buffer.data(), _buffer.size(), true );
+        _buffer.clear();
+        ++_nSends;
+    }
+
+    /** Send the header of a command owning the following payload. */
+    void sendHeader( co::ObjectOCommand& command, const uint64_t size )
+    {
+        LBASSERT( _buffer.empty( ));
+        command.sendHeader( size );
+        ++_nSends;
+    }
+
+    uint32_t getNumSends() const { return _nSends; }
+    uint64_t getNumBytes() const { return _nBytes; }
+
+private:
+    static const size_t _gatherSize = 65536;
+
+    co::ConnectionPtr _connection;
+    const bool _gather;
+    std::vector< uint8_t > _buffer;
+    uint32_t _nSends;
+    uint64_t _nBytes;
+};
+
+/** Resolve EQ_COMPRESSOR_ADAPTIVE of the given images for the receivers. */
+void _selectCompressors( FrameData& frameData,
+                         const std::vector< uint64_t >& imageIndices,
+                         const co::NodeIDs& receivers )
+{
+    detail::CompressorSelector& selector =
+        detail::CompressorSelector::getInstance();
+    const Images& images = frameData.getImages();
+    const Frame::Buffer buffers[] = { Frame::BUFFER_COLOR,
+                                      Frame::BUFFER_DEPTH };
+
+    for( unsigned j = 0; j < 2; ++j )
+    {
+        const Frame::Buffer buffer = buffers[j];
+        if( frameData.getCompressor( buffer ) != EQ_COMPRESSOR_ADAPTIVE )
+            continue;
+
+        BOOST_FOREACH( const uint64_t imageIndex, imageIndices )
+        {
+            Image* image = images[ imageIndex ];
+            if( image->hasPixelData( buffer ))
+                image->useCompressor( buffer,
+                                      selector.choose( *image, buffer,
+                                                       receivers ));
+        }
+    }
+}
+
+/** Crop the pixel data of an image to the given part of its viewport. */
+void _cropImage( Image& image, const PixelViewport& region )
+{
+    if( !region.hasArea( ))
+    {
+        image.setPixelViewport( region ); // nothing left to transmit
+        return;
+    }
+
+    const PixelViewport pvp = image.getPixelViewport();
+    const Frame::Buffer buffers[] = { Frame::BUFFER_COLOR,
+                                      Frame::BUFFER_DEPTH };
+    PixelData datas[2];
+    std::vector< uint8_t > pixels[2];
+
+    for( unsigned j = 0; j < 2; ++j )
+    {
+        const Frame::Buffer buffer = buffers[j];
+        if( !image.hasPixelData( buffer ))
+            continue;
+
+        const PixelData& data = image.getPixelData( buffer );
+        const size_t rowSize = region.w * data.pixelSize;
+        const size_t stride = pvp.w * data.pixelSize;
+        const uint8_t* src = image.getPixelPointer( buffer ) +
+                             ( region.y - pvp.y ) * stride +
+                             ( region.x - pvp.x ) * data.pixelSize;
+
+        pixels[j].resize( rowSize * region.h );
+        for( int32_t y = 0; y < region.h; ++y )
+            ::memcpy( &pixels[j][ y * rowSize ], src + y * stride, rowSize );
+
+        datas[j].internalFormat = data.internalFormat;
+        datas[j].externalFormat = data.externalFormat;
+        datas[j].pixelSize = data.pixelSize;
+        datas[j].pvp = PixelViewport( data.pvp.x + region.x - pvp.x,
+                                      data.pvp.y + region.y - pvp.y,
+                                      region.w, region.h );
+        datas[j].pixels = pixels[j].data();
+    }
+
+    image.setPixelViewport( region ); // invalidates the pixel data
+    for( unsigned j = 0; j < 2; ++j )
+        if( !pixels[j].empty( ))
+            image.setPixelData( buffers[j], datas[j] );
+}
+
+/** @return true if the pixel data of the image can be cropped in place. */
+bool _canTrim( const Image& image )
+{
+    if( image.getStorageType() != Frame::TYPE_MEMORY ||
+        image.getZoom() != Zoom::NONE ||
+        image.getContext().pixel != Pixel::ALL )
+    {
+        return false;
+    }
+
+    // downloaders may deliver pixel data not matching the image
+    const PixelViewport& pvp = image.getPixelViewport();
+    const Frame::Buffer buffers[] = { Frame::BUFFER_COLOR,
+                                      Frame::BUFFER_DEPTH };
+    for( unsigned j = 0; j < 2; ++j )
+    {
+        if( !image.hasPixelData( buffers[j] ))
+            continue;
+
+        const PixelData& data = image.getPixelData( buffers[j] );
+        if( data.pvp.w != pvp.w || data.pvp.h != pvp.h )
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Trim images in main memory to the non-empty pixels of their depth buffer or,
+ * for images using alpha, of their color buffer. The finder reuses the areas
+ * of the last frame where the occupancy did not change.
+ */
+void _trimImages( Channel* channel, ROIFinder& finder, FrameData& frameData,
+                  const std::vector< uint64_t >& imageIndices,
+                  const uint32_t frameNumber, const uint32_t taskID )
+{
+    const Images& images = frameData.getImages();
+    ChannelStatistics event( Statistic::CHANNEL_ROI, channel, frameNumber );
+    event.event.data.statistic.task = taskID;
+    event.event.data.statistic.ratio = 0.f;
+    event.event.data.statistic.plugins[0] = 0;
+    float reused = 0.f;
+    float total = 0.f;
+
+    BOOST_FOREACH( const uint64_t imageIndex, imageIndices )
+    {
+        Image* image = images[ imageIndex ];
+        if( !_canTrim( *image ))
+            continue;
+
+        const PixelViewport& pvp = image->getPixelViewport();
+        Frame::Buffer buffer = Frame::BUFFER_NONE;
+        ROIFinder::MaskType type = ROIFinder::MASK_DEPTH;
+
+        if( image->hasPixelData( Frame::BUFFER_DEPTH ) &&
+            image->getExternalFormat( Frame::BUFFER_DEPTH ) ==
+                EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT )
+        {
+            buffer = Frame::BUFFER_DEPTH;
+        }
+        else if( image->hasPixelData( Frame::BUFFER_COLOR ) &&
+                 image->getAlphaUsage() && image->hasAlpha() &&
+                 ( image->getExternalFormat( Frame::BUFFER_COLOR ) ==
+                       EQ_COMPRESSOR_DATATYPE_RGBA ||
+                   image->getExternalFormat( Frame::BUFFER_COLOR ) ==
+                       EQ_COMPRESSOR_DATATYPE_BGRA ))
+        {
+            buffer = Frame::BUFFER_COLOR;
+            type = ROIFinder::MASK_ALPHA;
+        }
+        if( buffer == Frame::BUFFER_NONE )
+            continue;
+
+        const PixelViewports regions = finder.findRegions(
+            reinterpret_cast< const uint32_t* >(
+                image->getPixelPointer( buffer )), type, pvp, 0, frameNumber );
+        event.event.data.statistic.plugins[0] += uint32_t( regions.size( ));
+        reused += finder.getReusedRatio() * float( pvp.getArea( ));
+        total += float( pvp.getArea( ));
+
+        PixelViewport region( pvp.x, pvp.y, 0, 0 );
+        for( size_t i = 0; i < regions.size(); ++i )
+        {
+            if( region.hasArea( ))
+                region.merge( regions[i] );
+            else
+                region = regions[i];
+        }
+
+        if( region != pvp )
+        {
+            LBLOG( LOG_ASSEMBLY ) << "Trim " << pvp << " to " << region
+                                  << std::endl;
+            _cropImage( *image, region );
+        }
+    }
+    if( total > 0.f )
+        event.event.data.statistic.ratio = reused / total;
+}
+
+/** Compress or fetch the pixel data of an image, @return false if empty. */
+bool _prepareTransmit( Channel* channel, TransmitData& transmit,
+                       const uint32_t frameNumber, const uint32_t taskID,
+                       const uint32_t compressBuffers )
+{
+    Image* image = transmit.image;
+    uint64_t rawSize( 0 );
+    ChannelStatistics compressEvent( Statistic::CHANNEL_FRAME_COMPRESS,
+                                     channel, frameNumber,
+                                     compressBuffers ? AUTO : OFF );
+    compressEvent.event.data.statistic.task = taskID;
+    compressEvent.event.data.statistic.ratio = 1.0f;
+    compressEvent.event.data.statistic.plugins[0] = EQ_COMPRESSOR_NONE;
+    compressEvent.event.data.statistic.plugins[1] = EQ_COMPRESSOR_NONE;
+
+    // Prepare image pixel data
+    Frame::Buffer buffers[] = { Frame::BUFFER_COLOR, Frame::BUFFER_DEPTH };
+
+    // for each image attachment
+    for( unsigned j = 0; j < 2; ++j )
+    {
+        Frame::Buffer buffer = buffers[j];
+        if( !image->hasPixelData( buffer ))
+            continue;
+
+        // format, type, nChunks, compressor name
+        transmit.size += sizeof( FrameData::ImageHeader );
+
+        float compressTime = 0.f;
+        const PixelData& data = ( compressBuffers & buffer ) ?
+            image->compressPixelData( buffer, compressTime ) :
+            image->getPixelData( buffer );
+        transmit.pixelDatas.push_back( &data );
+        transmit.qualities.push_back( image->getQuality( buffer ));
+
+        if( data.compressedData.isCompressed( ))
+        {
+            transmit.size += data.compressedData.getSize() +
+                       data.compressedData.chunks.size() * sizeof( uint64_t );
+            compressEvent.event.data.statistic.plugins[j] =
+                data.compressedData.compressor;
+            detail::CompressorSelector::getInstance().addCompress(
+                data.compressedData.compressor,
+                image->getPixelDataSize( buffer ),
+                data.compressedData.getSize(), compressTime );
+        }
+        else
+            transmit.size += sizeof( uint64_t ) +
+                             image->getPixelDataSize( buffer );
+
+        transmit.buffers |= buffer;
+        rawSize += image->getPixelDataSize( buffer );
+    }
+
+    if( rawSize > 0 )
+        compressEvent.event.data.statistic.ratio =
+            float( transmit.size ) / float( rawSize );
+    return !transmit.pixelDatas.empty();
+}
+
+/** Send the image headers and pixel data of one image. */
+void _sendPixelData( const TransmitData& transmit, TransmitBuffer& buffer )
+{
+    for( size_t j = 0; j < transmit.pixelDatas.size(); ++j )
+    {
+        const PixelData* data = transmit.pixelDatas[j];
+        const bool isCompressed = data->compressedData.isCompressed();
+        const uint32_t nChunks = isCompressed ?
+            uint32_t( data->compressedData.chunks.size( )) : 1;
+
+        const FrameData::ImageHeader header =
+              { data->internalFormat, data->externalFormat,
+                data->pixelSize, data->pvp,
+                isCompressed ? data->compressedData.compressor :
+                               EQ_COMPRESSOR_NONE,
+                data->compressorFlags, nChunks, transmit.qualities[ j ] };
+
+        buffer.send( &header, sizeof( header ));
+
+        if( isCompressed )
+        {
+            BOOST_FOREACH( const pression::CompressorChunk& chunk,
+                           data->compressedData.chunks )
+            {
+                const uint64_t dataSize = chunk.getNumBytes();
+
+                buffer.send( &dataSize, sizeof( dataSize ));
+                if( dataSize > 0 )
+                    buffer.send( chunk.data, dataSize );
+            }
+        }
+        else
+        {
+            const uint64_t dataSize = data->pvp.getArea() * data->pixelSize;
+            buffer.send( &dataSize, sizeof( dataSize ));
+            buffer.send( data->pixels, dataSize );
+        }
+    }
+}
+}
+
 Channel::Channel( Window* parent )
         : Super( parent )
         , _impl( new detail::Channel )
@@ -488,13 +843,6 @@ const View* Channel::getView() const
     return pipe->getView( getContext().view );
 }
 
-co::QueueSlave* Channel::_getQueue( const uint128_t& queueID )
-{
-    LB_TS_THREAD( _pipeThread );
-    Pipe* pipe = getPipe();
-    return pipe->getQueue( queueID );
-}
-
 View* Channel::getNativeView()
 {
     LB_TS_THREAD( _pipeThread );
@@ -1055,14 +1403,22 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
     int64_t readbackTime = 0;
     bool hasAsyncReadback = false;
     const uint32_t timeout = getConfig()->getTimeout();
-
-    co::QueueSlave* queue = _getQueue( queueID );
-    LBASSERT( queue );
+    uint64_t nTiles = 0;
+    PixelViewports tilePVPs; // for cost-based tile ordering on the server
+    std::vector< float > tileTimes;
+    lunchbox::Clock tileClock;
+
+    // The tiles are fetched from the node-wide queue, so that idle pipes
+    // process the tiles prefetched for their busy siblings
+    Node* node = getNode();
+    LBASSERT( queueID != 0 );
     for( ;; )
     {
-        co::ObjectICommand tileCmd = queue->pop( timeout );
+        co::ObjectICommand tileCmd = node->popTile( queueID, timeout );
         if( !tileCmd.isValid( ))
             break;
+        ++nTiles;
+        tileClock.reset();
 
         const Tile& tile = tileCmd.read< Tile >();
         context.apply( tile, isLocal );
@@ -1117,6 +1473,19 @@ void Channel::_frameTiles( RenderContext& context, const bool isLocal,
             if( _asyncFinishReadback( nImages, frames ))
                 hasAsyncReadback = true;
         }
+
+        tilePVPs.push_back( tile.pvp );
+        tileTimes.push_back( tileClock.getTimef( ));
+    }
+
+    if( !tilePVPs.empty( ))
+        send( getServer(), fabric::CMD_CHANNEL_FRAME_TILE_COSTS )
+            << getCurrentFrame() << tilePVPs << tileTimes;
+
+    {
+        ChannelStatistics event( Statistic::CHANNEL_TILES, this );
+        event.event.data.statistic.startTime = startTime;
+        event.event.data.statistic.plugins[0] = nTiles;
     }
 
     if( tasks & fabric::TASK_CLEAR )
@@ -1233,6 +1602,7 @@ bool Channel::_asyncFinishReadback( const std::vector< size_t >& imagePos,
         const Eye eye = getEye();
         const std::vector< uint128_t >& nodes = frame->getInputNodes( eye );
         const co::NodeIDs& netNodes = frame->getInputNetNodes(eye);
+        std::vector< uint64_t > transmitImages;
 
         for( uint64_t j = imagePos[i]; j < nImages; ++j )
         {
@@ -1248,9 +1618,12 @@ bool Channel::_asyncFinishReadback( const std::vector< size_t >& imagePos,
                         << getTaskID() << nodes << netNodes;
             }
             else // transmit images asynchronously
-                _asyncTransmit( frameData, frameNumber, j, nodes, netNodes,
-                                getTaskID( ));
+                transmitImages.push_back( j );
         }
+
+        if( !transmitImages.empty( ))
+            _asyncTransmit( frameData, frameNumber, transmitImages, nodes,
+                            netNodes, getTaskID( ));
     }
     return hasAsyncReadback;
 }
@@ -1283,17 +1656,26 @@ void Channel::_finishReadback( const co::ObjectVersion& frameDataVersion,
     LBASSERT( !image->hasAsyncReadback( ));
 
     // schedule async image tranmission
-    _asyncTransmit( frameData, frameNumber, imageIndex, nodes, netNodes,
+    _asyncTransmit( frameData, frameNumber,
+                    std::vector< uint64_t >( 1, imageIndex ), nodes, netNodes,
                     taskID );
 }
 
 void Channel::_asyncTransmit( FrameDataPtr frame, const uint32_t frameNumber,
-                              const uint64_t image,
+                              const std::vector< uint64_t >& images,
                               const std::vector< uint128_t >& nodes,
                               const co::NodeIDs& netNodes,
                               const uint32_t taskID )
 {
     LBASSERT( nodes.size() == netNodes.size( ));
+    if( getIAttribute( IATTR_HINT_TRIM_TRANSMIT ) == ON )
+    {
+        lunchbox::ScopedWrite mutex( _impl->roiFinder );
+        _trimImages( this, _impl->roiFinder.data, *frame, images, frameNumber,
+                     taskID );
+    }
+    _selectCompressors( *frame, images, netNodes );
+
     co::NodeIDs::const_iterator j = netNodes.begin();
     for( std::vector< uint128_t >::const_iterator i = nodes.begin();
          i != nodes.end(); ++i, ++j )
@@ -1304,17 +1686,17 @@ void Channel::_asyncTransmit( FrameDataPtr frame, const uint32_t frameNumber,
                                         << " receiver " << *i << " on " << *j
                                         << std::endl;
         send( getLocalNode(), fabric::CMD_CHANNEL_FRAME_TRANSMIT_IMAGE )
-                << co::ObjectVersion( frame ) << *i << *j << image
+                << co::ObjectVersion( frame ) << *i << *j << images
                 << frameNumber << taskID;
     }
 }
 
-void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
-                              const uint128_t& nodeID,
-                              const co::NodeID& netNodeID,
-                              const uint64_t imageIndex,
-                              const uint32_t frameNumber,
-                              const uint32_t taskID )
+void Channel::_transmitImages( const co::ObjectVersion& frameDataVersion,
+                               const uint128_t& nodeID,
+                               const co::NodeID& netNodeID,
+                               const std::vector< uint64_t >& imageIndices,
+                               const uint32_t frameNumber,
+                               const uint32_t taskID )
 {
     LBLOG( LOG_TASKS|LOG_ASSEMBLY ) << "Transmit" << std::endl;
     FrameDataPtr frameData = getNode()->getFrameData( frameDataVersion );
@@ -1330,17 +1712,6 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
                                      frameNumber );
     transmitEvent.event.data.statistic.task = taskID;
 
-    const Images& images = frameData->getImages();
-    Image* image = images[ imageIndex ];
-    LBASSERT( images.size() > imageIndex );
-
-    if( image->getStorageType() == Frame::TYPE_TEXTURE )
-    {
-        LBWARN << "Can't transmit image of type TEXTURE" << std::endl;
-        LBUNIMPLEMENTED;
-        return;
-    }
-
     co::LocalNodePtr localNode = getLocalNode();
     co::NodePtr toNode = localNode->connect( netNodeID );
     if( !toNode || !toNode->isReachable( ))
@@ -1353,67 +1724,54 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
     co::ConnectionPtr connection = toNode->getConnection();
     co::ConstConnectionDescriptionPtr description =connection->getDescription();
 
-    // use compression on links up to 2 GBit/s
-    const bool useCompression = ( description->bandwidth <= 262144 );
-
-    std::vector< const PixelData* > pixelDatas;
-    std::vector< float > qualities;
-
-    uint32_t commandBuffers = Frame::BUFFER_NONE;
-    uint64_t imageDataSize = 0;
+    // use compression on links up to 2 GBit/s, adaptive compression decides
+    // per frame in _asyncTransmit
+    uint32_t compressBuffers = Frame::BUFFER_NONE;
+    if( description->bandwidth <= 262144 )
+        compressBuffers = Frame::BUFFER_COLOR | Frame::BUFFER_DEPTH;
+    else
     {
-        uint64_t rawSize( 0 );
-        ChannelStatistics compressEvent( Statistic::CHANNEL_FRAME_COMPRESS,
-                                         this, frameNumber,
-                                         useCompression ? AUTO : OFF );
-        compressEvent.event.data.statistic.task = taskID;
-        compressEvent.event.data.statistic.ratio = 1.0f;
-        compressEvent.event.data.statistic.plugins[0] = EQ_COMPRESSOR_NONE;
-        compressEvent.event.data.statistic.plugins[1] = EQ_COMPRESSOR_NONE;
-
-        // Prepare image pixel data
-        Frame::Buffer buffers[] = {Frame::BUFFER_COLOR,Frame::BUFFER_DEPTH};
-
-        // for each image attachment
-        for( unsigned j = 0; j < 2; ++j )
+        if( frameData->getCompressor( Frame::BUFFER_COLOR ) ==
+            EQ_COMPRESSOR_ADAPTIVE )
         {
-            Frame::Buffer buffer = buffers[j];
-            if( image->hasPixelData( buffer ))
-            {
-                // format, type, nChunks, compressor name
-                imageDataSize += sizeof( FrameData::ImageHeader );
+            compressBuffers |= Frame::BUFFER_COLOR;
+        }
+        if( frameData->getCompressor( Frame::BUFFER_DEPTH ) ==
+            EQ_COMPRESSOR_ADAPTIVE )
+        {
+            compressBuffers |= Frame::BUFFER_DEPTH;
+        }
+    }
 
-                const PixelData& data = useCompression ?
-                    image->compressPixelData( buffer ) :
-                    image->getPixelData( buffer );
-                pixelDatas.push_back( &data );
-                qualities.push_back( image->getQuality( buffer ));
+    const Images& images = frameData->getImages();
+    std::vector< TransmitData > transmits;
+    transmits.reserve( imageIndices.size( ));
 
-                if( data.compressedData.isCompressed( ))
-                {
-                    imageDataSize += data.compressedData.getSize() +
-                        data.compressedData.chunks.size() * sizeof( uint64_t );
-                    compressEvent.event.data.statistic.plugins[j] =
-                        data.compressedData.compressor;
-                }
-                else
-                    imageDataSize += sizeof( uint64_t ) +
-                                     image->getPixelDataSize( buffer );
+    BOOST_FOREACH( const uint64_t imageIndex, imageIndices )
+    {
+        LBASSERT( images.size() > imageIndex );
+        Image* image = images[ imageIndex ];
 
-                commandBuffers |= buffer;
-                rawSize += image->getPixelDataSize( buffer );
-            }
+        if( image->getStorageType() == Frame::TYPE_TEXTURE )
+        {
+            LBWARN << "Can't transmit image of type TEXTURE" << std::endl;
+            LBUNIMPLEMENTED;
+            continue;
         }
 
-        if( rawSize > 0 )
-            compressEvent.event.data.statistic.ratio =
-                float( imageDataSize ) / float( rawSize );
+        LBASSERT( image->getPixelViewport().isValid( ));
+        TransmitData transmit( image );
+        if( _prepareTransmit( this, transmit, frameNumber, taskID,
+                              compressBuffers ))
+        {
+            transmits.push_back( transmit );
+        }
     }
 
-    if( pixelDatas.empty( ))
+    if( transmits.empty( ))
         return;
 
-    // send image pixel data command
+    // send image pixel data command(s)
     co::LocalNode::SendToken token;
     if( getIAttribute( IATTR_HINT_SENDTOKEN ) == ON )
     {
@@ -1422,69 +1780,69 @@ void Channel::_transmitImage( const co::ObjectVersion& frameDataVersion,
         waitEvent.event.data.statistic.task = taskID;
         token = getLocalNode()->acquireSendToken( toNode );
     }
-    LBASSERT( image->getPixelViewport().isValid( ));
 
-    co::ObjectOCommand command( co::Connections( 1, connection ),
-                                fabric::CMD_NODE_FRAMEDATA_TRANSMIT,
-                                co::COMMANDTYPE_OBJECT, nodeID,
-                                CO_INSTANCE_ALL );
-    command << frameDataVersion << image->getPixelViewport() << image->getZoom()
-            << image->getContext() << commandBuffers << frameNumber
-            << image->getAlphaUsage();
-    command.sendHeader( imageDataSize );
+    const bool batch = transmits.size() > 1 &&
+                       getIAttribute( IATTR_HINT_BATCH_TRANSMIT ) == ON;
+    TransmitBuffer buffer( connection, batch );
+    const lunchbox::Clock clock;
 
-#ifndef NDEBUG
-    size_t sentBytes = 0;
-#endif
-
-    for( uint32_t j=0; j < pixelDatas.size(); ++j )
+    if( batch )
     {
-#ifndef NDEBUG
-        sentBytes += sizeof( FrameData::ImageHeader );
-#endif
-        const PixelData* data = pixelDatas[j];
-        const bool isCompressed = data->compressedData.isCompressed();
-        const uint32_t nChunks = isCompressed ?
-            uint32_t( data->compressedData.chunks.size( )) : 1;
-
-        const FrameData::ImageHeader header =
-              { data->internalFormat, data->externalFormat,
-                data->pixelSize, data->pvp,
-                isCompressed ? data->compressedData.compressor :
-                               EQ_COMPRESSOR_NONE,
-                data->compressorFlags, nChunks, qualities[ j ] };
-
-        connection->send( &header, sizeof( header ), true );
-
-        if( isCompressed )
+        FrameData::ImageInfos infos;
+        infos.reserve( transmits.size( ));
+        uint64_t imageDataSize = 0;
+        BOOST_FOREACH( const TransmitData& transmit, transmits )
         {
-            BOOST_FOREACH( const pression::CompressorChunk& chunk,
-                           data->compressedData.chunks )
-            {
-                const uint64_t dataSize = chunk.getNumBytes();
-
-                connection->send( &dataSize, sizeof( dataSize ), true );
-                if( dataSize > 0 )
-                    connection->send( chunk.data, dataSize, true );
-#ifndef NDEBUG
-                sentBytes += sizeof( dataSize ) + dataSize;
-#endif
-            }
+            const Image* image = transmit.image;
+            const FrameData::ImageInfo info =
+                { image->getPixelViewport(), image->getZoom(),
+                  image->getContext(), transmit.buffers,
+                  image->getAlphaUsage() ? 1u : 0u };
+            infos.push_back( info );
+            imageDataSize += transmit.size;
         }
-        else
+
+        co::ObjectOCommand command( co::Connections( 1, connection ),
+                                    fabric::CMD_NODE_FRAMEDATA_TRANSMIT_BATCH,
+                                    co::COMMANDTYPE_OBJECT, nodeID,
+                                    CO_INSTANCE_ALL );
+        command << frameDataVersion << frameNumber << infos;
+        buffer.sendHeader( command, imageDataSize );
+
+        BOOST_FOREACH( const TransmitData& transmit, transmits )
+            _sendPixelData( transmit, buffer );
+        buffer.flush(); // before command unlocks the connection
+        LBASSERTINFO( buffer.getNumBytes() == imageDataSize,
+                      buffer.getNumBytes() << " != " << imageDataSize );
+    }
+    else
+    {
+        BOOST_FOREACH( const TransmitData& transmit, transmits )
         {
-            const uint64_t dataSize = data->pvp.getArea() * data->pixelSize;
-            connection->send( &dataSize, sizeof( dataSize ), true );
-            connection->send( data->pixels, dataSize, true );
-#ifndef NDEBUG
-            sentBytes += sizeof( dataSize ) + dataSize;
-#endif
+            const Image* image = transmit.image;
+            co::ObjectOCommand command( co::Connections( 1, connection ),
+                                        fabric::CMD_NODE_FRAMEDATA_TRANSMIT,
+                                        co::COMMANDTYPE_OBJECT, nodeID,
+                                        CO_INSTANCE_ALL );
+            command << frameDataVersion << image->getPixelViewport()
+                    << image->getZoom() << image->getContext()
+                    << transmit.buffers << frameNumber
+                    << image->getAlphaUsage();
+            buffer.sendHeader( command, transmit.size );
+
+            const uint64_t sentBytes = buffer.getNumBytes();
+            _sendPixelData( transmit, buffer );
+            LBASSERTINFO( buffer.getNumBytes() - sentBytes == transmit.size,
+                          buffer.getNumBytes() - sentBytes << " != "
+                          << transmit.size );
         }
     }
-#ifndef NDEBUG
-    LBASSERTINFO( sentBytes == imageDataSize,
-        sentBytes << " != " << imageDataSize );
-#endif
+
+    detail::CompressorSelector::getInstance().addTransmit(
+        netNodeID, buffer.getNumBytes(), clock.getTimef(),
+        float( description->bandwidth ) * 1.024f ); // KB/s to bytes/ms
+    transmitEvent.event.data.statistic.plugins[0] = uint32_t( transmits.size());
+    transmitEvent.event.data.statistic.plugins[1] = buffer.getNumSends();
 }
 
 void Channel::_setReady( const bool async, detail::RBStat* stat,
@@ -1528,10 +1886,17 @@ void Channel::_setReady( FrameDataPtr frame, detail::RBStat* stat,
     frame->setReady();
 
     const uint32_t frameNumber = stat->event.event.data.statistic.frameNumber;
-    _refFrame( frameNumber );
 
-    send( getLocalNode(), fabric::CMD_CHANNEL_FRAME_SET_READY_NODE )
-            << co::ObjectVersion( frame ) << nodes << netNodes << frameNumber;
+    // one command per receiver, ordered after the receiver's image transmits
+    LBASSERT( nodes.size() == netNodes.size( ));
+    co::NodeIDs::const_iterator j = netNodes.begin();
+    for( std::vector< uint128_t >::const_iterator i = nodes.begin();
+         i != nodes.end(); ++i, ++j )
+    {
+        _refFrame( frameNumber );
+        send( getLocalNode(), fabric::CMD_CHANNEL_FRAME_SET_READY_NODE )
+                << co::ObjectVersion( frame ) << *i << *j << frameNumber;
+    }
 
     const DrawableConfig& dc = getDrawableConfig();
     const size_t colorBytes = ( 3 * dc.colorBits + dc.alphaBits ) / 8;
@@ -1656,7 +2021,7 @@ bool Channel::_cmdFrameStart( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
 
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readContext( command );
     const uint128_t& version = command.read< uint128_t >();
     const uint32_t frameNumber = command.read< uint32_t >();
 
@@ -1685,7 +2050,7 @@ bool Channel::_cmdFrameFinish( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
 
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readContext( command );
     const uint32_t frameNumber = command.read< uint32_t >();
 
     LBLOG( LOG_TASKS ) << "TASK frame finish " << getName() <<  " " << command
@@ -1704,7 +2069,7 @@ bool Channel::_cmdFrameClear( co::ICommand& cmd )
     LBASSERT( _impl->state == STATE_RUNNING );
 
     co::ObjectICommand command( cmd );
-    RenderContext context  = command.read< RenderContext >();
+    RenderContext context  = _impl->readContext( command );
 
     LBLOG( LOG_TASKS ) << "TASK clear " << getName() <<  " " << command
                        << " " << context << std::endl;
@@ -1722,7 +2087,7 @@ bool Channel::_cmdFrameClear( co::ICommand& cmd )
 bool Channel::_cmdFrameDraw( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context  = command.read< RenderContext >();
+    RenderContext context  = _impl->readContext( command );
     const bool finish = command.read< bool >();
 
     LBLOG( LOG_TASKS ) << "TASK draw " << getName() <<  " " << command
@@ -1766,7 +2131,7 @@ bool Channel::_cmdFrameDrawFinish( co::ICommand& cmd )
 bool Channel::_cmdFrameAssemble( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readContext( command );
     const co::ObjectVersions& frameIDs = command.read< co::ObjectVersions >();
 
     LBLOG( LOG_TASKS | LOG_ASSEMBLY )
@@ -1786,7 +2151,7 @@ bool Channel::_cmdFrameAssemble( co::ICommand& cmd )
 bool Channel::_cmdFrameReadback( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readContext( command );
     const co::ObjectVersions& frames = command.read< co::ObjectVersions >();
     LBLOG( LOG_TASKS | LOG_ASSEMBLY ) << "TASK readback " << getName() <<  " "
                                       << command << " " << context<< " nFrames "
@@ -1847,7 +2212,8 @@ bool Channel::_cmdFrameTransmitImage( co::ICommand& cmd )
     const co::ObjectVersion& frameData = command.read< co::ObjectVersion >();
     const uint128_t& nodeID = command.read< uint128_t >();
     const co::NodeID& netNodeID = command.read< co::NodeID >();
-    const uint64_t imageIndex = command.read< uint64_t >();
+    const std::vector< uint64_t >& images =
+        command.read< std::vector< uint64_t > >();
     const uint32_t frameNumber = command.read< uint32_t >();
     const uint32_t taskID = command.read< uint32_t >();
 
@@ -1855,8 +2221,8 @@ bool Channel::_cmdFrameTransmitImage( co::ICommand& cmd )
                                     << frameData << " receiver " << nodeID
                                     << " on " << netNodeID << std::endl;
 
-    _transmitImage( frameData, nodeID, netNodeID, imageIndex, frameNumber,
-                    taskID );
+    _transmitImages( frameData, nodeID, netNodeID, images, frameNumber,
+                     taskID );
     _unrefFrame( frameNumber );
     return true;
 }
@@ -1867,31 +2233,26 @@ bool Channel::_cmdFrameSetReadyNode( co::ICommand& cmd )
 
     const co::ObjectVersion& frameDataVersion =
             command.read< co::ObjectVersion >();
-    const std::vector< uint128_t >& nodes =
-            command.read< std::vector< uint128_t > >();
-    const co::NodeIDs& netNodes = command.read< co::NodeIDs >();
+    const uint128_t& nodeID = command.read< uint128_t >();
+    const co::NodeID& netNodeID = command.read< co::NodeID >();
     const uint32_t frameNumber = command.read< uint32_t >();
 
     co::LocalNodePtr localNode = getLocalNode();
     const FrameDataPtr frameData = getNode()->getFrameData( frameDataVersion );
 
-    co::NodeIDs::const_iterator j = netNodes.begin();
-    for( std::vector< uint128_t >::const_iterator i = nodes.begin();
-         i != nodes.end(); ++i, ++j )
+    co::NodePtr toNode = localNode->connect( netNodeID );
+    if( toNode )
     {
-        co::NodePtr toNode = localNode->connect( *j );
-        if( !toNode )
-        {
-            LBERROR << "Can't connect to " << *j << " to signal ready of frame "
-                    << frameNumber << std::endl;
-            continue;
-        }
         co::ObjectOCommand os( co::Connections( 1, toNode->getConnection( )),
-                            fabric::CMD_NODE_FRAMEDATA_READY,
-                               co::COMMANDTYPE_OBJECT, *i, CO_INSTANCE_ALL );
+                               fabric::CMD_NODE_FRAMEDATA_READY,
+                               co::COMMANDTYPE_OBJECT, nodeID,
+                               CO_INSTANCE_ALL );
         os << frameDataVersion;
         frameData->serialize( os );
     }
+    else
+        LBERROR << "Can't connect to " << netNodeID
+                << " to signal ready of frame " << frameNumber << std::endl;
 
     _unrefFrame( frameNumber );
     return true;
@@ -1900,7 +2261,7 @@ bool Channel::_cmdFrameSetReadyNode( co::ICommand& cmd )
 bool Channel::_cmdFrameViewStart( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readContext( command );
 
     LBLOG( LOG_TASKS ) << "TASK view start " << getName() <<  " " << command
                        << " " << context << std::endl;
@@ -1915,7 +2276,7 @@ bool Channel::_cmdFrameViewStart( co::ICommand& cmd )
 bool Channel::_cmdFrameViewFinish( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readContext( command );
 
     LBLOG( LOG_TASKS ) << "TASK view finish " << getName() <<  " " << command
                        << " " << context << std::endl;
@@ -1944,7 +2305,7 @@ bool Channel::_cmdStopFrame( co::ICommand& cmd )
 bool Channel::_cmdFrameTiles( co::ICommand& cmd )
 {
     co::ObjectICommand command( cmd );
-    RenderContext context = command.read< RenderContext >();
+    RenderContext context = _impl->readContext( command );
     const bool isLocal = command.read< bool >();
     const uint128_t& queueID = command.read< uint128_t >();
     const uint32_t tasks = command.read< uint32_t >();
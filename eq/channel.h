@@ -636,13 +636,13 @@ private:
     /** Check for and send frame finish reply. */
     void _unrefFrame( const uint32_t frameNumber );
 
-    /** Transmit one image of a frame to one node. */
-    void _transmitImage( const co::ObjectVersion& frameDataVersion,
-                         const uint128_t& nodeID,
-                         const co::NodeID& netNodeID,
-                         const uint64_t imageIndex,
-                         const uint32_t frameNumber,
-                         const uint32_t taskID );
+    /** Transmit images of a frame to one node, batched if requested. */
+    void _transmitImages( const co::ObjectVersion& frameDataVersion,
+                          const uint128_t& nodeID,
+                          const co::NodeID& netNodeID,
+                          const std::vector< uint64_t >& imageIndices,
+                          const uint32_t frameNumber,
+                          const uint32_t taskID );
 
     void _frameReadback( const uint128_t& frameID,
                          const co::ObjectVersions& frames );
@@ -657,7 +657,7 @@ private:
                                const Frames& frames );
 
     void _asyncTransmit( FrameDataPtr frame, const uint32_t frameNumber,
-                         const uint64_t image,
+                         const std::vector< uint64_t >& images,
                          const std::vector< uint128_t >& nodes,
                          const co::NodeIDs& netNodes,
                          const uint32_t taskID );
@@ -672,9 +672,6 @@ private:
                     const std::vector< uint128_t >& nodes,
                     const co::NodeIDs& netNodes );
 
-    /** Getsthe channel's current input queue. */
-    co::QueueSlave* _getQueue( const uint128_t& queueID );
-
     Frames _getFrames( const co::ObjectVersions& frameIDs,
                        const bool isOutput );
 
@@ -34,6 +34,7 @@
 #include "server.h"
 #include "window.h"
 #include "windowSystem.h"
+#include "detail/compositorKernels.h"
 
 #include <eq/util/accum.h>
 #include <eq/util/objectManager.h>
@@ -45,6 +46,8 @@
 #include <lunchbox/os.h>
 #include <pression/plugins/compressor.h>
 
+#include <algorithm>
+
 using lunchbox::Monitor;
 
 namespace eq
@@ -62,6 +65,7 @@ static const char* depthDBKey  = shaderDBKey + 2;
 
 // Image used for CPU-based assembly
 static lunchbox::PerThread< Image > _resultImage;
+static Compositor::MergeMode _mergeMode = Compositor::MERGE_TILED;
 
 struct CPUAssemblyFormat
 {
@@ -110,6 +114,10 @@ bool _useCPUAssembly( const Image* image, CPUAssemblyFormat& format )
 
     case EQ_COMPRESSOR_DATATYPE_RGBA:
     case EQ_COMPRESSOR_DATATYPE_BGRA:
+    case EQ_COMPRESSOR_DATATYPE_RGBA16F:
+    case EQ_COMPRESSOR_DATATYPE_BGRA16F:
+    case EQ_COMPRESSOR_DATATYPE_RGBA32F:
+    case EQ_COMPRESSOR_DATATYPE_BGRA32F:
         break;
 
     default:
@@ -269,6 +277,85 @@ bool _collectOutputData( const ImageOps& ops, PixelViewport& destPVP,
     return destPVP.hasArea();
 }
 
+/** Depth-merge one row of RGBA, RGBA16F or RGBA32F pixels. */
+void _mergeDepthRow( const detail::CompositorKernels& kernels,
+                     uint8_t* destColor, uint32_t* destDepth,
+                     const uint8_t* color, const uint32_t* depth,
+                     const size_t pixelSize, const size_t n )
+{
+    if( pixelSize == 4 )
+    {
+        kernels.mergeDepth( reinterpret_cast< uint32_t* >( destColor ),
+                            destDepth,
+                            reinterpret_cast< const uint32_t* >( color ),
+                            depth, n );
+        return;
+    }
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        if( destDepth[i] > depth[i] )
+        {
+            ::memcpy( destColor + i * pixelSize, color + i * pixelSize,
+                      pixelSize );
+            destDepth[i] = depth[i];
+        }
+    }
+}
+
+/** Blend one row of premultiplied float pixels, see _blendImage. */
+void _blendRow( float* dest, const float* source, const size_t n )
+{
+    for( size_t i = 0; i < n * 4; i += 4 )
+    {
+        const float alpha = source[i+3];
+        dest[i]   = source[i]   + alpha * dest[i];
+        dest[i+1] = source[i+1] + alpha * dest[i+1];
+        dest[i+2] = source[i+2] + alpha * dest[i+2];
+        dest[i+3] =               alpha * dest[i+3];
+    }
+}
+
+/** Blend one row of RGBA, RGBA16F or RGBA32F pixels. */
+void _blendRow( const detail::CompositorKernels& kernels, uint8_t* dest,
+                const uint8_t* source, const size_t pixelSize, const size_t n )
+{
+    switch( pixelSize )
+    {
+    case 4:
+        kernels.blend( dest, source, n );
+        return;
+
+    case 8:
+    {
+        // convert chunks of 256 pixels, which stay in L1 for the blending
+        const size_t chunk = 256;
+        float src[ chunk * 4 ];
+        float dst[ chunk * 4 ];
+        const uint16_t* halfSrc = reinterpret_cast< const uint16_t* >( source );
+        uint16_t* halfDst = reinterpret_cast< uint16_t* >( dest );
+
+        for( size_t i = 0; i < n; i += chunk )
+        {
+            const size_t size = std::min( chunk, n - i );
+            kernels.halfToFloat( src, halfSrc + i * 4, size * 4 );
+            kernels.halfToFloat( dst, halfDst + i * 4, size * 4 );
+            _blendRow( dst, src, size );
+            kernels.floatToHalf( halfDst + i * 4, dst, size * 4 );
+        }
+        return;
+    }
+
+    case 16:
+        _blendRow( reinterpret_cast< float* >( dest ),
+                   reinterpret_cast< const float* >( source ), n );
+        return;
+
+    default:
+        LBUNIMPLEMENTED;
+    }
+}
+
 void _mergeDBImage( void* destColor, void* destDepth,
                     const PixelViewport& destPVP, const Image* image,
                     const Vector2i& offset )
@@ -277,7 +364,7 @@ void _mergeDBImage( void* destColor, void* destDepth,
 
     LBVERB << "CPU-DB assembly" << std::endl;
 
-    uint32_t* destC = reinterpret_cast< uint32_t* >( destColor );
+    uint8_t* destC = reinterpret_cast< uint8_t* >( destColor );
     uint32_t* destD = reinterpret_cast< uint32_t* >( destDepth );
 
     const PixelViewport&  pvp    = image->getPixelViewport();
@@ -285,33 +372,20 @@ void _mergeDBImage( void* destColor, void* destDepth,
     const int32_t         destX  = offset.x() + pvp.x - destPVP.x;
     const int32_t         destY  = offset.y() + pvp.y - destPVP.y;
 
-    const uint32_t* color = reinterpret_cast< const uint32_t* >
-        ( image->getPixelPointer( Frame::BUFFER_COLOR ));
+    const uint8_t* color = image->getPixelPointer( Frame::BUFFER_COLOR );
     const uint32_t* depth = reinterpret_cast< const uint32_t* >
         ( image->getPixelPointer( Frame::BUFFER_DEPTH ));
+    const size_t pixelSize = image->getPixelSize( Frame::BUFFER_COLOR );
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
 
 #pragma omp parallel for
     for( int32_t y = 0; y < pvp.h; ++y )
     {
-        const uint32_t skip =  (destY + y) * destPVP.w + destX;
-        uint32_t* destColorIt = destC + skip;
-        uint32_t* destDepthIt = destD + skip;
-        const uint32_t* colorIt = color + y * pvp.w;
-        const uint32_t* depthIt = depth + y * pvp.w;
-
-        for( int32_t x = 0; x < pvp.w; ++x )
-        {
-            if( *destDepthIt > *depthIt )
-            {
-                *destColorIt = *colorIt;
-                *destDepthIt = *depthIt;
-            }
-
-            ++destColorIt;
-            ++destDepthIt;
-            ++colorIt;
-            ++depthIt;
-        }
+        const size_t skip = size_t( destY + y ) * destPVP.w + destX;
+        const size_t src = size_t( y ) * pvp.w;
+        _mergeDepthRow( kernels, destC + skip * pixelSize, destD + skip,
+                        color + src * pixelSize, depth + src, pixelSize,
+                        pvp.w );
     }
 }
 
@@ -334,12 +408,13 @@ void _merge2DImage( void* destColor, void* destDepth,
     const uint8_t*   color = image->getPixelPointer( Frame::BUFFER_COLOR );
     const size_t pixelSize = image->getPixelSize( Frame::BUFFER_COLOR );
     const size_t rowLength = pvp.w * pixelSize;
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
 
 #pragma omp parallel for
     for( int32_t y = 0; y < pvp.h; ++y )
     {
         const size_t skip = ( (destY + y) * destPVP.w + destX ) * pixelSize;
-        memcpy( destC + skip, color + y * pvp.w * pixelSize, rowLength);
+        kernels.copy( destC + skip, color + y * pvp.w * pixelSize, rowLength );
         // clear depth, for depth-assembly into existing FB
         if( destD )
             lunchbox::setZero( destD + skip, rowLength );
@@ -351,18 +426,17 @@ void _blendImage( void* dest, const eq::PixelViewport& destPVP,
 {
     LBVERB << "CPU-Blend assembly" << std::endl;
 
-    int32_t* destColor = reinterpret_cast< int32_t* >( dest );
+    uint8_t* destColor = reinterpret_cast< uint8_t* >( dest );
 
     const PixelViewport&  pvp    = image->getPixelViewport();
     const int32_t         destX  = offset.x() + pvp.x - destPVP.x;
     const int32_t         destY  = offset.y() + pvp.y - destPVP.y;
 
-    LBASSERT( image->getPixelSize( Frame::BUFFER_COLOR ) == 4 );
     LBASSERT( image->hasPixelData( Frame::BUFFER_COLOR ));
     LBASSERT( image->hasAlpha( ));
 
-    const int32_t* color = reinterpret_cast< const int32_t* >
-                               ( image->getPixelPointer( Frame::BUFFER_COLOR ));
+    const uint8_t* color = image->getPixelPointer( Frame::BUFFER_COLOR );
+    const size_t pixelSize = image->getPixelSize( Frame::BUFFER_COLOR );
 
     // Blending of two slices, none of which is on final image (i.e. result
     // could be blended on to something else) should be performed with:
@@ -373,49 +447,295 @@ void _blendImage( void* dest, const eq::PixelViewport& destPVP,
     // because we accumulate light which is go through (= 1-Alpha) and we
     // already have colors as Alpha*Color
 
-    int32_t* destColorStart = destColor + destY*destPVP.w + destX;
-    const uint32_t step = sizeof( int32_t );
+    uint8_t* destColorStart =
+        destColor + ( size_t( destY ) * destPVP.w + destX ) * pixelSize;
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
 
 #pragma omp parallel for
     for( int32_t y = 0; y < pvp.h; ++y )
     {
-        const unsigned char* src =
-            reinterpret_cast< const uint8_t* >( color + pvp.w * y );
-        unsigned char*       dst =
-            reinterpret_cast< uint8_t* >( destColorStart + destPVP.w * y );
+        const uint8_t* src = color + size_t( pvp.w ) * y * pixelSize;
+        uint8_t* dst = destColorStart + size_t( destPVP.w ) * y * pixelSize;
+        _blendRow( kernels, dst, src, pixelSize, pvp.w );
+    }
+}
 
-        for( int32_t x = 0; x < pvp.w; ++x )
-        {
-            dst[0] = LB_MIN( src[0] + (src[3]*dst[0] >> 8), 255 );
-            dst[1] = LB_MIN( src[1] + (src[3]*dst[1] >> 8), 255 );
-            dst[2] = LB_MIN( src[2] + (src[3]*dst[2] >> 8), 255 );
-            dst[3] =                   src[3]*dst[3] >> 8;
+enum MergeType
+{
+    MERGE_NONE,
+    MERGE_DB,
+    MERGE_BLEND,
+    MERGE_2D
+};
 
-            src += step;
-            dst += step;
-        }
-    }
+MergeType _getMergeType( const ImageOp& op, const bool blend )
+{
+    if( !op.image->hasPixelData( Frame::BUFFER_COLOR ))
+        return MERGE_NONE;
+    if( op.image->hasPixelData( Frame::BUFFER_DEPTH ))
+        return MERGE_DB;
+    if( blend && op.image->hasAlpha( ))
+        return MERGE_BLEND;
+    return MERGE_2D;
 }
 
-void _mergeImages( const ImageOps& ops, const bool blend, void* colorBuffer,
-                   void* depthBuffer, const PixelViewport& destPVP )
+void _mergeImagesSequential( const ImageOps& ops, const bool blend,
+                             void* colorBuffer, void* depthBuffer,
+                             const PixelViewport& destPVP )
 {
     for( const ImageOp& op : ops )
     {
-        if( !op.image->hasPixelData( Frame::BUFFER_COLOR ))
-            continue;
-
-        if( op.image->hasPixelData( Frame::BUFFER_DEPTH ))
+        switch( _getMergeType( op, blend ))
+        {
+        case MERGE_DB:
             _mergeDBImage( colorBuffer, depthBuffer, destPVP, op.image,
                            op.offset );
-        else if( blend && op.image->hasAlpha( ))
+            break;
+        case MERGE_BLEND:
             _blendImage( colorBuffer, destPVP, op.image, op.offset );
-        else
+            break;
+        case MERGE_2D:
             _merge2DImage( colorBuffer, depthBuffer, destPVP, op.image,
                            op.offset );
+            break;
+        case MERGE_NONE:
+            break;
+        }
     }
 }
 
+// Destination tile of 64k pixels, i.e., 512KB color and depth data, which
+// keeps the destination in L2 while all input images are folded into it.
+const int32_t _tileWidth = 256;
+const int32_t _tileHeight = 64;
+
+/**
+ * Merge the part of the image of the given operation which lies within the
+ * region, given relative to destPVP, using the calling thread only.
+ */
+void _mergeRegion( const ImageOp& op, const MergeType type, void* colorBuffer,
+                   void* depthBuffer, const PixelViewport& destPVP,
+                   const PixelViewport& region )
+{
+    const Image* image = op.image;
+    const PixelViewport& pvp = image->getPixelViewport();
+    const int32_t destX = op.offset.x() + pvp.x - destPVP.x;
+    const int32_t destY = op.offset.y() + pvp.y - destPVP.y;
+
+    const int32_t startX = std::max( destX, region.x );
+    const int32_t startY = std::max( destY, region.y );
+    const int32_t endX = std::min( destX + pvp.w, region.getXEnd( ));
+    const int32_t endY = std::min( destY + pvp.h, region.getYEnd( ));
+    if( startX >= endX || startY >= endY )
+        return;
+
+    const size_t width = endX - startX;
+    const size_t srcX = startX - destX;
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
+
+    switch( type )
+    {
+    case MERGE_DB:
+    {
+        uint8_t* destC = reinterpret_cast< uint8_t* >( colorBuffer );
+        uint32_t* destD = reinterpret_cast< uint32_t* >( depthBuffer );
+        const uint8_t* color = image->getPixelPointer( Frame::BUFFER_COLOR );
+        const uint32_t* depth = reinterpret_cast< const uint32_t* >
+            ( image->getPixelPointer( Frame::BUFFER_DEPTH ));
+        const size_t pixelSize = image->getPixelSize( Frame::BUFFER_COLOR );
+
+        for( int32_t y = startY; y < endY; ++y )
+        {
+            const size_t skip = size_t( y ) * destPVP.w + startX;
+            const size_t src = size_t( y - destY ) * pvp.w + srcX;
+            _mergeDepthRow( kernels, destC + skip * pixelSize, destD + skip,
+                            color + src * pixelSize, depth + src, pixelSize,
+                            width );
+        }
+        return;
+    }
+
+    case MERGE_BLEND:
+    {
+        uint8_t* dest = reinterpret_cast< uint8_t* >( colorBuffer );
+        const uint8_t* color = image->getPixelPointer( Frame::BUFFER_COLOR );
+        const size_t pixelSize = image->getPixelSize( Frame::BUFFER_COLOR );
+
+        for( int32_t y = startY; y < endY; ++y )
+        {
+            const size_t skip = ( size_t( y ) * destPVP.w + startX ) *
+                                pixelSize;
+            const size_t src = ( size_t( y - destY ) * pvp.w + srcX ) *
+                               pixelSize;
+            _blendRow( kernels, dest + skip, color + src, pixelSize, width );
+        }
+        return;
+    }
+
+    case MERGE_2D:
+    {
+        uint8_t* destC = reinterpret_cast< uint8_t* >( colorBuffer );
+        uint8_t* destD = reinterpret_cast< uint8_t* >( depthBuffer );
+        const uint8_t* color = image->getPixelPointer( Frame::BUFFER_COLOR );
+        const size_t pixelSize = image->getPixelSize( Frame::BUFFER_COLOR );
+        const size_t rowLength = width * pixelSize;
+
+        for( int32_t y = startY; y < endY; ++y )
+        {
+            const size_t skip = ( size_t( y ) * destPVP.w + startX ) *
+                                pixelSize;
+            const size_t src = ( size_t( y - destY ) * pvp.w + srcX ) *
+                               pixelSize;
+            kernels.copy( destC + skip, color + src, rowLength );
+            // clear depth, for depth-assembly into existing FB
+            if( destD )
+                lunchbox::setZero( destD + skip, rowLength );
+        }
+        return;
+    }
+
+    case MERGE_NONE:
+        return;
+    }
+}
+
+void _mergeImagesTiled( const ImageOps& ops, const bool blend,
+                        void* colorBuffer, void* depthBuffer,
+                        const PixelViewport& destPVP )
+{
+    LBVERB << "CPU tiled assembly" << std::endl;
+
+    std::vector< MergeType > types;
+    types.reserve( ops.size( ));
+    for( const ImageOp& op : ops )
+        types.push_back( _getMergeType( op, blend ));
+
+    const int32_t nTilesX = ( destPVP.w + _tileWidth - 1 ) / _tileWidth;
+    const int32_t nTilesY = ( destPVP.h + _tileHeight - 1 ) / _tileHeight;
+    const int32_t nTiles = nTilesX * nTilesY;
+
+#pragma omp parallel for schedule( dynamic )
+    for( int32_t i = 0; i < nTiles; ++i )
+    {
+        const int32_t x = ( i % nTilesX ) * _tileWidth;
+        const int32_t y = ( i / nTilesX ) * _tileHeight;
+        const PixelViewport tile( x, y, std::min( _tileWidth, destPVP.w - x ),
+                                  std::min( _tileHeight, destPVP.h - y ));
+
+        for( size_t j = 0; j < ops.size(); ++j )
+            _mergeRegion( ops[j], types[j], colorBuffer, depthBuffer, destPVP,
+                          tile );
+    }
+}
+
+/**
+ * Merge depth images in a binary reduction tree.
+ *
+ * The first level merges image pairs into separate buffers, and all further
+ * levels merge these buffers pairwise until the result is in the destination
+ * buffer. On equal depth the earlier image wins, as in the sequential merge,
+ * which makes the result identical.
+ */
+void _mergeImagesTree( const ImageOps& ops, void* colorBuffer,
+                       void* depthBuffer, const PixelViewport& destPVP )
+{
+    LBVERB << "CPU tree assembly" << std::endl;
+
+    ImageOps inputs;
+    for( const ImageOp& op : ops )
+        if( _getMergeType( op, false ) == MERGE_DB )
+            inputs.push_back( op );
+
+    const size_t nBuffers = ( inputs.size() + 1 ) / 2;
+    const size_t nPixels = destPVP.getArea();
+
+    // buffer 0 is the destination, others start with the cleared destination.
+    // The intermediate buffers are freed after the merge, since they are
+    // frame-sized and would be held by each compositing thread otherwise.
+    std::vector< uint32_t > colorData( ( nBuffers - 1 ) * nPixels );
+    std::vector< uint32_t > depthData( ( nBuffers - 1 ) * nPixels );
+
+    std::vector< uint32_t* > colors( 1, static_cast< uint32_t* >(colorBuffer));
+    std::vector< uint32_t* > depths( 1, static_cast< uint32_t* >(depthBuffer));
+    for( size_t i = 1; i < nBuffers; ++i )
+    {
+        colors.push_back( colorData.data() + ( i - 1 ) * nPixels );
+        depths.push_back( depthData.data() + ( i - 1 ) * nPixels );
+        ::memcpy( colors.back(), colorBuffer, nPixels * sizeof( uint32_t ));
+        ::memcpy( depths.back(), depthBuffer, nPixels * sizeof( uint32_t ));
+    }
+
+    const int32_t nBands = ( destPVP.h + _tileHeight - 1 ) / _tileHeight;
+#pragma omp parallel for schedule( dynamic )
+    for( int32_t i = 0; i < nBands; ++i )
+    {
+        const int32_t y = i * _tileHeight;
+        const PixelViewport band( 0, y, destPVP.w,
+                                  std::min( _tileHeight, destPVP.h - y ));
+
+        for( size_t j = 0; j < inputs.size(); ++j )
+            _mergeRegion( inputs[j], MERGE_DB, colors[ j / 2 ], depths[ j / 2 ],
+                          destPVP, band );
+    }
+
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
+    for( size_t stride = 1; stride < nBuffers; stride *= 2 )
+    {
+#pragma omp parallel for schedule( dynamic )
+        for( int32_t i = 0; i < nBands; ++i )
+        {
+            const size_t start = size_t( i ) * _tileHeight * destPVP.w;
+            const size_t size = std::min( size_t( _tileHeight ) * destPVP.w,
+                                          nPixels - start );
+
+            for( size_t j = 0; j + stride < nBuffers; j += 2 * stride )
+                kernels.mergeDepth( colors[j] + start, depths[j] + start,
+                                    colors[ j + stride ] + start,
+                                    depths[ j + stride ] + start, size );
+        }
+    }
+}
+
+bool _canMergeTree( const ImageOps& ops, const bool blend,
+                    const void* depthBuffer )
+{
+    if( !depthBuffer )
+        return false;
+
+    size_t nImages = 0;
+    for( const ImageOp& op : ops )
+    {
+        switch( _getMergeType( op, blend ))
+        {
+        case MERGE_DB:
+            if( op.image->getPixelSize( Frame::BUFFER_COLOR ) != 4 )
+                return false;
+            ++nImages;
+            break;
+        case MERGE_NONE:
+            break;
+        default:
+            return false; // order-dependent 2D or blend ops
+        }
+    }
+    return nImages > 2;
+}
+
+void _mergeImages( const ImageOps& ops, const bool blend, void* colorBuffer,
+                   void* depthBuffer, const PixelViewport& destPVP )
+{
+    const Compositor::MergeMode mode = Compositor::getMergeMode();
+    if( mode == Compositor::MERGE_TREE &&
+        _canMergeTree( ops, blend, depthBuffer ))
+    {
+        _mergeImagesTree( ops, colorBuffer, depthBuffer, destPVP );
+    }
+    else if( mode != Compositor::MERGE_SEQUENTIAL && ops.size() > 1 )
+        _mergeImagesTiled( ops, blend, colorBuffer, depthBuffer, destPVP );
+    else
+        _mergeImagesSequential( ops, blend, colorBuffer, depthBuffer, destPVP );
+}
+
 Vector4f _getCoords( const ImageOp& op, const PixelViewport& pvp )
 {
     const Pixel& pixel = op.image->getContext().pixel;
@@ -839,6 +1159,26 @@ ImageOps Compositor::extractOneSubPixel( ImageOps& ops )
     return current;
 }
 
+bool Compositor::setSIMD( const SIMD simd )
+{
+    return detail::setCompositorKernels( simd );
+}
+
+Compositor::SIMD Compositor::getSIMD()
+{
+    return detail::getCompositorSIMD();
+}
+
+void Compositor::setMergeMode( const MergeMode mode )
+{
+    _mergeMode = mode;
+}
+
+Compositor::MergeMode Compositor::getMergeMode()
+{
+    return _mergeMode;
+}
+
 uint32_t Compositor::assembleFramesUnsorted( const Frames& frames,
                                              Channel* channel,
                                              util::Accum* accum )
@@ -231,6 +231,59 @@ public:
     static bool isSubPixelDecomposition( const ImageOps& ops );
     static Frames extractOneSubPixel( Frames& frames );
     static ImageOps extractOneSubPixel( ImageOps& ops );
+
+    /** The instruction sets used by the CPU compositing kernels. */
+    enum SIMD
+    {
+        SIMD_AUTO,   //!< Best instruction set supported by the CPU
+        SIMD_NONE,   //!< Scalar implementation
+        SIMD_SSE41,  //!< SSE 4.1
+        SIMD_AVX2,   //!< AVX2
+        SIMD_AVX512  //!< AVX-512 F and BW
+    };
+
+    /**
+     * Set the instruction set used by the CPU compositing kernels.
+     *
+     * The default is the best instruction set supported by the CPU, or the
+     * scalar implementation if the environment variable EQ_COMPOSITOR_NO_SIMD
+     * is set. Not thread-safe with a concurrent mergeImagesCPU().
+     *
+     * @return false if the instruction set is not supported by the CPU.
+     * @version 1.13
+     */
+    static bool setSIMD( SIMD simd );
+
+    /** @return the active CPU compositing instruction set. @version 1.13 */
+    static SIMD getSIMD();
+
+    /** The traversal of the input images by the CPU compositor. */
+    enum MergeMode
+    {
+        /** Merge each input image into the full destination in turn. */
+        MERGE_SEQUENTIAL,
+        /**
+         * Merge all input images into one cache-sized destination tile at a
+         * time, streaming the destination through memory only once.
+         */
+        MERGE_TILED,
+        /**
+         * Merge depth images pairwise in a parallel reduction tree. Falls back
+         * to MERGE_TILED for 2D, blended or less than three inputs.
+         */
+        MERGE_TREE
+    };
+
+    /**
+     * Set the image traversal used by mergeImagesCPU().
+     *
+     * All modes produce the same result. The default is MERGE_TILED.
+     * @version 1.13
+     */
+    static void setMergeMode( MergeMode mode );
+
+    /** @return the image traversal used by mergeImagesCPU(). @version 1.13 */
+    static MergeMode getMergeMode();
     //@}
 
 private:
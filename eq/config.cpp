@@ -48,14 +48,12 @@
 #include <lunchbox/monitor.h>
 #include <lunchbox/scopedMutex.h>
 #include <lunchbox/spinLock.h>
-#include <pression/plugins/compressor.h>
 
-#ifdef EQUALIZER_USE_GLSTATS
-#  include <GLStats/GLStats.h>
-#else
+#ifndef EQUALIZER_USE_GLSTATS
     namespace GLStats { class Data {} _fakeStats; }
 #endif
 
+#include "detail/statisticsAggregator.h"
 #include "exitVisitor.h"
 #include "frameVisitor.h"
 #include "initVisitor.h"
@@ -89,17 +87,6 @@ private:
     const ChangeType _changeType;
     const uint32_t _compressor;
 };
-#ifdef EQUALIZER_USE_GLSTATS
-namespace
-{
-enum
-{
-    THREAD_MAIN,
-    THREAD_ASYNC1,
-    THREAD_ASYNC2,
-};
-}
-#endif
 }
 
 namespace detail
@@ -135,10 +122,8 @@ public:
     /** The connections configured by the server for this config. */
     co::Connections connections;
 
-#ifdef EQUALIZER_USE_GLSTATS
-    /** Global statistics data. */
-    lunchbox::Lockable< GLStats::Data, lunchbox::SpinLock > statistics;
-#endif
+    /** Global statistics data and trace, written by a background thread. */
+    StatisticsAggregator statistics;
 
     /** The last started frame. */
     uint32_t currentFrame;
@@ -386,9 +371,7 @@ bool Config::update()
 
     const bool result = request.wait();
     client->enableSendOnRegister();
-#ifdef EQUALIZER_USE_GLSTATS
-    _impl->statistics->clear();
-#endif
+    _impl->statistics.clear();
     handleEvents();
     return result;
 }
@@ -695,6 +678,15 @@ bool Config::_handleNewEvent( EventICommand& command )
         break;
     }
 
+    case Event::STATISTIC:
+    {
+        const uint32_t serial = command.read< uint32_t >();
+        const Statistic& statistic = command.read< Statistic >();
+        LBLOG( LOG_STATS ) << statistic << std::endl;
+        addStatistic( serial, statistic );
+        return false;
+    }
+
     case Event::NODE_ERROR:
     case Event::PIPE_ERROR:
     case Event::WINDOW_ERROR:
@@ -763,142 +755,9 @@ bool Config::_handleEvent( const Event& event )
     return false;
 }
 
-void Config::addStatistic( const uint32_t originator LB_UNUSED,
-                           const Statistic& stat LB_UNUSED )
+void Config::addStatistic( const uint32_t originator, const Statistic& stat )
 {
-#ifdef EQUALIZER_USE_GLSTATS
-    const uint32_t frame = stat.frameNumber;
-    LBASSERT( stat.type != Statistic::NONE );
-
-     // Not a frame-related stat event OR no event-type set
-    if( frame == 0 || stat.type == Statistic::NONE )
-        return;
-
-    lunchbox::ScopedFastWrite mutex( _impl->statistics );
-    GLStats::Item item;
-    item.entity = originator;
-    item.type = stat.type;
-    item.frame = stat.frameNumber;
-    item.start = stat.startTime;
-    item.end = stat.endTime;
-
-    GLStats::Entity entity;
-    entity.name = stat.resourceName;
-
-    GLStats::Type type;
-    const Vector3f& color = Statistic::getColor( stat.type );
-
-    type.color[0] = color[0];
-    type.color[1] = color[1];
-    type.color[2] = color[2];
-    type.name = Statistic::getName( stat.type );
-
-    switch( stat.type )
-    {
-      case Statistic::CHANNEL_FRAME_COMPRESS:
-      case Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN:
-          type.subgroup = "transmit";
-          item.thread = THREAD_ASYNC2;
-          // no break;
-      case Statistic::CHANNEL_FRAME_WAIT_READY:
-          type.group = "channel";
-          item.layer = 1;
-          break;
-      case Statistic::CHANNEL_CLEAR:
-      case Statistic::CHANNEL_DRAW:
-      case Statistic::CHANNEL_DRAW_FINISH:
-      case Statistic::CHANNEL_ASSEMBLE:
-      case Statistic::CHANNEL_READBACK:
-      case Statistic::CHANNEL_VIEW_FINISH:
-          type.group = "channel";
-          break;
-      case Statistic::CHANNEL_ASYNC_READBACK:
-          type.group = "channel";
-          type.subgroup = "transfer";
-          item.thread = THREAD_ASYNC1;
-          break;
-      case Statistic::CHANNEL_FRAME_TRANSMIT:
-          type.group = "channel";
-          type.subgroup = "transmit";
-          item.thread = THREAD_ASYNC2;
-          break;
-
-      case Statistic::WINDOW_FINISH:
-      case Statistic::WINDOW_THROTTLE_FRAMERATE:
-      case Statistic::WINDOW_SWAP_BARRIER:
-      case Statistic::WINDOW_SWAP:
-          type.group = "window";
-          break;
-      case Statistic::NODE_FRAME_DECOMPRESS:
-          type.group = "node";
-          break;
-
-      case Statistic::CONFIG_WAIT_FINISH_FRAME:
-          item.layer = 1;
-          // no break;
-      case Statistic::CONFIG_START_FRAME:
-      case Statistic::CONFIG_FINISH_FRAME:
-          type.group = "config";
-          break;
-
-      case Statistic::PIPE_IDLE:
-      {
-          const std::string& string = _impl->statistics->getText();
-          const float idle = stat.idleTime * 100ll / stat.totalTime;
-          std::stringstream text;
-          if( string.empty( ))
-              text <<  "Idle: " << stat.resourceName << ' ' << idle << "%";
-          else
-          {
-              const size_t pos = string.find( stat.resourceName );
-
-              if( pos == std::string::npos ) // append new pipe
-                  text << string << ", " << stat.resourceName << ' '
-                       << idle << "%";
-              else // replace existing text
-              {
-                  const std::string& left = string.substr( pos + 1 );
-
-                  text << string.substr( 0, pos ) << stat.resourceName << ' '
-                       << idle << left.substr( left.find( '%' ));
-              }
-          }
-          _impl->statistics->setText( text.str( ));
-      }
-      // no break;
-
-      case Statistic::WINDOW_FPS:
-      case Statistic::NONE:
-      case Statistic::ALL:
-          return;
-    }
-    switch( stat.type )
-    {
-      case Statistic::CHANNEL_FRAME_COMPRESS:
-      case Statistic::CHANNEL_ASYNC_READBACK:
-      case Statistic::CHANNEL_READBACK:
-      {
-          std::stringstream text;
-          text << unsigned( 100.f * stat.ratio ) << '%';
-
-          if( stat.plugins[ 0 ] > EQ_COMPRESSOR_NONE )
-              text << " 0x" << std::hex << stat.plugins[0] << std::dec;
-          if( stat.plugins[ 1 ] > EQ_COMPRESSOR_NONE &&
-              stat.plugins[ 0 ] != stat.plugins[ 1 ] )
-          {
-              text << " 0x" << std::hex << stat.plugins[1] << std::dec;
-          }
-          item.text = text.str();
-          break;
-      }
-      default:
-          break;
-    }
-
-    _impl->statistics->setType( stat.type, type );
-    _impl->statistics->setEntity( originator, entity );
-    _impl->statistics->addItem( item );
-#endif
+    _impl->statistics.add( originator, stat );
 }
 
 bool Config::_needsLocalSync() const
@@ -933,18 +792,14 @@ bool Config::_needsLocalSync() const
 
 void Config::_updateStatistics()
 {
-#ifdef EQUALIZER_USE_GLSTATS
     // keep statistics for three frames
-    lunchbox::ScopedFastWrite mutex( _impl->statistics );
-    _impl->statistics->obsolete( 2 /* frames to keep */ );
-#endif
+    _impl->statistics.obsolete( 2 /* frames to keep */ );
 }
 
 GLStats::Data Config::getStatistics() const
 {
 #ifdef EQUALIZER_USE_GLSTATS
-    lunchbox::ScopedFastRead mutex( _impl->statistics );
-    return _impl->statistics.data;
+    return _impl->statistics.getData();
 #else
     return GLStats::_fakeStats;
 #endif
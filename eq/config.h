@@ -455,6 +455,11 @@ public:
     /**
      * Add an statistic event to the statistics overlay. Thread safe.
      *
+     * The statistic is queued without locking and added to the statistics
+     * data, and to the trace file named by the environment variable
+     * EQ_TRACE_FILE, by a background thread, at the latest when the frame is
+     * finished.
+     *
      * @param originator the originator serial id.
      * @param stat the statistic event.
      * @warning experimental, may not be supported in the future
@@ -20,6 +20,7 @@
 #include "../channel.h"
 #include "../image.h"
 #include "../resultImageListener.h"
+#include "../roiFinder.h"
 #include "fileFrameWriter.h"
 
 #include <boost/foreach.hpp>
@@ -84,7 +85,10 @@ public:
     void frameViewFinish( eq::Channel& channel )
     {
         if( channel.getSAttribute( channel.SATTR_DUMP_IMAGE ).empty( ))
+        {
             removeResultImageListener( &frameWriter );
+            frameWriter.flush();
+        }
         else
         {
             ResultImageListeners::iterator i =
@@ -172,6 +176,19 @@ public:
     /** Dumps images when the channel is configured to do so */
     FileFrameWriter frameWriter;
 
+    /** Trims output images, reusing the areas of the last frame. */
+    lunchbox::Lockable< ROIFinder > roiFinder;
+
+    /** The render context of the last task, updated by each task command. */
+    RenderContext lastContext;
+
+    /** @return the delta-encoded render context of a task command. */
+    const RenderContext& readContext( co::DataIStream& is )
+    {
+        lastContext.deserializeDelta( is );
+        return lastContext;
+    }
+
     bool _updateFrameBuffer;
 };
 
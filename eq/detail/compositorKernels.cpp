@@ -0,0 +1,659 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "compositorKernels.h"
+
+#include <lunchbox/debug.h>
+#include <lunchbox/os.h>
+
+#include <cstdlib>
+#include <cstring>
+
+// The SIMD kernels are compiled using per-function target attributes, so that
+// the library itself does not need to be compiled for a specific CPU.
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ))
+#  define EQ_COMPOSITOR_X86
+#  include <cpuid.h>
+#  include <immintrin.h>
+#  define EQ_TARGET( isa ) __attribute__(( target( isa )))
+#endif
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+// Scalar
+void _mergeDepth( uint32_t* destColor, uint32_t* destDepth,
+                  const uint32_t* color, const uint32_t* depth,
+                  const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+    {
+        if( destDepth[i] > depth[i] )
+        {
+            destColor[i] = color[i];
+            destDepth[i] = depth[i];
+        }
+    }
+}
+
+void _copy( uint8_t* dest, const uint8_t* source, const size_t nBytes )
+{
+    ::memcpy( dest, source, nBytes );
+}
+
+void _blend( uint8_t* dest, const uint8_t* source, const size_t n )
+{
+    // dstColor = 1*srcColor + srcAlpha*dstColor
+    // dstAlpha = 0*srcAlpha + srcAlpha*dstAlpha
+    for( size_t i = 0; i < n; ++i )
+    {
+        const uint8_t* src = source + i * 4;
+        uint8_t* dst = dest + i * 4;
+
+        dst[0] = LB_MIN( src[0] + (src[3]*dst[0] >> 8), 255 );
+        dst[1] = LB_MIN( src[1] + (src[3]*dst[1] >> 8), 255 );
+        dst[2] = LB_MIN( src[2] + (src[3]*dst[2] >> 8), 255 );
+        dst[3] =                   src[3]*dst[3] >> 8;
+    }
+}
+
+void _markOccupied( uint8_t* blocks, const uint32_t* pixels,
+                    const uint32_t background, const uint32_t bits,
+                    const size_t n )
+{
+    for( size_t i = 0; i < n; i += 16 )
+    {
+        if( blocks[ i / 16 ] != 0 )
+            continue;
+
+        const size_t end = LB_MIN( i + 16, n );
+        uint32_t occupied = 0;
+        for( size_t j = i; j < end; ++j )
+            occupied |= ( pixels[j] ^ background ) & bits;
+        if( occupied != 0 )
+            blocks[ i / 16 ] = 255;
+    }
+}
+
+// Conversions round to nearest even and quiet NaNs, like the F16C instructions
+uint16_t _floatToHalf( const float value )
+{
+    uint32_t f;
+    ::memcpy( &f, &value, 4 );
+    const uint16_t sign = uint16_t(( f >> 16 ) & 0x8000 );
+    const uint32_t a = f & 0x7fffffff;
+
+    if( a >= 0x7f800000 ) // infinity or NaN
+        return sign | 0x7c00 |
+               ( a > 0x7f800000 ? 0x0200 | (( a >> 13 ) & 0x03ff ) : 0 );
+    if( a >= 0x477ff000 ) // rounds to infinity
+        return sign | 0x7c00;
+
+    if( a >= 0x38800000 ) // normal, rebias exponent from 127 to 15
+    {
+        const uint32_t h = ( a - 0x38000000 ) >> 13;
+        const uint32_t rest = a & 0x1fff;
+        return sign | uint16_t( h + ( rest > 0x1000 ||
+                                      ( rest == 0x1000 && ( h & 1 ))));
+    }
+
+    // denormal or zero
+    const uint32_t shift = 126 - ( a >> 23 );
+    if( shift > 24 )
+        return sign;
+    const uint32_t m = ( a & 0x007fffff ) | 0x00800000;
+    const uint32_t h = m >> shift;
+    const uint32_t rest = m & (( 1u << shift ) - 1 );
+    const uint32_t half = 1u << ( shift - 1 );
+    return sign | uint16_t( h + ( rest > half || ( rest == half && ( h & 1 ))));
+}
+
+float _halfToFloat( const uint16_t h )
+{
+    const uint32_t sign = uint32_t( h & 0x8000 ) << 16;
+    const uint32_t e = ( h >> 10 ) & 0x1f;
+    uint32_t m = h & 0x03ff;
+    uint32_t f;
+
+    if( e == 0x1f ) // infinity or NaN
+        f = sign | 0x7f800000 | ( m << 13 ) | ( m ? 0x00400000 : 0 );
+    else if( e != 0 ) // normal, rebias exponent from 15 to 127
+        f = sign | (( e + 112 ) << 23 ) | ( m << 13 );
+    else if( m == 0 )
+        f = sign;
+    else // denormal, normalize
+    {
+        uint32_t exponent = 113;
+        while( !( m & 0x0400 ))
+        {
+            m <<= 1;
+            --exponent;
+        }
+        f = sign | ( exponent << 23 ) | (( m & 0x03ff ) << 13 );
+    }
+
+    float value;
+    ::memcpy( &value, &f, 4 );
+    return value;
+}
+
+void _halfToFloats( float* dest, const uint16_t* source, const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+        dest[i] = _halfToFloat( source[i] );
+}
+
+void _floatsToHalf( uint16_t* dest, const float* source, const size_t n )
+{
+    for( size_t i = 0; i < n; ++i )
+        dest[i] = _floatToHalf( source[i] );
+}
+
+#ifdef EQ_COMPOSITOR_X86
+// SSE 4.1
+EQ_TARGET( "sse4.1" )
+void _mergeDepthSSE41( uint32_t* destColor, uint32_t* destDepth,
+                       const uint32_t* color, const uint32_t* depth,
+                       const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        __m128i* dc = reinterpret_cast< __m128i* >( destColor + i );
+        __m128i* dd = reinterpret_cast< __m128i* >( destDepth + i );
+        const __m128i c = _mm_loadu_si128(
+                              reinterpret_cast< const __m128i* >( color + i ));
+        const __m128i d = _mm_loadu_si128(
+                              reinterpret_cast< const __m128i* >( depth + i ));
+        const __m128i oldColor = _mm_loadu_si128( dc );
+        const __m128i oldDepth = _mm_loadu_si128( dd );
+
+        // keep dest where max( depth, destDepth ) == depth, i.e., on ties
+        const __m128i keep = _mm_cmpeq_epi32( _mm_max_epu32( d, oldDepth ), d );
+        _mm_storeu_si128( dc, _mm_blendv_epi8( c, oldColor, keep ));
+        _mm_storeu_si128( dd, _mm_min_epu32( d, oldDepth ));
+    }
+    _mergeDepth( destColor + i, destDepth + i, color + i, depth + i, n - i );
+}
+
+EQ_TARGET( "sse4.1" )
+void _copySSE41( uint8_t* dest, const uint8_t* source, const size_t nBytes )
+{
+    size_t i = 0;
+    for( ; i + 64 <= nBytes; i += 64 )
+    {
+        const __m128i* src = reinterpret_cast< const __m128i* >( source + i );
+        __m128i* dst = reinterpret_cast< __m128i* >( dest + i );
+        const __m128i a = _mm_loadu_si128( src );
+        const __m128i b = _mm_loadu_si128( src + 1 );
+        const __m128i c = _mm_loadu_si128( src + 2 );
+        const __m128i d = _mm_loadu_si128( src + 3 );
+        _mm_storeu_si128( dst, a );
+        _mm_storeu_si128( dst + 1, b );
+        _mm_storeu_si128( dst + 2, c );
+        _mm_storeu_si128( dst + 3, d );
+    }
+    _copy( dest + i, source + i, nBytes - i );
+}
+
+EQ_TARGET( "sse4.1" )
+__m128i _blendSSE41( const __m128i dst, const __m128i src )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha = _mm_setr_epi8( 3, 3, 3, 3, 7, 7, 7, 7,
+                                         11, 11, 11, 11, 15, 15, 15, 15 );
+    const __m128i colorMask = _mm_setr_epi16( -1, -1, -1, 0, -1, -1, -1, 0 );
+
+    const __m128i a = _mm_shuffle_epi8( src, alpha );
+    const __m128i lo = _mm_add_epi16(
+        _mm_and_si128( _mm_unpacklo_epi8( src, zero ), colorMask ),
+        _mm_srli_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( a, zero ),
+                                         _mm_unpacklo_epi8( dst, zero )), 8 ));
+    const __m128i hi = _mm_add_epi16(
+        _mm_and_si128( _mm_unpackhi_epi8( src, zero ), colorMask ),
+        _mm_srli_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( a, zero ),
+                                         _mm_unpackhi_epi8( dst, zero )), 8 ));
+    return _mm_packus_epi16( lo, hi ); // saturates to 255
+}
+
+EQ_TARGET( "sse4.1" )
+void _blendSSE41( uint8_t* dest, const uint8_t* source, const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        __m128i* dst = reinterpret_cast< __m128i* >( dest + i * 4 );
+        const __m128i src = _mm_loadu_si128(
+                            reinterpret_cast< const __m128i* >( source + i*4 ));
+        _mm_storeu_si128( dst, _blendSSE41( _mm_loadu_si128( dst ), src ));
+    }
+    _blend( dest + i * 4, source + i * 4, n - i );
+}
+
+EQ_TARGET( "sse4.1" )
+void _markOccupiedSSE41( uint8_t* blocks, const uint32_t* pixels,
+                         const uint32_t background, const uint32_t bits,
+                         const size_t n )
+{
+    const __m128i bg = _mm_set1_epi32( int( background ));
+    const __m128i mask = _mm_set1_epi32( int( bits ));
+    size_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        if( blocks[ i / 16 ] != 0 )
+            continue;
+
+        const __m128i* src = reinterpret_cast< const __m128i* >( pixels + i );
+        const __m128i a = _mm_or_si128(
+            _mm_xor_si128( _mm_loadu_si128( src ), bg ),
+            _mm_xor_si128( _mm_loadu_si128( src + 1 ), bg ));
+        const __m128i b = _mm_or_si128(
+            _mm_xor_si128( _mm_loadu_si128( src + 2 ), bg ),
+            _mm_xor_si128( _mm_loadu_si128( src + 3 ), bg ));
+        if( !_mm_testz_si128( _mm_or_si128( a, b ), mask ))
+            blocks[ i / 16 ] = 255;
+    }
+    _markOccupied( blocks + i / 16, pixels + i, background, bits, n - i );
+}
+
+// AVX2
+EQ_TARGET( "avx2" )
+void _mergeDepthAVX2( uint32_t* destColor, uint32_t* destDepth,
+                      const uint32_t* color, const uint32_t* depth,
+                      const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        __m256i* dc = reinterpret_cast< __m256i* >( destColor + i );
+        __m256i* dd = reinterpret_cast< __m256i* >( destDepth + i );
+        const __m256i c = _mm256_loadu_si256(
+                              reinterpret_cast< const __m256i* >( color + i ));
+        const __m256i d = _mm256_loadu_si256(
+                              reinterpret_cast< const __m256i* >( depth + i ));
+        const __m256i oldColor = _mm256_loadu_si256( dc );
+        const __m256i oldDepth = _mm256_loadu_si256( dd );
+
+        const __m256i keep = _mm256_cmpeq_epi32(
+                                 _mm256_max_epu32( d, oldDepth ), d );
+        _mm256_storeu_si256( dc, _mm256_blendv_epi8( c, oldColor, keep ));
+        _mm256_storeu_si256( dd, _mm256_min_epu32( d, oldDepth ));
+    }
+    _mergeDepthSSE41( destColor + i, destDepth + i, color + i, depth + i,
+                      n - i );
+}
+
+EQ_TARGET( "avx2" )
+void _copyAVX2( uint8_t* dest, const uint8_t* source, const size_t nBytes )
+{
+    size_t i = 0;
+    for( ; i + 128 <= nBytes; i += 128 )
+    {
+        const __m256i* src = reinterpret_cast< const __m256i* >( source + i );
+        __m256i* dst = reinterpret_cast< __m256i* >( dest + i );
+        const __m256i a = _mm256_loadu_si256( src );
+        const __m256i b = _mm256_loadu_si256( src + 1 );
+        const __m256i c = _mm256_loadu_si256( src + 2 );
+        const __m256i d = _mm256_loadu_si256( src + 3 );
+        _mm256_storeu_si256( dst, a );
+        _mm256_storeu_si256( dst + 1, b );
+        _mm256_storeu_si256( dst + 2, c );
+        _mm256_storeu_si256( dst + 3, d );
+    }
+    _copySSE41( dest + i, source + i, nBytes - i );
+}
+
+EQ_TARGET( "avx2" )
+void _blendAVX2( uint8_t* dest, const uint8_t* source, const size_t n )
+{
+    // unpack, shuffle and pack work per 128 bit lane, which preserves order
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alpha = _mm256_setr_epi8( 3, 3, 3, 3, 7, 7, 7, 7,
+                                            11, 11, 11, 11, 15, 15, 15, 15,
+                                            3, 3, 3, 3, 7, 7, 7, 7,
+                                            11, 11, 11, 11, 15, 15, 15, 15 );
+    const __m256i colorMask = _mm256_setr_epi16( -1, -1, -1, 0, -1, -1, -1, 0,
+                                                 -1, -1, -1, 0, -1, -1, -1, 0 );
+    size_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        __m256i* dstPtr = reinterpret_cast< __m256i* >( dest + i * 4 );
+        const __m256i src = _mm256_loadu_si256(
+                            reinterpret_cast< const __m256i* >( source + i*4 ));
+        const __m256i dst = _mm256_loadu_si256( dstPtr );
+        const __m256i a = _mm256_shuffle_epi8( src, alpha );
+
+        const __m256i lo = _mm256_add_epi16(
+            _mm256_and_si256( _mm256_unpacklo_epi8( src, zero ), colorMask ),
+            _mm256_srli_epi16(
+                _mm256_mullo_epi16( _mm256_unpacklo_epi8( a, zero ),
+                                    _mm256_unpacklo_epi8( dst, zero )), 8 ));
+        const __m256i hi = _mm256_add_epi16(
+            _mm256_and_si256( _mm256_unpackhi_epi8( src, zero ), colorMask ),
+            _mm256_srli_epi16(
+                _mm256_mullo_epi16( _mm256_unpackhi_epi8( a, zero ),
+                                    _mm256_unpackhi_epi8( dst, zero )), 8 ));
+        _mm256_storeu_si256( dstPtr, _mm256_packus_epi16( lo, hi ));
+    }
+    _blendSSE41( dest + i * 4, source + i * 4, n - i );
+}
+
+EQ_TARGET( "avx2" )
+void _markOccupiedAVX2( uint8_t* blocks, const uint32_t* pixels,
+                        const uint32_t background, const uint32_t bits,
+                        const size_t n )
+{
+    const __m256i bg = _mm256_set1_epi32( int( background ));
+    const __m256i mask = _mm256_set1_epi32( int( bits ));
+    size_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        if( blocks[ i / 16 ] != 0 )
+            continue;
+
+        const __m256i* src = reinterpret_cast< const __m256i* >( pixels + i );
+        const __m256i p = _mm256_or_si256(
+            _mm256_xor_si256( _mm256_loadu_si256( src ), bg ),
+            _mm256_xor_si256( _mm256_loadu_si256( src + 1 ), bg ));
+        if( !_mm256_testz_si256( p, mask ))
+            blocks[ i / 16 ] = 255;
+    }
+    // scalar tail avoids an AVX to SSE transition penalty
+    _markOccupied( blocks + i / 16, pixels + i, background, bits, n - i );
+}
+
+// F16C is available on all CPUs with AVX2
+EQ_TARGET( "avx2,f16c" )
+void _halfToFloatsAVX2( float* dest, const uint16_t* source, const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        const __m128i h =
+            _mm_loadu_si128( reinterpret_cast< const __m128i* >( source + i ));
+        _mm256_storeu_ps( dest + i, _mm256_cvtph_ps( h ));
+    }
+    _mm256_zeroupper();
+    _halfToFloats( dest + i, source + i, n - i );
+}
+
+EQ_TARGET( "avx2,f16c" )
+void _floatsToHalfAVX2( uint16_t* dest, const float* source, const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        const __m128i h = _mm256_cvtps_ph( _mm256_loadu_ps( source + i ),
+                                           _MM_FROUND_TO_NEAREST_INT );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( dest + i ), h );
+    }
+    _mm256_zeroupper();
+    _floatsToHalf( dest + i, source + i, n - i );
+}
+
+// AVX-512 (F + BW)
+EQ_TARGET( "avx512f,avx512bw" )
+void _mergeDepthAVX512( uint32_t* destColor, uint32_t* destDepth,
+                        const uint32_t* color, const uint32_t* depth,
+                        const size_t n )
+{
+    for( size_t i = 0; i < n; i += 16 )
+    {
+        const size_t left = n - i;
+        const __mmask16 valid = left >= 16 ? __mmask16( 0xffff ) :
+                                         __mmask16(( 1u << left ) - 1 );
+        const __m512i d = _mm512_maskz_loadu_epi32( valid, depth + i );
+        const __m512i oldDepth = _mm512_maskz_loadu_epi32( valid,
+                                                           destDepth + i );
+        const __mmask16 nearer = _mm512_mask_cmpgt_epu32_mask( valid,
+                                                               oldDepth, d );
+        const __m512i c = _mm512_maskz_loadu_epi32( nearer, color + i );
+
+        _mm512_mask_storeu_epi32( destColor + i, nearer, c );
+        _mm512_mask_storeu_epi32( destDepth + i, nearer, d );
+    }
+}
+
+EQ_TARGET( "avx512f,avx512bw" )
+void _copyAVX512( uint8_t* dest, const uint8_t* source, const size_t nBytes )
+{
+    size_t i = 0;
+    for( ; i + 256 <= nBytes; i += 256 )
+    {
+        const uint8_t* src = source + i;
+        uint8_t* dst = dest + i;
+        const __m512i a = _mm512_loadu_si512( src );
+        const __m512i b = _mm512_loadu_si512( src + 64 );
+        const __m512i c = _mm512_loadu_si512( src + 128 );
+        const __m512i d = _mm512_loadu_si512( src + 192 );
+        _mm512_storeu_si512( dst, a );
+        _mm512_storeu_si512( dst + 64, b );
+        _mm512_storeu_si512( dst + 128, c );
+        _mm512_storeu_si512( dst + 192, d );
+    }
+    for( ; i < nBytes; i += 64 )
+    {
+        const size_t left = nBytes - i;
+        const __mmask64 valid = left >= 64 ? ~__mmask64( 0 ) :
+                                         ( __mmask64( 1 ) << left ) - 1;
+        _mm512_mask_storeu_epi8( dest + i, valid,
+                                 _mm512_maskz_loadu_epi8( valid, source + i ));
+    }
+}
+
+EQ_TARGET( "avx512f,avx512bw" )
+void _blendAVX512( uint8_t* dest, const uint8_t* source, const size_t n )
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i alpha = _mm512_set4_epi32( 0x0f0f0f0f, 0x0b0b0b0b,
+                                             0x07070707, 0x03030303 );
+    const __m512i colorMask = _mm512_set1_epi64( 0x0000ffffffffffffll );
+
+    for( size_t i = 0; i < n; i += 16 )
+    {
+        const size_t left = n - i;
+        const __mmask16 valid = left >= 16 ? __mmask16( 0xffff ) :
+                                         __mmask16(( 1u << left ) - 1 );
+        uint8_t* dstPtr = dest + i * 4;
+        const __m512i src = _mm512_maskz_loadu_epi32( valid, source + i*4 );
+        const __m512i dst = _mm512_maskz_loadu_epi32( valid, dstPtr );
+        const __m512i a = _mm512_shuffle_epi8( src, alpha );
+
+        const __m512i lo = _mm512_add_epi16(
+            _mm512_and_si512( _mm512_unpacklo_epi8( src, zero ), colorMask ),
+            _mm512_srli_epi16(
+                _mm512_mullo_epi16( _mm512_unpacklo_epi8( a, zero ),
+                                    _mm512_unpacklo_epi8( dst, zero )), 8 ));
+        const __m512i hi = _mm512_add_epi16(
+            _mm512_and_si512( _mm512_unpackhi_epi8( src, zero ), colorMask ),
+            _mm512_srli_epi16(
+                _mm512_mullo_epi16( _mm512_unpackhi_epi8( a, zero ),
+                                    _mm512_unpackhi_epi8( dst, zero )), 8 ));
+        _mm512_mask_storeu_epi32( dstPtr, valid,
+                                  _mm512_packus_epi16( lo, hi ));
+    }
+}
+
+EQ_TARGET( "avx512f,avx512bw" )
+void _markOccupiedAVX512( uint8_t* blocks, const uint32_t* pixels,
+                          const uint32_t background, const uint32_t bits,
+                          const size_t n )
+{
+    const __m512i bg = _mm512_set1_epi32( int( background ));
+    const __m512i mask = _mm512_set1_epi32( int( bits ));
+    for( size_t i = 0; i < n; i += 16 )
+    {
+        if( blocks[ i / 16 ] != 0 )
+            continue;
+
+        const size_t left = n - i;
+        const __mmask16 valid = left >= 16 ? __mmask16( 0xffff ) :
+                                         __mmask16(( 1u << left ) - 1 );
+        const __m512i p = _mm512_maskz_loadu_epi32( valid, pixels + i );
+        if( _mm512_mask_test_epi32_mask( valid, _mm512_xor_si512( p, bg ),
+                                         mask ))
+        {
+            blocks[ i / 16 ] = 255;
+        }
+    }
+}
+
+EQ_TARGET( "avx512f,avx512bw" )
+void _halfToFloatsAVX512( float* dest, const uint16_t* source, const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        const __m256i h = _mm256_loadu_si256(
+            reinterpret_cast< const __m256i* >( source + i ));
+        _mm512_storeu_ps( dest + i, _mm512_cvtph_ps( h ));
+    }
+    _mm256_zeroupper();
+    _halfToFloats( dest + i, source + i, n - i );
+}
+
+EQ_TARGET( "avx512f,avx512bw" )
+void _floatsToHalfAVX512( uint16_t* dest, const float* source, const size_t n )
+{
+    size_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        const __m256i h = _mm512_cvtps_ph( _mm512_loadu_ps( source + i ),
+                                           _MM_FROUND_TO_NEAREST_INT );
+        _mm256_storeu_si256( reinterpret_cast< __m256i* >( dest + i ), h );
+    }
+    _mm256_zeroupper();
+    _floatsToHalf( dest + i, source + i, n - i );
+}
+#endif
+
+// SSE 4.1 has no half float conversion, it uses the scalar code
+const CompositorKernels _scalarKernels = { _mergeDepth, _copy, _blend,
+                                           _markOccupied, _halfToFloats,
+                                           _floatsToHalf };
+#ifdef EQ_COMPOSITOR_X86
+const CompositorKernels _sse41Kernels = { _mergeDepthSSE41, _copySSE41,
+                                          _blendSSE41, _markOccupiedSSE41,
+                                          _halfToFloats, _floatsToHalf };
+const CompositorKernels _avx2Kernels = { _mergeDepthAVX2, _copyAVX2,
+                                         _blendAVX2, _markOccupiedAVX2,
+                                         _halfToFloatsAVX2,
+                                         _floatsToHalfAVX2 };
+const CompositorKernels _avx512Kernels = { _mergeDepthAVX512, _copyAVX512,
+                                           _blendAVX512, _markOccupiedAVX512,
+                                           _halfToFloatsAVX512,
+                                           _floatsToHalfAVX512 };
+#endif
+
+Compositor::SIMD _detectSIMD()
+{
+    if( ::getenv( "EQ_COMPOSITOR_NO_SIMD" ))
+        return Compositor::SIMD_NONE;
+
+    for( int simd = Compositor::SIMD_AVX512; simd > Compositor::SIMD_NONE;
+         --simd )
+    {
+        if( isSupported( Compositor::SIMD( simd )))
+            return Compositor::SIMD( simd );
+    }
+    return Compositor::SIMD_NONE;
+}
+
+Compositor::SIMD _simd = _detectSIMD();
+const CompositorKernels* _kernels = getCompositorKernels( _simd );
+}
+
+bool isSupported( const Compositor::SIMD simd )
+{
+#ifdef EQ_COMPOSITOR_X86
+    __builtin_cpu_init(); // may be called before static constructors
+#endif
+    switch( simd )
+    {
+    case Compositor::SIMD_AUTO:
+    case Compositor::SIMD_NONE:
+        return true;
+#ifdef EQ_COMPOSITOR_X86
+    case Compositor::SIMD_SSE41:
+        return __builtin_cpu_supports( "sse4.1" );
+    case Compositor::SIMD_AVX2:
+    {
+        unsigned eax, ebx, ecx, edx;
+        return __builtin_cpu_supports( "avx2" ) &&
+               __get_cpuid( 1, &eax, &ebx, &ecx, &edx ) && ( ecx & bit_F16C );
+    }
+    case Compositor::SIMD_AVX512:
+        return __builtin_cpu_supports( "avx512f" ) &&
+               __builtin_cpu_supports( "avx512bw" );
+#endif
+    default:
+        return false;
+    }
+}
+
+const CompositorKernels* getCompositorKernels( const Compositor::SIMD simd )
+{
+    if( !isSupported( simd ))
+        return 0;
+
+    switch( simd )
+    {
+    case Compositor::SIMD_AUTO:
+        return getCompositorKernels( _detectSIMD( ));
+    case Compositor::SIMD_NONE:
+        return &_scalarKernels;
+#ifdef EQ_COMPOSITOR_X86
+    case Compositor::SIMD_SSE41:
+        return &_sse41Kernels;
+    case Compositor::SIMD_AVX2:
+        return &_avx2Kernels;
+    case Compositor::SIMD_AVX512:
+        return &_avx512Kernels;
+#endif
+    default:
+        return 0;
+    }
+}
+
+const CompositorKernels& getCompositorKernels()
+{
+    return *_kernels;
+}
+
+bool setCompositorKernels( Compositor::SIMD simd )
+{
+    if( simd == Compositor::SIMD_AUTO )
+        simd = _detectSIMD();
+
+    const CompositorKernels* kernels = getCompositorKernels( simd );
+    if( !kernels )
+        return false;
+
+    _simd = simd;
+    _kernels = kernels;
+    return true;
+}
+
+Compositor::SIMD getCompositorSIMD()
+{
+    return _simd;
+}
+
+}
+}
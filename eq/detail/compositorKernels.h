@@ -0,0 +1,78 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_COMPOSITORKERNELS_H
+#define EQ_DETAIL_COMPOSITORKERNELS_H
+
+#include <eq/compositor.h> // nested enum Compositor::SIMD
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * The per-row pixel kernels used by the CPU compositor, ROI finder and half
+ * float conversion.
+ *
+ * Each kernel processes one row of n pixels. The implementation is selected at
+ * runtime based on the instruction set supported by the CPU, with a scalar
+ * fallback for all other architectures.
+ */
+struct CompositorKernels
+{
+    /** Keep the nearer of dest and source pixel, using 32 bit depth. */
+    void ( *mergeDepth )( uint32_t* destColor, uint32_t* destDepth,
+                          const uint32_t* color, const uint32_t* depth,
+                          size_t n );
+
+    /** Copy nBytes of pixel data. */
+    void ( *copy )( uint8_t* dest, const uint8_t* source, size_t nBytes );
+
+    /** Blend premultiplied 8 bit RGBA/BGRA source pixels onto dest. */
+    void ( *blend )( uint8_t* dest, const uint8_t* source, size_t n );
+
+    /**
+     * Set blocks[i] to 255 if one of the pixels [i*16, i*16+16) differs from
+     * background in the given bits. Blocks already set are not checked.
+     */
+    void ( *markOccupied )( uint8_t* blocks, const uint32_t* pixels,
+                            uint32_t background, uint32_t bits, size_t n );
+
+    /** Convert n half floats to floats. */
+    void ( *halfToFloat )( float* dest, const uint16_t* source, size_t n );
+
+    /** Convert n floats to half floats, rounding to nearest even. */
+    void ( *floatToHalf )( uint16_t* dest, const float* source, size_t n );
+};
+
+/** @return the kernels of the currently active instruction set. */
+const CompositorKernels& getCompositorKernels();
+
+/** @return the kernels for the given instruction set, or 0 if unsupported. */
+const CompositorKernels* getCompositorKernels( Compositor::SIMD simd );
+
+/** @return true if the CPU supports the given instruction set. */
+bool isSupported( Compositor::SIMD simd );
+
+/** Activate the given instruction set, @return false if unsupported. */
+bool setCompositorKernels( Compositor::SIMD simd );
+
+/** @return the instruction set of the currently active kernels. */
+Compositor::SIMD getCompositorSIMD();
+}
+}
+
+#endif // EQ_DETAIL_COMPOSITORKERNELS_H
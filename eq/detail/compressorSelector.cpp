@@ -0,0 +1,232 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "compressorSelector.h"
+
+#include "../image.h"
+#include "../log.h"
+
+#include <co/global.h>
+#include <lunchbox/scopedMutex.h>
+#include <pression/plugin.h>
+#include <pression/pluginRegistry.h>
+#include <pression/pluginVisitor.h>
+#include <pression/plugins/compressor.h>
+
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+const float _weight = 0.25f; // of a new sample in the running estimates
+const float _defaultBandwidth = 125000.f; // bytes/ms, 1 GBit/s
+const float _maxBandwidth = 1250000.f; // bytes/ms, 10 GBit/s, for unknown links
+const uint64_t _minTransmitSize = LB_64KB; // smaller sends are latency-bound
+const uint64_t _exploreInterval = 64; // decisions between re-evaluations
+
+class CandidateFinder : public pression::ConstPluginVisitor
+{
+public:
+    CandidateFinder( const uint32_t token, const float minQuality )
+        : token_( token ), minQuality_( minQuality ) {}
+
+    virtual fabric::VisitorResult visit( const pression::Plugin&,
+                                         const EqCompressorInfo& info )
+    {
+        if( !( info.capabilities & EQ_COMPRESSOR_TRANSFER ) &&
+            info.tokenType == token_ && info.quality >= minQuality_ )
+        {
+            result.push_back( info.name );
+        }
+        return fabric::TRAVERSE_CONTINUE;
+    }
+
+    std::vector< uint32_t > result;
+
+private:
+    const uint32_t token_;
+    const float minQuality_;
+};
+}
+
+void CompressorSelector::Estimate::add( const float sample )
+{
+    if( nSamples++ == 0 )
+        value = sample;
+    else
+        value += _weight * ( sample - value );
+}
+
+CompressorSelector::CompressorSelector()
+    : _nDecisions( 0 )
+{}
+
+CompressorSelector& CompressorSelector::getInstance()
+{
+    static CompressorSelector instance;
+    return instance;
+}
+
+uint32_t CompressorSelector::choose( const Image& image,
+                                     const Frame::Buffer buffer,
+                                     const co::NodeIDs& receivers )
+{
+    if( !image.hasPixelData( buffer ) || receivers.empty( ))
+        return EQ_COMPRESSOR_NONE;
+
+    CandidateFinder finder( image.getExternalFormat( buffer ),
+                            image.getQuality( buffer ));
+    co::Global::getPluginRegistry().accept( finder );
+    return select( finder.result, image.getPixelDataSize( buffer ), receivers );
+}
+
+uint32_t CompressorSelector::select( const std::vector< uint32_t >& candidates,
+                                     const uint64_t nBytes,
+                                     const co::NodeIDs& receivers )
+{
+    if( candidates.empty() || receivers.empty( ))
+        return EQ_COMPRESSOR_NONE;
+
+    lunchbox::ScopedMutex<> mutex( _lock );
+    const uint64_t decision = ++_nDecisions;
+
+    uint32_t best = EQ_COMPRESSOR_NONE;
+    float bestTime = _getTime( EQ_COMPRESSOR_NONE, nBytes, receivers );
+    uint32_t oldest = EQ_COMPRESSOR_NONE;
+    uint64_t oldestUse = std::numeric_limits< uint64_t >::max();
+
+    BOOST_FOREACH( const uint32_t name, candidates )
+    {
+        Plugin& plugin = _plugins[ name ];
+        if( plugin.lastUsed == 0 ) // explore untried plugins
+        {
+            plugin.lastUsed = decision;
+            return name;
+        }
+        if( plugin.compressSpeed.nSamples == 0 ) // tried, but no result yet
+            continue;
+
+        if( plugin.lastUsed < oldestUse )
+        {
+            oldest = name;
+            oldestUse = plugin.lastUsed;
+        }
+
+        const float time = _getTime( name, nBytes, receivers );
+        if( time < bestTime )
+        {
+            best = name;
+            bestTime = time;
+        }
+    }
+
+    if( decision % _exploreInterval == 0 )
+        best = oldest;
+    if( best != EQ_COMPRESSOR_NONE )
+        _plugins[ best ].lastUsed = decision;
+
+    LBLOG( LOG_PLUGIN ) << "Adaptive compressor 0x" << std::hex << best
+                        << std::dec << " for " << nBytes << " bytes, estimated "
+                        << bestTime << " ms" << std::endl;
+    return best;
+}
+
+void CompressorSelector::addTransmit( const co::NodeID& receiver,
+                                      const uint64_t nBytes, const float time,
+                                      const float linkBandwidth )
+{
+    if( nBytes < _minTransmitSize || time <= 0.f )
+        return;
+
+    const float bandwidth = std::min( float( nBytes ) / time,
+                       linkBandwidth > 0.f ? linkBandwidth : _maxBandwidth );
+
+    lunchbox::ScopedMutex<> mutex( _lock );
+    _bandwidths[ receiver ].add( bandwidth );
+}
+
+void CompressorSelector::addCompress( const uint32_t name,
+                                      const uint64_t nBytes,
+                                      const uint64_t size, const float time )
+{
+    if( name <= EQ_COMPRESSOR_NONE || nBytes == 0 || time <= 0.f )
+        return;
+
+    lunchbox::ScopedMutex<> mutex( _lock );
+    Plugin& plugin = _plugins[ name ];
+    plugin.ratio.add( float( size ) / float( nBytes ));
+    plugin.compressSpeed.add( float( nBytes ) / time );
+}
+
+void CompressorSelector::addDecompress( const uint32_t name,
+                                        const uint64_t nBytes,
+                                        const float time )
+{
+    if( name <= EQ_COMPRESSOR_NONE || nBytes == 0 || time <= 0.f )
+        return;
+
+    lunchbox::ScopedMutex<> mutex( _lock );
+    _plugins[ name ].decompressSpeed.add( float( nBytes ) / time );
+}
+
+float CompressorSelector::getBandwidth( const co::NodeID& receiver ) const
+{
+    lunchbox::ScopedMutex<> mutex( _lock );
+    return _getBandwidth( receiver );
+}
+
+float CompressorSelector::_getBandwidth( const co::NodeID& receiver ) const
+{
+    BandwidthHash::const_iterator i = _bandwidths.find( receiver );
+    return i == _bandwidths.end() ? _defaultBandwidth : i->second.value;
+}
+
+float CompressorSelector::_getTime( const uint32_t name, const uint64_t nBytes,
+                                    const co::NodeIDs& receivers ) const
+{
+    const float size = float( nBytes );
+    float ratio = 1.f;
+    float codecTime = 0.f;
+
+    if( name != EQ_COMPRESSOR_NONE )
+    {
+        PluginHash::const_iterator i = _plugins.find( name );
+        LBASSERT( i != _plugins.end( ));
+        const Plugin& plugin = i->second;
+
+        // Unmeasured decompression is assumed as fast as compression
+        const float decompressSpeed = plugin.decompressSpeed.nSamples > 0 ?
+                                      plugin.decompressSpeed.value :
+                                      plugin.compressSpeed.value;
+        ratio = plugin.ratio.value;
+        codecTime = size / plugin.compressSpeed.value +
+                    size / decompressSpeed;
+    }
+
+    // receivers are served in parallel, the slowest one defines the latency
+    float sendTime = 0.f;
+    BOOST_FOREACH( const co::NodeID& receiver, receivers )
+        sendTime = std::max( sendTime,
+                             size * ratio / _getBandwidth( receiver ));
+    return codecTime + sendTime;
+}
+}
+}
@@ -0,0 +1,123 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_DETAIL_COMPRESSORSELECTOR_H
+#define EQ_DETAIL_COMPRESSORSELECTOR_H
+
+#include <eq/frame.h> // enum Frame::Buffer
+#include <eq/types.h>
+
+#include <co/types.h>
+#include <lunchbox/lock.h>
+#include <lunchbox/stdExt.h>
+#include <boost/noncopyable.hpp>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * Selects the compressor of an image buffer for EQ_COMPRESSOR_ADAPTIVE.
+ *
+ * Keeps running estimates of the achieved bandwidth to each receiver node, and
+ * of the ratio and the compression and decompression throughput of each
+ * compressor plugin. The chosen compressor, or none, minimizes the estimated
+ * time for compressing, sending and decompressing the buffer. Plugins without
+ * measurements are tried first, and the least recently used candidate is tried
+ * periodically to follow changing conditions.
+ *
+ * Decompression is measured on the images received by this process, which
+ * assumes similar receivers. All methods are thread-safe.
+ */
+class CompressorSelector : public boost::noncopyable
+{
+public:
+    /** @return the per-process instance. */
+    static CompressorSelector& getInstance();
+
+    /**
+     * @return the compressor name for the given image buffer sent to the given
+     *         receivers, or EQ_COMPRESSOR_NONE.
+     */
+    uint32_t choose( const Image& image, Frame::Buffer buffer,
+                     const co::NodeIDs& receivers );
+
+    /**
+     * @return the compressor name of the given candidates for nBytes sent to
+     *         the given receivers, or EQ_COMPRESSOR_NONE.
+     */
+    uint32_t select( const std::vector< uint32_t >& candidates,
+                     uint64_t nBytes, const co::NodeIDs& receivers );
+
+    /**
+     * Add a measurement of nBytes sent to the receiver in time ms.
+     *
+     * Sends return once the data is queued in the socket buffers, which
+     * overestimates the bandwidth. The sample is therefore limited to the
+     * given link bandwidth in bytes/ms, or to 10 GBit/s if it is unknown.
+     */
+    void addTransmit( const co::NodeID& receiver, uint64_t nBytes,
+                      float time, float linkBandwidth );
+
+    /** Add a measurement of nBytes compressed to size in time ms. */
+    void addCompress( uint32_t name, uint64_t nBytes, uint64_t size,
+                      float time );
+
+    /** Add a measurement of nBytes decompressed in time ms. */
+    void addDecompress( uint32_t name, uint64_t nBytes, float time );
+
+    /** @return the estimated bandwidth to the receiver in bytes/ms. */
+    float getBandwidth( const co::NodeID& receiver ) const;
+
+private:
+    CompressorSelector();
+
+    /** Exponentially weighted running average. */
+    struct Estimate
+    {
+        Estimate() : value( 0.f ), nSamples( 0 ) {}
+        void add( float sample );
+
+        float value;
+        uint32_t nSamples;
+    };
+
+    struct Plugin
+    {
+        Plugin() : lastUsed( 0 ) {}
+
+        Estimate ratio;
+        Estimate compressSpeed; //!< bytes/ms of input data
+        Estimate decompressSpeed; //!< bytes/ms of output data
+        uint64_t lastUsed; //!< decision of last selection, 0 if untried
+    };
+
+    typedef stde::hash_map< uint128_t, Estimate > BandwidthHash;
+    typedef stde::hash_map< uint32_t, Plugin > PluginHash;
+
+    mutable lunchbox::Lock _lock;
+    BandwidthHash _bandwidths;
+    PluginHash _plugins;
+    uint64_t _nDecisions;
+
+    float _getTime( uint32_t name, uint64_t nBytes,
+                    const co::NodeIDs& receivers ) const;
+    float _getBandwidth( const co::NodeID& receiver ) const;
+};
+}
+}
+
+#endif // EQ_DETAIL_COMPRESSORSELECTOR_H
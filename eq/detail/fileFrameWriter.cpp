@@ -18,17 +18,68 @@
 #include "fileFrameWriter.h"
 
 #include <eq/channel.h>
+#include <eq/channelStatistics.h>
 #include <eq/image.h>
+#include <eq/pixelData.h>
 
 #include <lunchbox/log.h>
+#include <lunchbox/scopedMutex.h>
+#include <lunchbox/thread.h>
+
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <thread>
 
 namespace eq
 {
 namespace detail
 {
+namespace
+{
+/** @return the number of writer threads, leaving most cores to rendering. */
+size_t _getNumWorkers()
+{
+    const size_t nCores = std::thread::hardware_concurrency();
+    return std::min( std::max( nCores / 4, size_t( 1 )), size_t( 4 ));
+}
+}
+
+class FileFrameWriter::Worker : public lunchbox::Thread
+{
+public:
+    explicit Worker( FileFrameWriter& writer ) : _writer( writer ) {}
+    virtual ~Worker() {}
+
+protected:
+    bool init() override { setName( "DumpImage" ); return true; }
+    void run() override { _writer._run(); }
+
+private:
+    FileFrameWriter& _writer;
+};
+
 FileFrameWriter::FileFrameWriter()
     : ResultImageListener()
+    , _maxQueued( 0 )
+    , _queued( 0 )
+    , _latency( 0 )
+    , _nWritten( 0 )
+    , _nDropped( 0 )
+{
+}
+
+FileFrameWriter::~FileFrameWriter()
 {
+    for( size_t i = 0; i < _workers.size(); ++i )
+        _queue.push( Job( )); // wake up to exit
+
+    BOOST_FOREACH( Worker* worker, _workers )
+    {
+        worker->join();
+        delete worker;
+    }
+    BOOST_FOREACH( Image* image, _freeImages.data )
+        delete image;
 }
 
 void FileFrameWriter::notifyNewImage( eq::Channel& channel,
@@ -37,13 +88,101 @@ void FileFrameWriter::notifyNewImage( eq::Channel& channel,
     const std::string& prefix =
             channel.getSAttribute( eq::Channel::SATTR_DUMP_IMAGE );
     LBASSERT( !prefix.empty( ));
-    const std::string fileName = prefix + channel.getDumpImageFileName();
-    if( !image.writeImage( fileName, eq::Frame::BUFFER_COLOR ))
-        LBWARN << "Could not write file " << fileName << std::endl;
+
+    Job job;
+    job.fileName = prefix + channel.getDumpImageFileName();
+
+    const int32_t mode = channel.getIAttribute(
+                             eq::Channel::IATTR_HINT_DUMP_IMAGE );
+    if( mode == OFF )
+    {
+        if( !image.writeImage( job.fileName, eq::Frame::BUFFER_COLOR ))
+            LBWARN << "Could not write file " << job.fileName << std::endl;
+        return;
+    }
+
+    ChannelStatistics event( Statistic::CHANNEL_DUMP_IMAGE, &channel );
+    if( _workers.empty( ))
+        _startWorkers();
+
+    bool drop = false;
+    if( mode == ASYNC )
+        drop = _queued.get() >= _maxQueued;
+    else
+        _queued.waitLE( _maxQueued - 1 ); // back-pressure
+
+    {
+        lunchbox::ScopedFastWrite mutex( _freeImages );
+        if( drop )
+            ++_nDropped;
+        else if( _freeImages->empty( ))
+            job.image = new Image;
+        else
+        {
+            job.image = _freeImages->back();
+            _freeImages->pop_back();
+        }
+
+        Statistic& stat = event.event.data.statistic;
+        stat.plugins[1] = _nDropped;
+        stat.totalTime = _nWritten > 0 ? _latency / _nWritten : 0;
+        _latency = 0;
+        _nWritten = 0;
+        _nDropped = 0;
+    }
+
+    if( !drop )
+    {
+        // snapshot the pixels, reusing the memory of the recycled image
+        job.image->setPixelViewport( image.getPixelViewport( ));
+        job.image->setPixelData( eq::Frame::BUFFER_COLOR,
+                                 image.getPixelData( eq::Frame::BUFFER_COLOR ));
+        job.clock.reset();
+        ++_queued;
+        _queue.push( job );
+    }
+    event.event.data.statistic.plugins[0] = _queued.get();
 }
 
-FileFrameWriter::~FileFrameWriter()
+void FileFrameWriter::flush()
+{
+    _queued.waitEQ( 0 );
+}
+
+void FileFrameWriter::_startWorkers()
+{
+    const size_t nWorkers = _getNumWorkers();
+    _maxQueued = uint32_t( nWorkers * 2 );
+    for( size_t i = 0; i < nWorkers; ++i )
+    {
+        _workers.push_back( new Worker( *this ));
+        _workers.back()->start();
+    }
+}
+
+void FileFrameWriter::_run()
 {
+    for( ;; )
+    {
+        const Job job = _queue.pop();
+        if( !job.image )
+            return;
+        _write( job );
+    }
+}
+
+void FileFrameWriter::_write( const Job& job )
+{
+    if( !job.image->writeImage( job.fileName, eq::Frame::BUFFER_COLOR ))
+        LBWARN << "Could not write file " << job.fileName << std::endl;
+
+    {
+        lunchbox::ScopedFastWrite mutex( _freeImages );
+        _freeImages->push_back( job.image );
+        _latency += job.clock.getTime64();
+        ++_nWritten;
+    }
+    --_queued;
 }
 
 }
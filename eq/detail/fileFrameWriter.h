@@ -21,6 +21,12 @@
 #include <eq/resultImageListener.h> // base class
 #include <eq/types.h>
 
+#include <lunchbox/clock.h>    // member
+#include <lunchbox/lockable.h> // member
+#include <lunchbox/monitor.h>  // member
+#include <lunchbox/mtQueue.h>  // member
+#include <lunchbox/spinLock.h> // member
+
 namespace eq
 {
 namespace detail
@@ -29,6 +35,11 @@ namespace detail
 /**
  * Persist the color buffer of a channel to a file.
  * The name of the file is Channel::SATTR_DUMP_IMAGE.rgb
+ *
+ * Depending on Channel::IATTR_HINT_DUMP_IMAGE, the images are written on the
+ * calling thread, or copied into a recycled snapshot image and written by a
+ * pool of writer threads. The number of queued images is bounded. When the
+ * queue is full, the caller waits (ON) or the image is dropped (ASYNC).
  */
 class FileFrameWriter : public ResultImageListener
 {
@@ -37,6 +48,38 @@ public:
     ~FileFrameWriter();
 
     void notifyNewImage( eq::Channel& channel, const eq::Image& image ) final;
+
+    /** Wait for all queued images to be written. */
+    void flush();
+
+private:
+    class Worker;
+    struct Job
+    {
+        Job() : image( 0 ) {}
+
+        Image* image; //!< the snapshot, 0 to exit
+        std::string fileName;
+        lunchbox::Clock clock; //!< started when queued
+    };
+    typedef std::vector< Worker* > Workers;
+
+    lunchbox::MTQueue< Job > _queue;
+    Workers _workers;
+    uint32_t _maxQueued;
+
+    lunchbox::Monitor< uint32_t > _queued; //!< images queued or being written
+    /** Recycled snapshot images, keeping their pixel memory allocated */
+    lunchbox::Lockable< Images, lunchbox::SpinLock > _freeImages;
+
+    // statistics since the last notification, protected by _freeImages
+    int64_t _latency;
+    uint32_t _nWritten;
+    uint32_t _nDropped;
+
+    void _startWorkers();
+    void _write( const Job& job );
+    void _run();
 };
 
 }
@@ -0,0 +1,496 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "statisticsAggregator.h"
+
+#include "traceFormat.h"
+
+#include <pression/plugins/compressor.h>
+
+#include <lunchbox/lfQueue.h>
+#include <lunchbox/log.h>
+#include <lunchbox/scopedMutex.h>
+
+#include <cstdlib>
+#include <sstream>
+
+namespace eq
+{
+namespace detail
+{
+namespace
+{
+const int32_t _ringSize = 4096; // statistics per thread
+
+void _writeName( std::ostream& os, const TraceRecord kind, const uint32_t id,
+                 const std::string& name )
+{
+    const uint8_t record = kind;
+    const uint32_t length = uint32_t( name.length( ));
+    os.write( reinterpret_cast< const char* >( &record ), sizeof( record ));
+    os.write( reinterpret_cast< const char* >( &id ), sizeof( id ));
+    os.write( reinterpret_cast< const char* >( &length ), sizeof( length ));
+    os.write( name.c_str(), length );
+}
+
+#ifdef EQUALIZER_USE_GLSTATS
+struct Entry
+{
+    GLStats::Item item;
+    GLStats::Type type;
+    GLStats::Entity entity;
+};
+typedef std::vector< Entry > Entries;
+
+/** @return true if the statistic is an item, false if it only updates text. */
+bool _format( const uint32_t originator, const Statistic& stat,
+              std::string& idleText, Entry& entry )
+{
+    GLStats::Item& item = entry.item;
+    item.entity = originator;
+    item.type = stat.type;
+    item.frame = stat.frameNumber;
+    item.start = stat.startTime;
+    item.end = stat.endTime;
+    item.thread = getTraceTrack( stat.type );
+
+    entry.entity.name = stat.resourceName;
+
+    GLStats::Type& type = entry.type;
+    const Vector3f& color = Statistic::getColor( stat.type );
+
+    type.color[0] = color[0];
+    type.color[1] = color[1];
+    type.color[2] = color[2];
+    type.name = Statistic::getName( stat.type );
+
+    switch( stat.type )
+    {
+      case Statistic::CHANNEL_FRAME_COMPRESS:
+      case Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN:
+          type.subgroup = "transmit";
+          // no break;
+      case Statistic::CHANNEL_FRAME_WAIT_READY:
+      case Statistic::CHANNEL_TILES:
+          type.group = "channel";
+          item.layer = 1;
+          break;
+      case Statistic::CHANNEL_CLEAR:
+      case Statistic::CHANNEL_DRAW:
+      case Statistic::CHANNEL_DRAW_FINISH:
+      case Statistic::CHANNEL_ASSEMBLE:
+      case Statistic::CHANNEL_READBACK:
+      case Statistic::CHANNEL_VIEW_FINISH:
+          type.group = "channel";
+          break;
+      case Statistic::CHANNEL_DUMP_IMAGE:
+          type.group = "channel";
+          item.layer = 1;
+          break;
+      case Statistic::CHANNEL_ROI:
+          type.group = "channel";
+          type.subgroup = "transmit";
+          break;
+      case Statistic::CHANNEL_ASYNC_READBACK:
+          type.group = "channel";
+          type.subgroup = "transfer";
+          break;
+      case Statistic::CHANNEL_FRAME_TRANSMIT:
+          type.group = "channel";
+          type.subgroup = "transmit";
+          break;
+
+      case Statistic::WINDOW_FINISH:
+      case Statistic::WINDOW_THROTTLE_FRAMERATE:
+      case Statistic::WINDOW_SWAP_BARRIER:
+      case Statistic::WINDOW_SWAP:
+          type.group = "window";
+          break;
+      case Statistic::NODE_FRAME_DECOMPRESS:
+          type.group = "node";
+          break;
+
+      case Statistic::CONFIG_WAIT_FINISH_FRAME:
+          item.layer = 1;
+          // no break;
+      case Statistic::CONFIG_START_FRAME:
+      case Statistic::CONFIG_FINISH_FRAME:
+      case Statistic::CONFIG_SERVER_FRAME:
+          type.group = "config";
+          break;
+
+      case Statistic::PIPE_IDLE:
+      {
+          const float idle = stat.idleTime * 100ll / stat.totalTime;
+          std::stringstream text;
+          if( idleText.empty( ))
+              text <<  "Idle: " << stat.resourceName << ' ' << idle << "%";
+          else
+          {
+              const size_t pos = idleText.find( stat.resourceName );
+
+              if( pos == std::string::npos ) // append new pipe
+                  text << idleText << ", " << stat.resourceName << ' '
+                       << idle << "%";
+              else // replace existing text
+              {
+                  const std::string& left = idleText.substr( pos + 1 );
+
+                  text << idleText.substr( 0, pos ) << stat.resourceName
+                       << ' ' << idle << left.substr( left.find( '%' ));
+              }
+          }
+          idleText = text.str();
+      }
+      // no break;
+
+      case Statistic::WINDOW_FPS:
+      case Statistic::NONE:
+      case Statistic::ALL:
+          return false;
+    }
+    switch( stat.type )
+    {
+      case Statistic::CHANNEL_FRAME_COMPRESS:
+      case Statistic::CHANNEL_ASYNC_READBACK:
+      case Statistic::CHANNEL_READBACK:
+      {
+          std::stringstream text;
+          text << unsigned( 100.f * stat.ratio ) << '%';
+
+          if( stat.plugins[ 0 ] > EQ_COMPRESSOR_NONE )
+              text << " 0x" << std::hex << stat.plugins[0] << std::dec;
+          if( stat.plugins[ 1 ] > EQ_COMPRESSOR_NONE &&
+              stat.plugins[ 0 ] != stat.plugins[ 1 ] )
+          {
+              text << " 0x" << std::hex << stat.plugins[1] << std::dec;
+          }
+          if( stat.type == Statistic::CHANNEL_FRAME_COMPRESS &&
+              stat.plugins[ 0 ] <= EQ_COMPRESSOR_NONE &&
+              stat.plugins[ 1 ] <= EQ_COMPRESSOR_NONE )
+          {
+              text << " raw"; // e.g., chosen by EQ_COMPRESSOR_ADAPTIVE
+          }
+          item.text = text.str();
+          break;
+      }
+      case Statistic::CHANNEL_FRAME_TRANSMIT:
+      {
+          std::stringstream text;
+          text << stat.plugins[0] << " img " << stat.plugins[1] << " sends";
+          item.text = text.str();
+          break;
+      }
+      case Statistic::CHANNEL_ROI:
+      {
+          std::stringstream text;
+          text << unsigned( 100.f * stat.ratio ) << "% reused "
+               << stat.plugins[0] << " areas";
+          item.text = text.str();
+          break;
+      }
+      case Statistic::CONFIG_SERVER_FRAME:
+      {
+          std::stringstream text;
+          text << stat.plugins[0] << " nodes " << stat.plugins[1] / 1024
+               << " KB";
+          item.text = text.str();
+          break;
+      }
+      case Statistic::CHANNEL_DUMP_IMAGE:
+      {
+          std::stringstream text;
+          text << stat.plugins[0] << " queued " << stat.totalTime << " ms";
+          if( stat.plugins[1] > 0 )
+              text << " " << stat.plugins[1] << " dropped";
+          item.text = text.str();
+          break;
+      }
+      case Statistic::CHANNEL_TILES:
+      {
+          const int64_t time = LB_MAX( stat.endTime - stat.startTime, 1 );
+          std::stringstream text;
+          text << stat.plugins[0] << " tiles " << stat.plugins[0] * 1000 / time
+               << "/s";
+          item.text = text.str();
+          break;
+      }
+      default:
+          break;
+    }
+    return true;
+}
+#endif
+}
+
+/** The statistics queued by one thread. */
+class StatisticsAggregator::Ring
+{
+public:
+    Ring() : queue( _ringSize ), nQueued( 0 ) {}
+
+    lunchbox::LFQueue< Record > queue;
+    int32_t nQueued; //!< since the last drain request, used by the writer
+};
+
+StatisticsAggregator::StatisticsAggregator()
+    : _nDropped( 0 )
+    , _traceName( ::getenv( "EQ_TRACE_FILE" ) ? ::getenv( "EQ_TRACE_FILE" ) :
+                                                "" )
+{}
+
+StatisticsAggregator::~StatisticsAggregator()
+{
+    if( isRunning( ))
+    {
+        _commands.push( Command( CMD_EXIT ));
+        join();
+    }
+    for( Ring* ring : _rings.data )
+        delete ring;
+}
+
+void StatisticsAggregator::add( const uint32_t originator,
+                                const Statistic& stat )
+{
+    LBASSERT( stat.type != Statistic::NONE );
+
+    // Not a frame-related stat event OR no event-type set
+    if( stat.frameNumber == 0 || stat.type == Statistic::NONE )
+        return;
+#ifndef EQUALIZER_USE_GLSTATS
+    if( _traceName.empty( ))
+        return;
+#endif
+
+    Ring* ring = _ring.get();
+    if( !ring )
+        ring = _registerRing();
+
+    Record record;
+    record.originator = originator;
+    record.stat = stat;
+    if( !ring->queue.push( record ))
+    {
+        ++_nDropped;
+        return;
+    }
+
+    if( ++ring->nQueued < _ringSize / 2 )
+        return;
+    ring->nQueued = 0;
+    _commands.push( Command( CMD_DRAIN ));
+}
+
+void StatisticsAggregator::obsolete( const uint32_t frames )
+{
+    if( isRunning( ))
+        _commands.push( Command( CMD_OBSOLETE, frames ));
+}
+
+void StatisticsAggregator::clear()
+{
+    if( isRunning( ))
+        _commands.push( Command( CMD_CLEAR ));
+}
+
+#ifdef EQUALIZER_USE_GLSTATS
+GLStats::Data StatisticsAggregator::getData() const
+{
+    lunchbox::ScopedFastRead mutex( _data );
+    return _data.data;
+}
+#endif
+
+bool StatisticsAggregator::init()
+{
+    setName( "Statistics" );
+    _openTrace();
+    return true;
+}
+
+StatisticsAggregator::Ring* StatisticsAggregator::_registerRing()
+{
+    Ring* ring = new Ring;
+    _ring = ring;
+
+    lunchbox::ScopedFastWrite mutex( _rings );
+    _rings->push_back( ring );
+    if( !isRunning( ))
+        start();
+    return ring;
+}
+
+void StatisticsAggregator::run()
+{
+    for( ;; )
+    {
+        const Command command = _commands.pop();
+        _drain();
+
+        switch( command.type )
+        {
+        case CMD_DRAIN:
+            break;
+
+        case CMD_OBSOLETE:
+        {
+            if( _trace.is_open( ))
+                _trace.flush(); // once per frame
+#ifdef EQUALIZER_USE_GLSTATS
+            lunchbox::ScopedFastWrite mutex( _data );
+            _data->obsolete( command.frames );
+#endif
+            break;
+        }
+
+        case CMD_CLEAR:
+        {
+#ifdef EQUALIZER_USE_GLSTATS
+            lunchbox::ScopedFastWrite mutex( _data );
+            _data->clear();
+            _idleText.clear();
+#endif
+            break;
+        }
+
+        case CMD_EXIT:
+            return;
+        }
+    }
+}
+
+void StatisticsAggregator::_drain()
+{
+#ifdef EQUALIZER_USE_GLSTATS
+    Entries entries;
+    const std::string idleText = _idleText;
+#endif
+    {
+        lunchbox::ScopedFastRead mutex( _rings );
+        Record record;
+        for( Ring* ring : _rings.data )
+        {
+            while( ring->queue.pop( record ))
+            {
+                if( _trace.is_open( ))
+                    _writeTrace( record );
+#ifdef EQUALIZER_USE_GLSTATS
+                Entry entry;
+                if( _format( record.originator, record.stat, _idleText,
+                             entry ))
+                {
+                    entries.push_back( entry );
+                }
+#endif
+            }
+        }
+    }
+
+    const int32_t nDropped = _nDropped;
+    if( nDropped > 0 )
+    {
+        _nDropped -= nDropped;
+        LBWARN << "Dropped " << nDropped << " statistics, the aggregator "
+               << "is too slow" << std::endl;
+    }
+
+#ifdef EQUALIZER_USE_GLSTATS
+    if( entries.empty() && idleText == _idleText )
+        return;
+
+    lunchbox::ScopedFastWrite mutex( _data );
+    if( idleText != _idleText )
+        _data->setText( _idleText );
+    for( const Entry& entry : entries )
+    {
+        _data->setType( entry.item.type, entry.type );
+        _data->setEntity( entry.item.entity, entry.entity );
+        _data->addItem( entry.item );
+    }
+#endif
+}
+
+void StatisticsAggregator::_openTrace()
+{
+    if( _traceName.empty( ))
+        return;
+
+    _trace.open( _traceName.c_str(), std::ios::out | std::ios::binary |
+                                     std::ios::trunc );
+    if( !_trace.is_open( ))
+    {
+        LBWARN << "Can't open statistics trace " << _traceName << std::endl;
+        return;
+    }
+
+    _trace.write( traceMagic, sizeof( traceMagic ));
+    _trace.write( reinterpret_cast< const char* >( &traceVersion ),
+                  sizeof( traceVersion ));
+    for( uint32_t i = Statistic::NONE + 1; i < Statistic::ALL; ++i )
+        _writeName( _trace, TRACE_TYPE, i,
+                    Statistic::getName( Statistic::Type( i )));
+    LBINFO << "Writing statistics trace to " << _traceName << std::endl;
+}
+
+void StatisticsAggregator::_writeTrace( const Record& record )
+{
+    const Statistic& stat = record.stat;
+    std::string& name = _traceEntities[ record.originator ];
+    if( name != stat.resourceName )
+    {
+        name = stat.resourceName;
+        _writeName( _trace, TRACE_ENTITY, record.originator, name );
+    }
+
+    TraceEvent event;
+    event.startTime = stat.startTime;
+    event.endTime = stat.endTime;
+    event.type = stat.type;
+    event.originator = record.originator;
+    event.frameNumber = stat.frameNumber;
+    event.track = getTraceTrack( stat.type );
+    event.values[0] = stat.plugins[0];
+    event.values[1] = stat.plugins[1];
+    event.task = stat.task;
+
+    switch( stat.type )
+    {
+      case Statistic::PIPE_IDLE:
+          event.value = stat.totalTime > 0 ?
+                        float( stat.idleTime ) / float( stat.totalTime ) : 0.f;
+          break;
+      case Statistic::WINDOW_FPS:
+          event.value = stat.currentFPS;
+          break;
+      case Statistic::CHANNEL_READBACK:
+      case Statistic::CHANNEL_ASYNC_READBACK:
+      case Statistic::CHANNEL_FRAME_COMPRESS:
+      case Statistic::CHANNEL_ROI:
+          event.value = stat.ratio;
+          break;
+      default:
+          event.value = 0.f;
+          break;
+    }
+
+    const uint8_t kind = TRACE_EVENT;
+    _trace.write( reinterpret_cast< const char* >( &kind ), sizeof( kind ));
+    _trace.write( reinterpret_cast< const char* >( &event ), sizeof( event ));
+}
+
+}
+}
@@ -0,0 +1,128 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_STATISTICSAGGREGATOR_H
+#define EQ_STATISTICSAGGREGATOR_H
+
+#include <eq/types.h>
+#include <eq/fabric/statistic.h> // member
+#ifdef EQUALIZER_USE_GLSTATS
+#  include <GLStats/GLStats.h>   // member
+#endif
+
+#include <lunchbox/atomic.h>    // member
+#include <lunchbox/lockable.h>  // member
+#include <lunchbox/mtQueue.h>   // member
+#include <lunchbox/perThread.h> // member
+#include <lunchbox/spinLock.h>  // member
+#include <lunchbox/thread.h>    // base class
+
+#include <fstream>       // member
+#include <unordered_map> // member
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * Adds the statistics of a config to its GLStats data and trace file.
+ *
+ * Statistics are queued without locking in a ring buffer of the calling
+ * thread. A background thread drains all rings when a frame is finished or a
+ * ring is half full, builds the GLStats items and adds them to the data in one
+ * locked update. Statistics added to a full ring are dropped.
+ *
+ * If EQ_TRACE_FILE is set, the background thread also appends all statistics
+ * to this file, using the format described in traceFormat.h.
+ */
+class StatisticsAggregator : public lunchbox::Thread
+{
+public:
+    StatisticsAggregator();
+
+    /** Stop the aggregator thread, discarding the queued statistics. */
+    virtual ~StatisticsAggregator();
+
+    /** Queue a statistic of the given entity. Thread safe, lock-free. */
+    void add( uint32_t originator, const Statistic& stat );
+
+    /** Add the queued statistics and keep the given number of frames. */
+    void obsolete( uint32_t frames );
+
+    /** Add the queued statistics and clear all data. */
+    void clear();
+
+#ifdef EQUALIZER_USE_GLSTATS
+    /** @return a copy of the statistics data. Thread safe. */
+    GLStats::Data getData() const;
+#endif
+
+protected:
+    bool init() override;
+    void run() override;
+
+private:
+    struct Record
+    {
+        uint32_t originator;
+        Statistic stat;
+    };
+    class Ring;
+    typedef std::vector< Ring* > Rings;
+
+    enum CommandType
+    {
+        CMD_DRAIN,
+        CMD_OBSOLETE,
+        CMD_CLEAR,
+        CMD_EXIT
+    };
+    struct Command
+    {
+        Command( const CommandType type_ = CMD_DRAIN,
+                 const uint32_t frames_ = 0 )
+            : type( type_ ), frames( frames_ ) {}
+
+        CommandType type;
+        uint32_t frames; //!< the frames to keep for CMD_OBSOLETE
+    };
+
+    lunchbox::PerThread< Ring, lunchbox::perThreadNoDelete > _ring;
+    lunchbox::Lockable< Rings, lunchbox::SpinLock > _rings;
+    lunchbox::MTQueue< Command > _commands;
+    lunchbox::a_int32_t _nDropped;
+
+#ifdef EQUALIZER_USE_GLSTATS
+    lunchbox::Lockable< GLStats::Data, lunchbox::SpinLock > _data;
+    std::string _idleText; //!< the pipe idle text, only used by the thread
+#endif
+
+    // trace file, only used by the thread
+    const std::string _traceName;
+    std::ofstream _trace;
+    std::unordered_map< uint32_t, std::string > _traceEntities;
+
+    Ring* _registerRing();
+    void _drain();
+    void _openTrace();
+    void _writeTrace( const Record& record );
+};
+
+}
+}
+
+#endif // EQ_STATISTICSAGGREGATOR_H
@@ -0,0 +1,92 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQ_TRACEFORMAT_H
+#define EQ_TRACEFORMAT_H
+
+#include <eq/fabric/statistic.h>
+
+namespace eq
+{
+namespace detail
+{
+/**
+ * @internal
+ * The statistics trace file written when EQ_TRACE_FILE is set.
+ *
+ * The file starts with the eight byte traceMagic and the uint32_t
+ * traceVersion, followed by records in native byte order. Each record starts
+ * with its uint8_t TraceRecord kind. A TRACE_TYPE record names a statistic
+ * type for all following events, a TRACE_ENTITY record names an originator
+ * before its first event or after a rename. Names are stored as the uint32_t
+ * type or originator, the uint32_t length and the characters. A TRACE_EVENT
+ * record is a TraceEvent.
+ */
+const char traceMagic[8] = "EQTRACE";
+const uint32_t traceVersion = 1;
+
+enum TraceRecord
+{
+    TRACE_TYPE,
+    TRACE_ENTITY,
+    TRACE_EVENT
+};
+
+/** The timeline of a statistic within its originator. */
+enum TraceTrack
+{
+    TRACK_MAIN,
+    TRACK_ASYNC1, //!< asynchronous readback
+    TRACK_ASYNC2, //!< compression and transmission
+    TRACK_COUNTER //!< a sampled value without duration
+};
+
+struct TraceEvent
+{
+    int64_t startTime; //!< config time in ms, synchronized by the server
+    int64_t endTime;
+    uint32_t type; //!< the Statistic::Type
+    uint32_t originator;
+    uint32_t frameNumber;
+    uint32_t track; //!< the TraceTrack
+    uint32_t values[2]; //!< the plugins of the statistic
+    float value; //!< the ratio, idle ratio or frame rate
+    uint32_t task;
+};
+
+/** @return the TraceTrack of the given statistic type. */
+inline uint32_t getTraceTrack( const fabric::Statistic::Type type )
+{
+    switch( type )
+    {
+      case fabric::Statistic::CHANNEL_ASYNC_READBACK:
+          return TRACK_ASYNC1;
+      case fabric::Statistic::CHANNEL_FRAME_COMPRESS:
+      case fabric::Statistic::CHANNEL_FRAME_TRANSMIT:
+      case fabric::Statistic::CHANNEL_FRAME_WAIT_SENDTOKEN:
+          return TRACK_ASYNC2;
+      case fabric::Statistic::WINDOW_FPS:
+      case fabric::Statistic::PIPE_IDLE:
+          return TRACK_COUNTER;
+      default:
+          return TRACK_MAIN;
+    }
+}
+
+}
+}
+
+#endif // EQ_TRACEFORMAT_H
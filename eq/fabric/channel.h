@@ -292,6 +292,15 @@ public:
         IATTR_HINT_STATISTICS,
         /** Use a send token for output frames (OFF, ON) */
         IATTR_HINT_SENDTOKEN,
+        /** Send all images of an output frame in one command (OFF, ON) */
+        IATTR_HINT_BATCH_TRANSMIT,
+        /** Trim output images to their non-empty pixels (OFF, ON) */
+        IATTR_HINT_TRIM_TRANSMIT,
+        /**
+         * Write dumped images on the pipe thread (OFF), in the background
+         * (ON), or in the background dropping images when busy (ASYNC)
+         */
+        IATTR_HINT_DUMP_IMAGE,
         IATTR_LAST,
         IATTR_ALL = IATTR_LAST + 5
     };
@@ -36,7 +36,10 @@ namespace
 #define MAKE_ATTR_STRING( attr ) ( std::string("EQ_CHANNEL_") + #attr )
 static std::string _iAttributeStrings[] = {
     MAKE_ATTR_STRING( IATTR_HINT_STATISTICS ),
-    MAKE_ATTR_STRING( IATTR_HINT_SENDTOKEN )
+    MAKE_ATTR_STRING( IATTR_HINT_SENDTOKEN ),
+    MAKE_ATTR_STRING( IATTR_HINT_BATCH_TRANSMIT ),
+    MAKE_ATTR_STRING( IATTR_HINT_TRIM_TRANSMIT ),
+    MAKE_ATTR_STRING( IATTR_HINT_DUMP_IMAGE )
 };
 
 static std::string _sAttributeStrings[] = {
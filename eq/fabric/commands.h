@@ -108,6 +108,7 @@ namespace fabric
         CMD_NODE_FRAME_TASKS_FINISH,
         CMD_NODE_FRAMEDATA_TRANSMIT,
         CMD_NODE_FRAMEDATA_READY,
+        CMD_NODE_FRAMEDATA_TRANSMIT_BATCH,
         CMD_NODE_CUSTOM = CMD_OBJECT_CUSTOM + 20
     };
 
@@ -178,6 +179,7 @@ namespace fabric
         CMD_CHANNEL_FRAME_TILES,
         CMD_CHANNEL_FINISH_READBACK,
         CMD_CHANNEL_DELETE_TRANSFER_WINDOW,
+        CMD_CHANNEL_FRAME_TILE_COSTS,
         CMD_CHANNEL_CUSTOM = CMD_OBJECT_CUSTOM + 30
     };
 
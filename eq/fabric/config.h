@@ -138,6 +138,13 @@ public:
     enum IAttribute
     {
         IATTR_ROBUSTNESS, //!< Tolerate resource failures
+        /**
+         * Generate the tasks of the nodes of a frame in parallel (ON), or from
+         * eight running nodes on (AUTO)
+         */
+        IATTR_HINT_PARALLEL_TASKS,
+        /** Send the server frame statistics to the application (not OFF) */
+        IATTR_HINT_STATISTICS,
         IATTR_LAST,
         IATTR_ALL = IATTR_LAST + 5
     };
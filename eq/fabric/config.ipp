@@ -45,6 +45,8 @@ std::string _fAttributeStrings[] =
 std::string _iAttributeStrings[] =
 {
     MAKE_ATTR_STRING( IATTR_ROBUSTNESS ),
+    MAKE_ATTR_STRING( IATTR_HINT_PARALLEL_TASKS ),
+    MAKE_ATTR_STRING( IATTR_HINT_STATISTICS ),
 };
 }
 
@@ -913,6 +915,12 @@ std::ostream& operator << ( std::ostream& os,
        << IAttribute( config.getIAttribute( C::IATTR_ROBUSTNESS )) << std::endl
        << "eye_base   " << config.getFAttribute( C::FATTR_EYE_BASE )
        << std::endl
+       << "hint_parallel_tasks "
+       << IAttribute( config.getIAttribute( C::IATTR_HINT_PARALLEL_TASKS ))
+       << std::endl
+       << "hint_statistics "
+       << IAttribute( config.getIAttribute( C::IATTR_HINT_STATISTICS ))
+       << std::endl
        << lunchbox::exdent << "}" << std::endl;
 
     const typename C::Nodes& nodes = config.getNodes();
@@ -45,6 +45,7 @@ public:
         , tilesize( 64, 64 )
         , mode( fabric::Equalizer::MODE_2D )
         , frozen( false )
+        , predictive( false )
     {
         const uint32_t flags = eq::fabric::Global::getFlags();
         switch( flags & fabric::ConfigParams::FLAG_LOAD_EQ_ALL )
@@ -76,6 +77,7 @@ public:
         , tilesize( rhs.tilesize )
         , mode( rhs.mode )
         , frozen( rhs.frozen )
+        , predictive( rhs.predictive )
     {}
 
     float damping;
@@ -88,6 +90,7 @@ public:
     Vector2i tilesize;
     fabric::Equalizer::Mode mode;
     bool frozen;
+    bool predictive;
 };
 }
 
@@ -218,12 +221,22 @@ const Vector2i& Equalizer::getTileSize() const
     return _data->tilesize;
 }
 
+void Equalizer::setPredictive( const bool onOff )
+{
+    _data->predictive = onOff;
+}
+
+bool Equalizer::isPredictive() const
+{
+    return _data->predictive;
+}
+
 void Equalizer::serialize( co::DataOStream& os ) const
 {
     os << _data->damping << _data->boundaryf << _data->resistancef
        << _data->assembleOnlyLimit << _data->frameRate << _data->boundary2i
        << _data->resistance2i << _data->tilesize << _data->mode
-       << _data->frozen;
+       << _data->frozen << _data->predictive;
 }
 
 void Equalizer::deserialize( co::DataIStream& is )
@@ -231,7 +244,7 @@ void Equalizer::deserialize( co::DataIStream& is )
     is >> _data->damping >> _data->boundaryf >> _data->resistancef
        >> _data->assembleOnlyLimit >> _data->frameRate >> _data->boundary2i
        >> _data->resistance2i >> _data->tilesize >> _data->mode
-       >> _data->frozen;
+       >> _data->frozen >> _data->predictive;
 }
 
 void Equalizer::backup()
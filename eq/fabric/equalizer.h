@@ -119,6 +119,18 @@ public:
 
     /** @return the tile size for the TileEqualizer. */
     EQFABRIC_API const Vector2i& getTileSize() const;
+
+    /**
+     * Enable model-based split computation for the LoadEqualizer.
+     *
+     * A predictive load equalizer fits a cost model to each resource and
+     * solves the split for equal predicted times, instead of moving the split
+     * towards the last measured times.
+     */
+    EQFABRIC_API void setPredictive( const bool onOff );
+
+    /** @return true if the LoadEqualizer uses cost models. */
+    EQFABRIC_API bool isPredictive() const;
     //@}
 
     EQFABRIC_API void serialize( co::DataOStream& os ) const; //!< @internal
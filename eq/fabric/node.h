@@ -82,6 +82,10 @@ public:
         IATTR_THREAD_MODEL,
         IATTR_LAUNCH_TIMEOUT, //!< Timeout when auto-launching the node
         IATTR_HINT_AFFINITY,
+        /** Number of image transmit threads (AUTO: one per pipe) */
+        IATTR_HINT_TRANSMIT_THREADS,
+        /** Number of tiles prefetched per tile queue request (AUTO) */
+        IATTR_HINT_TILE_PREFETCH,
         IATTR_LAST,
         IATTR_ALL = IATTR_LAST + 5
     };
@@ -18,6 +18,10 @@
 #include "renderContext.h"
 #include "tile.h"
 
+#include <co/dataIStream.h>
+#include <co/dataOStream.h>
+#include <cstring>
+
 namespace eq
 {
 namespace fabric
@@ -49,6 +53,111 @@ void RenderContext::apply( const Tile& tile, const bool local )
     }
 }
 
+namespace
+{
+/** Call the functor for all transmitted fields of two contexts, in order. */
+template< class C, class F >
+void _forEach( C& context, const RenderContext& other, F& func )
+{
+    func( context.frustum, other.frustum );
+    func( context.ortho, other.ortho );
+    func( context.headTransform, other.headTransform );
+    func( context.orthoTransform, other.orthoTransform );
+    func( context.view, other.view );
+    func( context.frameID, other.frameID );
+    func( context.pvp, other.pvp );
+    func( context.pixel, other.pixel );
+    func( context.overdraw, other.overdraw );
+    func( context.vp, other.vp );
+    func( context.offset, other.offset );
+    func( context.range, other.range );
+    func( context.subPixel, other.subPixel );
+    func( context.zoom, other.zoom );
+    func( context.buffer, other.buffer );
+    func( context.taskID, other.taskID );
+    func( context.period, other.period );
+    func( context.phase, other.phase );
+    func( context.eye, other.eye );
+    func( context.bufferMask, other.bufferMask );
+}
+
+class DirtyFields
+{
+public:
+    explicit DirtyFields( const bool full )
+        : mask( full ? 0xffffffffu : 0 ), _bit( 1 ) {}
+
+    template< class T > void operator()( const T& value, const T& last )
+    {
+        if( ::memcmp( &value, &last, sizeof( T )) != 0 )
+            mask |= _bit;
+        _bit <<= 1;
+    }
+
+    uint32_t mask;
+
+private:
+    uint32_t _bit;
+};
+
+class FieldWriter
+{
+public:
+    FieldWriter( co::DataOStream& os, const uint32_t mask )
+        : _os( os ), _mask( mask ), _bit( 1 ) {}
+
+    template< class T > void operator()( const T& value, const T& )
+    {
+        if( _mask & _bit )
+            _os << value;
+        _bit <<= 1;
+    }
+
+private:
+    co::DataOStream& _os;
+    const uint32_t _mask;
+    uint32_t _bit;
+};
+
+class FieldReader
+{
+public:
+    FieldReader( co::DataIStream& is, const uint32_t mask )
+        : _is( is ), _mask( mask ), _bit( 1 ) {}
+
+    template< class T > void operator()( T& value, const T& )
+    {
+        if( _mask & _bit )
+            _is >> value;
+        _bit <<= 1;
+    }
+
+private:
+    co::DataIStream& _is;
+    const uint32_t _mask;
+    uint32_t _bit;
+};
+}
+
+void RenderContext::serializeDelta( co::DataOStream& os, RenderContext& last,
+                                    const bool full ) const
+{
+    DirtyFields dirty( full );
+    _forEach( *this, last, dirty );
+
+    FieldWriter writer( os, dirty.mask );
+    os << dirty.mask;
+    _forEach( *this, last, writer );
+    last = *this;
+}
+
+void RenderContext::deserializeDelta( co::DataIStream& is )
+{
+    const uint32_t mask = is.read< uint32_t >();
+    FieldReader reader( is, mask );
+    _forEach( *this, *this, reader );
+}
+
 std::ostream& operator << ( std::ostream& os, const RenderContext& ctx )
 {
     return os << "ID " << ctx.frameID << " pvp " << ctx.pvp << " vp " << ctx.vp
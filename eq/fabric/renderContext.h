@@ -27,6 +27,7 @@
 #include <eq/fabric/vmmlib.h>
 #include <eq/fabric/zoom.h>             // member
 #include <co/objectVersion.h>
+#include <co/types.h>
 #include <eq/fabric/api.h>
 
 namespace eq
@@ -40,6 +41,23 @@ public:
     EQFABRIC_API RenderContext();
     EQFABRIC_API void apply( const Tile& tile, bool local ); //!< @internal
 
+    /**
+     * @internal Write the fields which differ from the last context written to
+     * the receiver, and update the last context.
+     *
+     * @param os the output stream.
+     * @param last the last context written, updated to this context.
+     * @param full write all fields, e.g., for the first context.
+     */
+    EQFABRIC_API void serializeDelta( co::DataOStream& os, RenderContext& last,
+                                      bool full ) const;
+
+    /**
+     * @internal Update this last received context with the fields written by
+     * serializeDelta().
+     */
+    EQFABRIC_API void deserializeDelta( co::DataIStream& is );
+
     Frustumf       frustum;        //!< frustum for projection matrix
     Frustumf       ortho;          //!< ortho frustum for projection matrix
 
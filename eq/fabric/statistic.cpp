@@ -84,6 +84,14 @@ static StatisticData _statisticData[] =
    "finish frame", Vector3f( .5f, .5f, .5f ) },
  { Statistic::CONFIG_WAIT_FINISH_FRAME,
    "wait finish",  Vector3f( 1.0f, 0.f, 0.f ) },
+ { Statistic::CONFIG_SERVER_FRAME,
+   "server frame", Vector3f( 0.f, .5f, 1.0f ) },
+ { Statistic::CHANNEL_ROI,
+   "ROI",          Vector3f( 1.0f, .7f, .3f ) },
+ { Statistic::CHANNEL_DUMP_IMAGE,
+   "dump image",   Vector3f( .5f, 0.f, 1.0f ) },
+ { Statistic::CHANNEL_TILES,
+   "tiles",        Vector3f( .5f, .5f, 1.f ) },
  { Statistic::ALL,
    "ALL EVENTS",   Vector3f( 0.0f, 0.f, 0.f ) }} ;
 }
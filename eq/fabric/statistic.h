@@ -50,7 +50,11 @@ struct Statistic
         CHANNEL_READBACK, //!< Sampling of Channel::frameReadback
         CHANNEL_ASYNC_READBACK, //!< Sampling of async readback
         CHANNEL_VIEW_FINISH, //!< Sampling of Channel::frameViewFinish
-        CHANNEL_FRAME_TRANSMIT, //!< Sampling of frame transmission
+        /**
+         * Sampling of frame transmission, plugins[0] is the number of images
+         * and plugins[1] the number of send calls, including command headers
+         */
+        CHANNEL_FRAME_TRANSMIT,
         CHANNEL_FRAME_COMPRESS, //!< Sampling of frame compression
         /** Sampling of waiting for a send token from the receiver */
         CHANNEL_FRAME_WAIT_SENDTOKEN,
@@ -66,18 +70,38 @@ struct Statistic
         CONFIG_FINISH_FRAME, //!< Sampling of Config::finishFrame
         /** Sampling of synchronization time during Config::finishFrame */
         CONFIG_WAIT_FINISH_FRAME,
+        /**
+         * Sampling of the task generation of a frame on the server, plugins[0]
+         * is the number of updated nodes and plugins[1] the bytes sent. Only
+         * sent if the config's IATTR_HINT_STATISTICS is not OFF.
+         */
+        CONFIG_SERVER_FRAME,
+        /**
+         * Sampling of the output image trimming, ratio is the area reused and
+         * plugins[0] the number of regions found in all trimmed images
+         */
+        CHANNEL_ROI,
+        /**
+         * Sampling of queueing an image dump, plugins[0] is the queue depth,
+         * plugins[1] the number of dropped images and totalTime the average
+         * write latency of the images written since the last sample
+         */
+        CHANNEL_DUMP_IMAGE,
+        CHANNEL_TILES, //!< Sampling of the tile loop, plugins[0] is #tiles
         ALL          // must be last
     };
 
     Type type; //!< The type of statistic
     uint32_t frameNumber; //!< The frame during when the sampling happened
     uint32_t task; //!< @internal
-    uint32_t plugins[2]; //!< color,depth plugins (readback, compression)
+    /** color,depth plugins (readback, compression), or see Type */
+    uint32_t plugins[2];
 
     int64_t  startTime; //!< Absolute start time of the operation
     int64_t  endTime;    //!< Absolute end time of the operation
     int64_t  idleTime;  //!< Absolute idle time of PIPE_IDLE
-    int64_t  totalTime;  //!< Total time of a pipe frame (PIPE_IDLE)
+    /** Total time of a pipe frame (PIPE_IDLE), latency (CHANNEL_DUMP_IMAGE) */
+    int64_t  totalTime;
 
     float    ratio; //!< compression ratio (transfer, compression)
     float    currentFPS; //!< FPS of last frame (WINDOW_FPS)
@@ -92,7 +92,10 @@ public:
     /** Set the minimum quality after compression. @version 1.0 */
     EQ_API void setQuality( const Buffer buffer, const float quality );
 
-    /** Sets a compressor for compression for following transmissions. */
+    /**
+     * Sets a compressor for compression for following transmissions.
+     * @sa FrameData::useCompressor()
+     */
     EQ_API void useCompressor( const Buffer buffer, const uint32_t name );
     //@}
 
@@ -22,6 +22,7 @@
 
 #include "nodeStatistics.h"
 #include "channelStatistics.h"
+#include "detail/compressorSelector.h"
 #include "exception.h"
 #include "image.h"
 #include "log.h"
@@ -35,6 +36,7 @@
 #include <co/connectionDescription.h>
 #include <co/dataIStream.h>
 #include <co/dataOStream.h>
+#include <lunchbox/clock.h>
 #include <lunchbox/monitor.h>
 #include <lunchbox/scopedMutex.h>
 #include <pression/plugins/compressor.h>
@@ -147,6 +149,16 @@ void FrameData::useCompressor( const Frame::Buffer buffer, const uint32_t name )
     _impl->colorCompressor = name;
 }
 
+uint32_t FrameData::getCompressor( const Frame::Buffer buffer ) const
+{
+    if( buffer != Frame::BUFFER_COLOR )
+    {
+        LBASSERT( buffer == Frame::BUFFER_DEPTH );
+        return _impl->depthCompressor;
+    }
+    return _impl->colorCompressor;
+}
+
 void FrameData::getInstanceData( co::DataOStream& os )
 {
     LBUNREACHABLE;
@@ -409,13 +421,40 @@ void FrameData::removeListener( Listener& listener )
 
 bool FrameData::addImage( const co::ObjectVersion& frameDataVersion,
                           const PixelViewport& pvp, const Zoom& zoom,
-                          const RenderContext& context, const uint32_t buffers_,
-                          const bool useAlpha, uint8_t* data )
+                          const RenderContext& context, const uint32_t buffers,
+                          const bool useAlpha, uint8_t* data,
+                          const co::ICommand& command )
+{
+    LBASSERT( _impl->readyVersion < frameDataVersion.version.low( ));
+    if( _impl->readyVersion >= frameDataVersion.version.low( ))
+        return false;
+
+    _addImage( pvp, zoom, context, buffers, useAlpha, data, command );
+    return true;
+}
+
+bool FrameData::addImages( const co::ObjectVersion& frameDataVersion,
+                           const ImageInfos& infos, uint8_t* data,
+                           const co::ICommand& command )
 {
     LBASSERT( _impl->readyVersion < frameDataVersion.version.low( ));
     if( _impl->readyVersion >= frameDataVersion.version.low( ))
         return false;
 
+    BOOST_FOREACH( const ImageInfo& info, infos )
+    {
+        LBASSERT( info.pvp.isValid( ));
+        data = _addImage( info.pvp, info.zoom, info.context, info.buffers,
+                          info.useAlpha != 0, data, command );
+    }
+    return true;
+}
+
+uint8_t* FrameData::_addImage( const PixelViewport& pvp, const Zoom& zoom,
+                               const RenderContext& context,
+                               const uint32_t buffers_, const bool useAlpha,
+                               uint8_t* data, const co::ICommand& command )
+{
     Image* image = _allocImage( Frame::TYPE_MEMORY, DrawableConfig(),
                                 false /* set quality */ );
 
@@ -470,12 +509,18 @@ bool FrameData::addImage( const co::ObjectVersion& frameDataVersion,
             image->setZoom( zoom );
             image->setContext( context );
             image->setQuality( buffer, header->quality );
-            image->setPixelData( buffer, pixelData );
+
+            const lunchbox::Clock clock;
+            image->setPixelData( buffer, pixelData, command );
+            if( compressor > EQ_COMPRESSOR_NONE )
+                detail::CompressorSelector::getInstance().addDecompress(
+                    compressor, image->getPixelDataSize( buffer ),
+                    clock.getTimef( ));
         }
     }
 
     _impl->pendingImages.push_back( image );
-    return true;
+    return data;
 }
 
 std::ostream& operator << ( std::ostream& os, const FrameData& data )
@@ -27,6 +27,13 @@
 #include <lunchbox/monitor.h>        // member
 #include <lunchbox/spinLock.h>       // member
 
+/**
+ * Compressor hint for adaptive compressor selection, see
+ * FrameData::useCompressor(). Outside of the range of plugin names.
+ * @version 1.13
+ */
+#define EQ_COMPRESSOR_ADAPTIVE 0xfffffffeu
+
 namespace eq
 {
 namespace detail { class FrameData; }
@@ -63,6 +70,17 @@ public:
         float                   quality;
     };
 
+    /** @internal Per-image parameters of a batched image transmission. */
+    struct ImageInfo
+    {
+        fabric::PixelViewport   pvp;
+        fabric::Zoom            zoom;
+        RenderContext           context;
+        uint32_t                buffers;
+        uint32_t                useAlpha;
+    };
+    typedef std::vector< ImageInfo > ImageInfos; //!< @internal
+
     /** Construct a new frame data holder. @version 1.0 */
     EQ_API FrameData();
 
@@ -99,12 +117,19 @@ public:
      * the image buffer. The default compressor is EQ_COMPRESSOR_AUTO which
      * selects the most suitable compressor wrt the current image and buffer
      * parameters.
-     * @sa _chooseCompressor()
+     *
+     * EQ_COMPRESSOR_ADAPTIVE selects, for each frame, the compressor or no
+     * compression with the smallest estimated transfer time, based on the
+     * measured bandwidth to the receivers and the measured compressor
+     * performance.
      *
      * @param buffer the frame buffer attachment.
      * @param name the compressor name.
      */
     void useCompressor( const Frame::Buffer buffer, const uint32_t name );
+
+    /** @return the compressor set for the given buffer. @version 1.13 */
+    uint32_t getCompressor( const Frame::Buffer buffer ) const;
     //@}
 
     /** @name Operations */
@@ -195,11 +220,26 @@ public:
     void removeListener( Listener& listener );
     //@}
 
-    /** @internal */
+    /**
+     * @internal
+     * Add a received image. Uncompressed pixels are used in place and keep the
+     * command alive.
+     */
     bool addImage( const co::ObjectVersion& frameDataVersion,
                    const PixelViewport& pvp, const Zoom& zoom,
                    const RenderContext& context, const uint32_t buffers,
-                   const bool useAlpha, uint8_t* data );
+                   const bool useAlpha, uint8_t* data,
+                   const co::ICommand& command );
+
+    /**
+     * @internal
+     * Add all images of a batched transmission, with the pixel data of all
+     * images concatenated in data.
+     */
+    bool addImages( const co::ObjectVersion& frameDataVersion,
+                    const ImageInfos& infos, uint8_t* data,
+                    const co::ICommand& command );
+
     void setReady( const co::ObjectVersion& frameData,
                    const fabric::FrameData& data ); //!< @internal
 
@@ -216,6 +256,12 @@ private:
                         const DrawableConfig& config,
                         const bool setQuality );
 
+    /** Add one received image, @return the end of its pixel data. */
+    uint8_t* _addImage( const PixelViewport& pvp, const Zoom& zoom,
+                        const RenderContext& context, const uint32_t buffers,
+                        const bool useAlpha, uint8_t* data,
+                        const co::ICommand& command );
+
     /** Apply all received images of the given version. */
     void _applyVersion( const uint128_t& version );
 
@@ -42,6 +42,7 @@
 //
 
 #include "half.h"
+#include "detail/compositorKernels.h"
 
 // Load immediate
 static inline uint32_t _uint32_li( uint32_t a )
@@ -719,3 +720,15 @@ half_mul( uint16_t x, uint16_t y )
 
   return (uint16_t)(c_result);
 }
+
+void
+half_to_float_array( float* dst, const uint16_t* src, size_t n )
+{
+  eq::detail::getCompositorKernels().halfToFloat( dst, src, n );
+}
+
+void
+half_from_float_array( uint16_t* dst, const float* src, size_t n )
+{
+  eq::detail::getCompositorKernels().floatToHalf( dst, src, n );
+}
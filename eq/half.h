@@ -8,6 +8,11 @@ uint16_t half_from_float( float f );
 uint16_t half_add( uint16_t arg0, uint16_t arg1 );
 uint16_t half_mul( uint16_t arg0, uint16_t arg1 );
 
+// Array conversions using the instruction set of the CPU compositor. They
+// round to nearest even, unlike half_from_float which rounds half up.
+void half_to_float_array( float* dst, const uint16_t* src, size_t n );
+void half_from_float_array( uint16_t* dst, const float* src, size_t n );
+
 static inline uint16_t
 half_sub( uint16_t ha, uint16_t hb )
 {
@@ -20,6 +20,7 @@
 
 #include "image.h"
 
+#include "frameData.h" // EQ_COMPRESSOR_ADAPTIVE
 #include "gl.h"
 #include "half.h"
 #include "log.h"
@@ -31,10 +32,14 @@
 #include <eq/fabric/renderContext.h>
 
 #include <co/global.h>
+#include <co/iCommand.h>
 
 #include <lunchbox/buffer.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/lock.h>
 #include <lunchbox/memoryMap.h>
 #include <lunchbox/omp.h>
+#include <lunchbox/scopedMutex.h>
 #include <pression/compressor.h>
 #include <pression/decompressor.h>
 #include <pression/downloader.h>
@@ -74,6 +79,7 @@ public:
         PixelData::reset();
         state = INVALID;
         localBuffer.clear();
+        command = co::ICommand();
         hasAlpha = true;
     }
 
@@ -84,10 +90,27 @@ public:
         LBASSERT( pixelSize > 0 );
         LBASSERT( pvp.hasArea( ));
 
+        command = co::ICommand();
         localBuffer.resize( pvp.getArea() * pixelSize );
         pixels = localBuffer.getData();
     }
 
+    void useCommandBuffer( void* data, const co::ICommand& owner )
+    {
+        command = owner;
+        pixels = data;
+    }
+
+    /** Drop pixels referencing a received command before they are replaced. */
+    void releaseCommandBuffer()
+    {
+        if( !command.isValid( ))
+            return;
+        command = co::ICommand();
+        pixels = 0;
+        state = INVALID;
+    }
+
     enum State
     {
         INVALID,
@@ -102,6 +125,9 @@ public:
      * allocates the memory. */
     lunchbox::Bufferb localBuffer;
 
+    /** The received command holding the pixels if they are used in place. */
+    co::ICommand command;
+
     bool hasAlpha; //!< The uncompressed pixels contain alpha
 };
 
@@ -130,6 +156,9 @@ struct Attachment
 
     Zoom zoom; //!< zoom factor of pending readback
 
+    /** Serializes compression from concurrent transmit threads. */
+    lunchbox::Lock compressLock;
+
     Attachment()
         : active( PLUGIN_FULL )
         , quality( 1.f )
@@ -257,6 +286,9 @@ void Image::reset()
 {
     _impl->ignoreAlpha = false;
     _impl->hasPremultipliedAlpha = false;
+    // reused images shall not keep the receive buffers alive
+    _impl->color.memory.releaseCommandBuffer();
+    _impl->depth.memory.releaseCommandBuffer();
     setPixelViewport( PixelViewport( ));
     setContext( RenderContext( ));
 }
@@ -598,6 +630,7 @@ bool Image::startReadback( const Frame::Buffer buffer,
     const bool alpha = (info.capabilities & EQ_COMPRESSOR_IGNORE_ALPHA) == 0;
     _setExternalFormat( buffer, info.outputTokenType, info.outputTokenSize,
                         alpha );
+    memory.releaseCommandBuffer();
     attachment.memory.state = Memory::DOWNLOAD;
 
     if( !memory.hasAlpha )
@@ -848,8 +881,15 @@ void Image::validatePixelData( const Frame::Buffer buffer )
 }
 
 void Image::setPixelData( const Frame::Buffer buffer, const PixelData& pixels )
+{
+    setPixelData( buffer, pixels, co::ICommand( ));
+}
+
+void Image::setPixelData( const Frame::Buffer buffer, const PixelData& pixels,
+                          const co::ICommand& owner )
 {
     Memory& memory = _impl->getMemory( buffer );
+    memory.releaseCommandBuffer();
     memory.externalFormat = pixels.externalFormat;
     memory.internalFormat = pixels.internalFormat;
     memory.pixelSize = pixels.pixelSize;
@@ -885,6 +925,14 @@ void Image::setPixelData( const Frame::Buffer buffer, const PixelData& pixels )
 
     if( pixels.compressedData.compressor <= EQ_COMPRESSOR_NONE )
     {
+        if( pixels.pixels && owner.isValid( ))
+        {
+            // use the received data in place, the command keeps it alive
+            memory.useCommandBuffer( pixels.pixels, owner );
+            memory.state = Memory::VALID;
+            return;
+        }
+
         validatePixelData( buffer ); // alloc memory for pixels
 
         if( pixels.pixels )
@@ -1000,11 +1048,23 @@ void Image::useCompressor( const Frame::Buffer buffer, const uint32_t name )
 }
 
 const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
+{
+    float time;
+    return compressPixelData( buffer, time );
+}
+
+const PixelData& Image::compressPixelData( const Frame::Buffer buffer,
+                                           float& time )
 {
     LBASSERT( getPixelDataSize( buffer ) > 0 );
+    time = 0.f;
 
     Attachment& attachment = _impl->getAttachment( buffer );
+    lunchbox::ScopedMutex<> mutex( attachment.compressLock );
     Memory& memory = attachment.memory;
+    if( memory.compressorName == EQ_COMPRESSOR_ADAPTIVE ) // not resolved
+        memory.compressorName = EQ_COMPRESSOR_AUTO;
+
     if( memory.compressedData.isCompressed() ||
         memory.compressorName == EQ_COMPRESSOR_NONE )
     {
@@ -1016,7 +1076,8 @@ const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
 
     if( !compressor.isGood() ||
         compressor.getInfo().tokenType != getExternalFormat( buffer ) ||
-        memory.compressorName == EQ_COMPRESSOR_AUTO )
+        memory.compressorName == EQ_COMPRESSOR_AUTO ||
+        compressor.getInfo().name != memory.compressorName )
     {
         if( memory.compressorName == EQ_COMPRESSOR_AUTO )
         {
@@ -1055,8 +1116,10 @@ const PixelData& Image::compressPixelData( const Frame::Buffer buffer )
 
     uint64_t inDims[4];
     memory.pvp.convertToPlugin( inDims );
+    const lunchbox::Clock clock;
     compressor.compress( memory.pixels, inDims, memory.compressorFlags );
     memory.compressedData = compressor.getResult();
+    time = clock.getTimef();
     return memory;
 }
 
@@ -1129,20 +1192,6 @@ struct RGBHeader
   __attribute__((packed))
 #endif
 ;
-
-void put32f( std::ostream& os, const char* ptr )
-{
-    // cppcheck-suppress invalidPointerCast
-    const float& value = *reinterpret_cast< const float* >( ptr );
-    const uint8_t byte = uint8_t( value * 255.f );
-    os.write( (const char*)&byte, 1 );
-}
-void put16f( std::ostream& os, const char* ptr )
-{
-    const uint16_t& value = *reinterpret_cast< const uint16_t* >(ptr);
-    const float f = half_to_float( value );
-    put32f( os, (const char*)&f );
-}
 }
 
 bool Image::writeImage( const std::string& filename,
@@ -1298,7 +1347,6 @@ bool Image::_writeImage( const std::string& filename,
         return false;
     }
 
-    const size_t nBytes = nPixels * depth;
     if( header.bytesPerChannel > 2 )
         LBWARN << static_cast< int >( header.bytesPerChannel )
                << " bytes per channel not supported by RGB spec" << std::endl;
@@ -1310,39 +1358,21 @@ bool Image::_writeImage( const std::string& filename,
 
     const char* data = reinterpret_cast< const char* >( data_ );
 
-    // Each channel is saved separately
-    if( nChannels == 3 || nChannels == 4 )
+    // Each channel is saved separately, R or B first
+    size_t channels[4] = { 2, 1, 0, 3 };
+    if( swapRB || ( nChannels != 3 && nChannels != 4 ))
     {
-        // channel one is R or B
-        if ( swapRB )
-            for( size_t j = 0 * bpc; j < nBytes; j += depth )
-                image.write( &data[j], bpc );
-        else
-            for( size_t j = 2 * bpc; j < nBytes; j += depth )
-                image.write( &data[j], bpc );
-
-        // channel two is G
-        for( size_t j = 1 * bpc; j < nBytes; j += depth )
-            image.write( &data[j], bpc );
-
-        // channel three is B or G
-        if ( swapRB )
-            for( size_t j = 2 * bpc; j < nBytes; j += depth )
-                image.write( &data[j], bpc );
-        else
-            for( size_t j = 0; j < nBytes; j += depth )
-                image.write( &data[j], bpc );
-
-        // channel four is Alpha
-        if( nChannels == 4 )
-            for( size_t j = 3 * bpc; j < nBytes; j += depth )
-                image.write( &data[j], bpc );
+        channels[0] = 0;
+        channels[2] = 2;
     }
-    else
+
+    std::vector< char > plane( nPixels * bpc );
+    for( size_t i = 0; i < nChannels; ++i )
     {
-        for( size_t i = 0; i < nChannels; i += bpc )
-           for( size_t j = i * bpc; j < nBytes; j += depth )
-              image.write(&data[j], bpc );
+        const char* src = data + channels[i] * bpc;
+        for( size_t j = 0; j < nPixels; ++j )
+            ::memcpy( &plane[ j * bpc ], src + j * depth, bpc );
+        image.write( plane.data(), plane.size( ));
     }
     image.close();
 
@@ -1370,40 +1400,25 @@ bool Image::_writeImage( const std::string& filename,
     header.convert();
 
     LBASSERTINFO( bpc == 2 || bpc == 4, bpc );
-    const bool twoBPC = bpc == 2;
-
-    if( nChannels == 3 || nChannels == 4 )
+    const size_t nValues = nPixels * nChannels;
+    std::vector< float > converted;
+    const float* values = reinterpret_cast< const float* >( data );
+    if( bpc == 2 )
     {
-        // channel one is R or B
-        if ( swapRB )
-            for( size_t j = 0 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
-        else
-            for( size_t j = 2 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
-
-        // channel two is G
-        for( size_t j = 1 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
-
-        // channel three is B or G
-        if ( swapRB )
-            for( size_t j = 2 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
-        else
-            for( size_t j = 0; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
-
-         // channel four is Alpha
-        if( nChannels == 4 )
-            for( size_t j = 3 * bpc; j < nBytes; j += depth )
-                twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
+        converted.resize( nValues );
+        half_to_float_array( converted.data(),
+                             reinterpret_cast< const uint16_t* >( data ),
+                             nValues );
+        values = converted.data();
     }
-    else
+
+    plane.resize( nPixels );
+    for( size_t i = 0; i < nChannels; ++i )
     {
-        for( size_t i = 0; i < nChannels; i += bpc )
-           for( size_t j = i * bpc; j < nBytes; j += depth )
-               twoBPC ? put16f( image, &data[j] ) : put32f( image, &data[j] );
+        const float* src = values + channels[i];
+        for( size_t j = 0; j < nPixels; ++j )
+            plane[j] = char( uint8_t( src[ j * nChannels ] * 255.f ));
+        image.write( plane.data(), plane.size( ));
     }
     image.close();
 
@@ -191,9 +191,24 @@ public:
     /** @return the pixel data. @version 1.0 */
     EQ_API const PixelData& getPixelData( const Frame::Buffer ) const;
 
-    /** @return the pixel data, compressing it if needed. @version 1.0 */
+    /**
+     * @return the pixel data, compressing it if needed. Concurrent calls for
+     *         the same buffer compress only once. @version 1.0
+     */
     EQ_API const PixelData& compressPixelData( const Frame::Buffer );
 
+    /**
+     * @internal
+     * Compress the pixel data if needed.
+     *
+     * @param buffer the buffer to compress.
+     * @param time set to the compression time in ms, or to 0 if this call did
+     *             not compress the data.
+     * @return the pixel data.
+     */
+    EQ_API const PixelData& compressPixelData( const Frame::Buffer buffer,
+                                               float& time );
+
     /**
      * @return true if the image has valid pixel data for the buffer.
      * @version 1.0
@@ -241,6 +256,23 @@ public:
     EQ_API void setPixelData( const Frame::Buffer buffer,
                               const PixelData& data );
 
+    /**
+     * Set the pixel data of the given image buffer from a received command.
+     *
+     * Uncompressed pixel data is used in place instead of being copied. The
+     * image retains the command, which keeps the data valid until the buffer
+     * gets new pixel data, is read back or the image is flushed. The pixel
+     * data of such a buffer must not be modified. Compressed data is
+     * decompressed as in setPixelData() above.
+     *
+     * @param buffer the image buffer to set.
+     * @param data the pixel data, pointing into the command.
+     * @param owner the command holding the pixel data.
+     * @version 1.13
+     */
+    EQ_API void setPixelData( const Frame::Buffer buffer, const PixelData& data,
+                              const co::ICommand& owner );
+
     /**
      * Set alpha data preservation during download and compression.
      * @version 1.0
@@ -40,8 +40,11 @@
 #include <co/connection.h>
 #include <co/global.h>
 #include <co/objectICommand.h>
+#include <co/queueSlave.h>
 #include <lunchbox/scopedMutex.h>
 
+#include <boost/foreach.hpp>
+
 namespace eq
 {
 namespace
@@ -51,6 +54,17 @@ typedef stde::hash_map< uint128_t, FrameDataPtr > FrameDataHash;
 typedef FrameDataHash::const_iterator FrameDataHashCIter;
 typedef FrameDataHash::iterator FrameDataHashIter;
 
+/** A tile queue slave shared by all pipes of a node. */
+struct TileQueue
+{
+    TileQueue( const uint32_t prefetchMark, const uint32_t prefetchAmount )
+        : slave( prefetchMark, prefetchAmount ) {}
+
+    co::QueueSlave slave;
+    lunchbox::Lock lock; //!< serializes pop
+};
+typedef stde::hash_map< uint128_t, TileQueue* > TileQueueHash;
+
 enum State
 {
     STATE_STOPPED,
@@ -66,19 +80,85 @@ namespace detail
 class TransmitThread : public lunchbox::Thread
 {
 public:
-    TransmitThread()
+    TransmitThread( const size_t index, const int32_t affinity )
         : _queue( co::Global::getCommandQueueLimit( ))
+        , _index( index )
+        , _affinity( affinity )
     {}
     virtual ~TransmitThread() {}
 
     co::CommandQueue& getQueue() { return _queue; }
 
 protected:
-    bool init() override { setName( "Xmit" ); return true; }
+    bool init() override
+    {
+        setName( _index == 0 ? std::string( "Xmit" ) :
+                               "Xmit" + std::to_string( _index ));
+        if( _affinity != OFF && _affinity != AUTO ) // see Node::_setAffinity
+            lunchbox::Thread::setAffinity( _affinity );
+        return true;
+    }
     void run() override;
 
 private:
     co::CommandQueue _queue;
+    const size_t _index;
+    const int32_t _affinity;
+};
+
+/**
+ * Distributes the image transmit commands of all channels to a pool of
+ * transmit threads.
+ *
+ * All commands for one receiver are executed by the same thread, which keeps
+ * their order on the receiver connection. Different receivers are assigned
+ * round-robin to the threads.
+ */
+class TransmitQueue : public co::CommandQueue
+{
+public:
+    TransmitQueue()
+        : co::CommandQueue( co::Global::getCommandQueueLimit( ))
+        , _next( 0 )
+    {}
+    virtual ~TransmitQueue() { LBASSERT( _threads.empty( )); }
+
+    /** Start the given number of threads using the node's affinity hint. */
+    void start( const size_t nThreads, const int32_t affinity )
+    {
+        LBASSERT( _threads.empty( ));
+        LBASSERT( nThreads > 0 );
+        for( size_t i = 0; i < nThreads; ++i )
+        {
+            _threads.push_back( new TransmitThread( i, affinity ));
+            _threads.back()->start();
+        }
+        LBLOG( LOG_INIT ) << "Started " << nThreads << " transmit threads"
+                          << std::endl;
+    }
+
+    void stop()
+    {
+        push( co::ICommand( )); // wake up to exit
+        BOOST_FOREACH( TransmitThread* thread, _threads )
+        {
+            thread->join();
+            delete thread;
+        }
+        _threads.clear();
+        _receivers.clear();
+        _next = 0;
+    }
+
+    void push( const co::ICommand& command ) override;
+    void pushFront( const co::ICommand& command ) override { push( command ); }
+
+private:
+    typedef stde::hash_map< co::NodeID, TransmitThread* > ReceiverHash;
+
+    std::vector< TransmitThread* > _threads;
+    ReceiverHash _receivers; // receiver thread only
+    size_t _next;
 };
 
 class Node
@@ -108,7 +188,10 @@ public:
     /** All frame datas used by the node during rendering. */
     lunchbox::Lockable< FrameDataHash > frameDatas;
 
-    TransmitThread transmitter;
+    /** All tile queues used by the node's channels. */
+    lunchbox::Lockable< TileQueueHash > tileQueues;
+
+    TransmitQueue transmitter;
 };
 
 }
@@ -136,7 +219,6 @@ void Node::attach( const uint128_t& id, const uint32_t instanceID )
 
     co::CommandQueue* queue = getMainThreadQueue();
     co::CommandQueue* commandQ = getCommandThreadQueue();
-    co::CommandQueue* transmitQ = getTransmitterQueue();
 
     registerCommand( fabric::CMD_NODE_CREATE_PIPE,
                      NodeFunc( this, &Node::_cmdCreatePipe ), queue );
@@ -144,8 +226,6 @@ void Node::attach( const uint128_t& id, const uint32_t instanceID )
                      NodeFunc( this, &Node::_cmdDestroyPipe ), queue );
     registerCommand( fabric::CMD_NODE_CONFIG_INIT,
                      NodeFunc( this, &Node::_cmdConfigInit ), queue );
-    registerCommand( fabric::CMD_NODE_SET_AFFINITY,
-                     NodeFunc( this, &Node::_cmdSetAffinity), transmitQ );
     registerCommand( fabric::CMD_NODE_CONFIG_EXIT,
                      NodeFunc( this, &Node::_cmdConfigExit ), queue );
     registerCommand( fabric::CMD_NODE_FRAME_START,
@@ -158,6 +238,9 @@ void Node::attach( const uint128_t& id, const uint32_t instanceID )
                      NodeFunc( this, &Node::_cmdFrameTasksFinish ), queue );
     registerCommand( fabric::CMD_NODE_FRAMEDATA_TRANSMIT,
                      NodeFunc( this, &Node::_cmdFrameDataTransmit ), commandQ );
+    registerCommand( fabric::CMD_NODE_FRAMEDATA_TRANSMIT_BATCH,
+                     NodeFunc( this, &Node::_cmdFrameDataTransmitBatch ),
+                     commandQ );
     registerCommand( fabric::CMD_NODE_FRAMEDATA_READY,
                      NodeFunc( this, &Node::_cmdFrameDataReady ), commandQ );
 }
@@ -195,7 +278,7 @@ co::CommandQueue* Node::getCommandThreadQueue()
 
 co::CommandQueue* Node::getTransmitterQueue()
 {
-    return &_impl->transmitter.getQueue();
+    return &_impl->transmitter;
 }
 
 uint32_t Node::getCurrentFrame() const
@@ -233,6 +316,49 @@ co::Barrier* Node::getBarrier( const co::ObjectVersion& barrier )
     return netBarrier;
 }
 
+co::ObjectICommand Node::popTile( const uint128_t& queueID,
+                                 const uint32_t timeout )
+{
+    TileQueue* queue = 0;
+    {
+        lunchbox::ScopedMutex<> mutex( _impl->tileQueues );
+        TileQueueHash::const_iterator i = _impl->tileQueues->find( queueID );
+        if( i != _impl->tileQueues->end( ))
+            queue = i->second;
+    }
+
+    if( !queue )
+    {
+        // Fetch the next batch of tiles when half of the last is used
+        const int32_t prefetch = getIAttribute( IATTR_HINT_TILE_PREFETCH );
+        const uint32_t amount = prefetch > 0 ? prefetch : LB_UNDEFINED_UINT32;
+        const uint32_t mark = prefetch > 0 ? ( prefetch + 1 ) / 2 :
+                                             LB_UNDEFINED_UINT32;
+
+        // map outside of the lock, it blocks until the master replies
+        TileQueue* newQueue = new TileQueue( mark, amount );
+        ClientPtr client = getClient();
+        LBCHECK( client->mapObject( &newQueue->slave, queueID ));
+
+        {
+            lunchbox::ScopedMutex<> mutex( _impl->tileQueues );
+            TileQueue*& entry = _impl->tileQueues.data[ queueID ];
+            if( !entry )
+                entry = newQueue;
+            queue = entry;
+        }
+
+        if( queue != newQueue ) // mapped concurrently by another pipe
+        {
+            client->unmapObject( &newQueue->slave );
+            delete newQueue;
+        }
+    }
+
+    lunchbox::ScopedMutex<> mutex( queue->lock );
+    return queue->slave.pop( timeout );
+}
+
 FrameDataPtr Node::getFrameData( const co::ObjectVersion& frameDataVersion )
 {
     lunchbox::ScopedWrite mutex( _impl->frameDatas );
@@ -303,14 +429,26 @@ void Node::_setAffinity()
             break;
 
         default:
-            co::LocalNodePtr node = getLocalNode();
-            send( node, fabric::CMD_NODE_SET_AFFINITY ) << affinity;
-
-            node->setAffinity( affinity );
+            // the transmit threads set their affinity on start
+            getLocalNode()->setAffinity( affinity );
             break;
     }
 }
 
+size_t Node::_getNumTransmitThreads() const
+{
+    const int32_t nThreads = getIAttribute( IATTR_HINT_TRANSMIT_THREADS );
+    switch( nThreads )
+    {
+        case AUTO:
+        case UNDEFINED:
+            return std::max( getPipes().size(), size_t( 1 ));
+
+        default:
+            return std::max( nThreads, 1 );
+    }
+}
+
 void Node::waitFrameStarted( const uint32_t frameNumber ) const
 {
     _impl->currentFrame.waitGE( frameNumber );
@@ -489,6 +627,17 @@ void Node::_flushObjects()
         }
         _impl->barriers->clear();
     }
+    {
+        lunchbox::ScopedMutex<> mutex( _impl->tileQueues );
+        for( TileQueueHash::const_iterator i = _impl->tileQueues->begin();
+             i != _impl->tileQueues->end(); ++i )
+        {
+            TileQueue* queue = i->second;
+            client->unmapObject( &queue->slave );
+            delete queue;
+        }
+        _impl->tileQueues->clear();
+    }
 
     lunchbox::ScopedMutex<> mutex( _impl->frameDatas );
     for( FrameDataHashCIter i = _impl->frameDatas->begin();
@@ -513,6 +662,37 @@ void detail::TransmitThread::run()
     }
 }
 
+void detail::TransmitQueue::push( const co::ICommand& command )
+{
+    if( !command.isValid( )) // exit all threads
+    {
+        BOOST_FOREACH( TransmitThread* thread, _threads )
+            thread->getQueue().push( command );
+        return;
+    }
+
+    LBASSERT( !_threads.empty( ));
+    if( _threads.empty( ))
+    {
+        LBWARN << "Dropping transmit command, no transmit thread running"
+               << std::endl;
+        return;
+    }
+
+    // All transmit commands start with the frame data version and the
+    // receiver's node and network node identifiers, see Channel::_asyncTransmit
+    // and Channel::_setReady. Peek at them using a copy of the command.
+    co::ObjectICommand peek( command );
+    peek.read< co::ObjectVersion >();
+    peek.read< uint128_t >();
+    const co::NodeID& netNodeID = peek.read< co::NodeID >();
+
+    TransmitThread*& thread = _receivers[ netNodeID ];
+    if( !thread )
+        thread = _threads[ _next++ % _threads.size() ];
+    thread->getQueue().push( command );
+}
+
 void Node::dirtyClientExit()
 {
     const Pipes& pipes = getPipes();
@@ -521,8 +701,7 @@ void Node::dirtyClientExit()
         Pipe* pipe = *i;
         pipe->cancelThread();
     }
-    getTransmitterQueue()->push( co::ICommand( )); // wake up to exit
-    _impl->transmitter.join();
+    _impl->transmitter.stop();
 }
 
 //---------------------------------------------------------------------------
@@ -587,9 +766,10 @@ bool Node::_cmdConfigInit( co::ICommand& cmd )
     _impl->currentFrame  = frameNumber;
     _impl->unlockedFrame = frameNumber;
     _impl->finishedFrame = frameNumber;
+    _impl->transmitter.start( _getNumTransmitThreads(),
+                              getIAttribute( IATTR_HINT_AFFINITY ));
     _setAffinity();
 
-    _impl->transmitter.start();
     const uint64_t result = configInit( initID );
 
     if( getIAttribute( IATTR_THREAD_MODEL ) == eq::UNDEFINED )
@@ -618,8 +798,7 @@ bool Node::_cmdConfigExit( co::ICommand& cmd )
     }
 
     _impl->state = configExit() ? STATE_STOPPED : STATE_FAILED;
-    getTransmitterQueue()->push( co::ICommand( )); // wake up to exit
-    _impl->transmitter.join();
+    _impl->transmitter.stop();
     _flushObjects();
 
     getConfig()->send( getLocalNode(),
@@ -736,9 +915,38 @@ bool Node::_cmdFrameDataTransmit( co::ICommand& cmd )
 
     // Note on the const_cast: since the PixelData structure stores non-const
     // pointers, we have to go non-const at some point, even though we do not
-    // modify the data.
+    // modify the data. Uncompressed images reference the command buffer.
     LBCHECK( frameData->addImage( frameDataVersion, pvp, zoom, context, buffers,
-                                  useAlpha, const_cast< uint8_t* >( data )));
+                                  useAlpha, const_cast< uint8_t* >( data ),
+                                  cmd ));
+    return true;
+}
+
+bool Node::_cmdFrameDataTransmitBatch( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+
+    const co::ObjectVersion& frameDataVersion =
+                                            command.read< co::ObjectVersion >();
+    const uint32_t frameNumber = command.read< uint32_t >();
+    const FrameData::ImageInfos& infos =
+        command.read< FrameData::ImageInfos >();
+    const uint8_t* data = reinterpret_cast< const uint8_t* >(
+                command.getRemainingBuffer( command.getRemainingBufferSize( )));
+
+    LBLOG( LOG_ASSEMBLY )
+        << "received " << infos.size() << " images for " << frameDataVersion
+        << std::endl;
+
+    FrameDataPtr frameData = getFrameData( frameDataVersion );
+    LBASSERT( !frameData->isReady() );
+
+    NodeStatistics event( Statistic::NODE_FRAME_DECOMPRESS, this,
+                          frameNumber );
+
+    // see _cmdFrameDataTransmit for the const_cast
+    LBCHECK( frameData->addImages( frameDataVersion, infos,
+                                   const_cast< uint8_t* >( data ), cmd ));
     return true;
 }
 
@@ -760,14 +968,6 @@ bool Node::_cmdFrameDataReady( co::ICommand& cmd )
     LBASSERT( frameData->isReady() );
     return true;
 }
-
-bool Node::_cmdSetAffinity( co::ICommand& cmd )
-{
-    co::ObjectICommand command( cmd );
-
-    lunchbox::Thread::setAffinity( command.read< int32_t >( ));
-    return true;
-}
 }
 
 #include <eq/fabric/node.ipp>
@@ -88,6 +88,21 @@ public:
     /** @internal Release the frame data instance. */
     void releaseFrameData( FrameDataPtr data );
 
+    /**
+     * @internal
+     * Pop the next tile from a tile queue.
+     *
+     * All pipes of the node share one prefetching queue slave per tile queue,
+     * so that tiles fetched by one pipe are processed by any idle pipe.
+     * Thread-safe.
+     *
+     * @param queueID the identifier of the tile queue master.
+     * @param timeout the time to wait for the next tile in ms.
+     * @return the tile command, or an invalid command if the queue is empty.
+     */
+    co::ObjectICommand popTile( const uint128_t& queueID,
+                                const uint32_t timeout );
+
     /** @internal Wait for the node to be initialized. */
     EQ_API void waitInitialized() const;
 
@@ -265,6 +280,9 @@ private:
 
     void _setAffinity();
 
+    /** @return the size of the transmit thread pool. */
+    size_t _getNumTransmitThreads() const;
+
     void _finishFrame( const uint32_t frameNumber ) const;
     void _frameFinish( const uint128_t& frameID,
                        const uint32_t frameNumber );
@@ -281,8 +299,8 @@ private:
     bool _cmdFrameDrawFinish( co::ICommand& command );
     bool _cmdFrameTasksFinish( co::ICommand& command );
     bool _cmdFrameDataTransmit( co::ICommand& command );
+    bool _cmdFrameDataTransmitBatch( co::ICommand& command );
     bool _cmdFrameDataReady( co::ICommand& command );
-    bool _cmdSetAffinity( co::ICommand& command );
 
     LB_TS_VAR( _nodeThread );
 };
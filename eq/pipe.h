@@ -124,9 +124,6 @@ public:
     Frame* getFrame( const co::ObjectVersion& frameVersion,
                      const Eye eye, const bool output );
 
-    /** @internal @return the queue for the given identifier and version. */
-    co::QueueSlave* getQueue( const uint128_t& queueID );
-
     /** @internal Clear the frame cache and delete all frames. */
     void flushFrames( util::ObjectManager& om );
 
@@ -408,9 +405,6 @@ private:
     /** @internal Clear the view cache and release all views. */
     void _flushViews();
 
-    /** @internal Clear the queue cache and release all queues. */
-    void _flushQueues();
-
     /* The command functions. */
     bool _cmdCreateWindow( co::ICommand& command );
     bool _cmdDestroyWindow( co::ICommand& command );
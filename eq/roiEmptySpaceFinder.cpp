@@ -85,87 +85,6 @@ inline uint16_t ROIEmptySpaceFinder::_getArea( const int32_t w, const int32_t h,
 }
 
 
-bool ROIEmptySpaceFinder::_updateMaximalEmptyRegion(
-                                    const int32_t x, const int32_t y,
-                                    const int32_t w, const int32_t h,
-                                    PixelViewport& pvp,
-                                    const uint16_t* data ) const
-{
-    uint16_t maxArea = pvp.w * pvp.h;
-    bool updated = false;
-    int32_t maxW = 0;
-    int32_t maxH = 0;
-
-    // find biggest diagonal
-    int32_t cwh = 2;
-    while( cwh <= w && cwh <= h && _getArea( cwh, cwh, data ) == 0 )
-        cwh++;
-
-    cwh--;
-
-    if( cwh*cwh > maxArea )
-    {
-        maxArea = cwh*cwh;
-        maxW = cwh;
-        maxH = cwh;
-        updated = true;
-    }
-
-    // check parallelepipids
-    if( cwh * w > maxArea )
-    {
-        int32_t ch = cwh;
-        for( int32_t cw = cwh+1; cw <= w; cw++ )
-        {
-            while( _getArea( cw, ch, data ) != 0 )
-            {
-                ch--;
-                if( ch == 0 )
-                {
-                    cw = w + 1;
-                    break;
-                }
-            }
-            if( cw*ch > maxArea )
-            {
-                maxArea = cw*ch;
-                maxW = cw;
-                maxH = ch;
-                updated = true;
-            }
-        }
-    }
-
-    if( cwh * h > maxArea )
-    {
-        int32_t cw = cwh;
-        for( int32_t ch = cwh+1; ch <= h; ch++ )
-        {
-            while( _getArea( cw, ch, data ) != 0 )
-            {
-                cw--;
-                if( cw == 0 )
-                {
-                    ch = h + 1;
-                    break;
-                }
-            }
-            if( cw*ch > maxArea )
-            {
-                maxArea = cw*ch;
-                maxW = cw;
-                maxH = ch;
-                updated = true;
-            }
-        }
-    }
-
-    if( updated )
-        pvp = PixelViewport( x, y, maxW, maxH );
-
-    return updated;
-}
-
 PixelViewport ROIEmptySpaceFinder::getLargestEmptyArea(const PixelViewport& pvp)
 const
 {
@@ -193,36 +112,42 @@ const
     if( maxArea < _limAbs || maxArea < minRel )
         return res;
 
-    // search for biggest empty pvp
-    const uint16_t* data    = &_data[0] + pvp.y * _w;
-    const uint8_t*  m       = _mask     + pvp.y * _w;
+    // search for biggest empty pvp: the empty blocks ending in each row form a
+    // histogram of column heights, its largest rectangle is found in one pass
+    // using a stack of columns with increasing heights
+    _heights.assign( pvp.w, 0 );
+    _stack.clear();
+    _stack.reserve( pvp.w );
 
-    maxArea = 0;
+    const uint8_t* m = _mask + pvp.y * _w + pvp.x;
+    int32_t maxEmpty = 0;
 
-    for( int y=pvp.y, h=pvp.h; h > 0; y++, h-- )
+    for( int32_t y = 0; y < pvp.h; y++ )
     {
-        // skeep if found area bigger than the rest of image
-        if( h * pvp.w - _getArea( pvp.x, y, pvp.w, h ) <= maxArea )
-            break;
+        for( int32_t x = 0; x < pvp.w; x++ )
+            _heights[x] = m[x] == 0 ? _heights[x] + 1 : 0;
 
-        for( int x=pvp.x, w=pvp.w; w > 0; x++, w-- )
+        for( int32_t x = 0; x <= pvp.w; x++ )
         {
-            // skeep non empty blocks
-            if( m[x] != 0 )
-                continue;
-
-            // skeep if found area bigger than the rest of image
-            if( w*h - _getArea( w, h, data + x ) <= maxArea )
+            const int32_t height = x < pvp.w ? _heights[x] : 0;
+            while( !_stack.empty() && _heights[ _stack.back() ] >= height )
             {
-                w = 0;
-                continue;
-            }
+                const int32_t h = _heights[ _stack.back() ];
+                _stack.pop_back();
+                const int32_t left = _stack.empty() ? 0 : _stack.back() + 1;
+                const int32_t w = x - left;
 
-            if( _updateMaximalEmptyRegion( x, y, w, h, res, data + x ))
-                maxArea = res.w * res.h;
+                if( w * h > maxEmpty )
+                {
+                    maxEmpty = w * h;
+                    res = PixelViewport( pvp.x + left, pvp.y + y - h + 1,
+                                         w, h );
+                }
+            }
+            _stack.push_back( x );
         }
-        m    += _w;
-        data += _w;
+        _stack.clear();
+        m += _w;
     }
 
     const uint16_t curArea = res.w * res.h;
@@ -62,11 +62,6 @@ private:
     /** Updates dimensions, resizes data if needed */
     void _resize( const int32_t w, const int32_t h );
 
-    bool _updateMaximalEmptyRegion( const int32_t x, const int32_t y,
-                                    const int32_t w, const int32_t h,
-                                    PixelViewport& pvp,
-                                    const uint16_t* data ) const;
-
     int32_t _w;
     int32_t _h;
 
@@ -75,6 +70,9 @@ private:
 
     Vectorus _data;
     const uint8_t* _mask;
+
+    mutable std::vector< int32_t > _heights; //!< empty blocks per column
+    mutable std::vector< int32_t > _stack;   //!< columns of increasing height
 };
 }
 
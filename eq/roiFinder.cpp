@@ -29,12 +29,14 @@
 
 #include "gl.h"
 #include "log.h"
+#include "detail/compositorKernels.h"
 
 #include <eq/util/frameBufferObject.h>
 #include <eq/util/objectManager.h>
 #include <eq/util/shader.h>
 #include <lunchbox/os.h>
 #include <pression/plugins/compressor.h>
+#include <algorithm>
 
 
 namespace eq
@@ -47,6 +49,7 @@ static const char seeds = 42;
 static const char* shaderRBInfo = &seeds;
 
 #define GRID_SIZE 16 // will be replaced later by variable
+#define MAX_BLOCKS 255 // _dim and histograms use 8 bit block coordinates
 
 
 ROIFinder::ROIFinder()
@@ -57,6 +60,7 @@ ROIFinder::ROIFinder()
     , _wb( 0 )
     , _hb( 0 )
     , _wbhb( 0 )
+    , _reused( 0.f )
     , _histX()
     , _histY()
 {
@@ -71,19 +75,20 @@ PixelViewport ROIFinder::_getObjectPVP( const PixelViewport& pvp,
     LBASSERT( pvp.x >= 0 && pvp.x+pvp.w <= _wb &&
               pvp.y >= 0 && pvp.y+pvp.h <= _hb );
 
-    // Calculate per-pixel histograms
+    // Calculate per-block occupancy of columns and rows. Or'ing instead of
+    // counting the blocks lets the compiler vectorize the inner loop.
     const uint8_t* s = src + pvp.y*_wb + pvp.x;
 
     memset( _histX, 0, pvp.w );
-    memset( _histY, 0, pvp.h );
     for( int32_t y = 0; y < pvp.h; y++ )
     {
+        uint8_t row = 0;
         for( int32_t x = 0; x < pvp.w; x++ )
         {
-            const uint8_t val = s[ x ] & 1;
-            _histX[ x ] += val;
-            _histY[ y ] += val;
+            _histX[ x ] |= s[ x ];
+            row |= s[ x ];
         }
+        _histY[ y ] = row;
         s += _wb;
     }
 
@@ -174,6 +179,39 @@ void ROIFinder::_init( )
     }
 }
 
+void ROIFinder::_init( const uint32_t* pixels, const MaskType type,
+                       const PixelViewport& pvp )
+{
+    _areasToCheck.clear();
+    memset( &_mask[0]   , 0, _mask.size( ));
+
+    LBASSERT( static_cast<int32_t>(_mask.size()) >= _wb*_h );
+
+    uint32_t background = 0xffffffffu;
+    uint32_t bits = 0xffffffffu;
+    if( type == MASK_ALPHA )
+    {
+        // alpha is the fourth byte of RGBA and BGRA pixels
+        background = 0;
+        bits = 0;
+        reinterpret_cast< uint8_t* >( &bits )[3] = 0xff;
+    }
+
+    // markOccupied() works on blocks of 16 pixels, i.e., GRID_SIZE
+    const detail::CompositorKernels& kernels = detail::getCompositorKernels();
+
+#pragma omp parallel for
+    for( int32_t y = 0; y < _h; y++ )
+    {
+        uint8_t* dst = &_mask[ y * _wb ];
+        const int32_t yEnd = LB_MIN( (y+1)*GRID_SIZE, pvp.h );
+
+        for( int32_t row = y*GRID_SIZE; row < yEnd; row++ )
+            kernels.markOccupied( dst, pixels + size_t( row ) * pvp.w,
+                                  background, bits, pvp.w );
+    }
+}
+
 void ROIFinder::_invalidateAreas( Area* areas, uint8_t num )
 {
     for( uint8_t i = 0; i < num; i++ )
@@ -433,11 +471,12 @@ uint8_t ROIFinder::_splitArea( Area& a )
 }
 
 
-void ROIFinder::_findAreas( PixelViewports& resultPVPs )
+void ROIFinder::_findAreas( const PixelViewport& blocks,
+                            PixelViewports& resultPVPs )
 {
     LBASSERT( _areasToCheck.empty() );
 
-    Area area( PixelViewport( 0, 0, _w, _h ));
+    Area area( blocks );
     area.pvp  = _getObjectPVP( area.pvp, &_mask[0] );
 
     if( area.pvp.w <= 0 || area.pvp.h <= 0 )
@@ -470,17 +509,123 @@ void ROIFinder::_findAreas( PixelViewports& resultPVPs )
                 _areasToCheck.push_back( _finalAreas[i] );
         }
     }
+}
 
-    // correct position and sizes
-    for( uint32_t i = 0; i < resultPVPs.size(); i++ )
+namespace
+{
+/** @return true if the two block areas overlap or are adjacent. */
+bool _touches( const PixelViewport& a, const PixelViewport& b )
+{
+    return a.x <= b.x + b.w && b.x <= a.x + a.w &&
+           a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+/** @return true if the two block areas overlap. */
+bool _overlaps( const PixelViewport& a, const PixelViewport& b )
+{
+    return a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+}
+
+void ROIFinder::_reuseAreas( const Vectorub& mask,
+                             const PixelViewports& regions,
+                             PixelViewports& changed )
+{
+    LBASSERT( mask.size() >= size_t( _wb*_h ));
+
+    // label each block with the area of the last frame covering it
+    _owners.assign( _wh, -1 );
+    for( size_t i = 0; i < regions.size(); i++ )
     {
-        PixelViewport& pvp = resultPVPs[i];
-        pvp.x += _pvp.x;
-        pvp.y += _pvp.y;
+        const PixelViewport& region = regions[i];
+        for( int32_t y = region.y; y < region.y + region.h; y++ )
+            std::fill( &_owners[ y*_w + region.x ],
+                       &_owners[ y*_w + region.x ] + region.w, int32_t( i ));
+    }
 
-        pvp.apply( Zoom( GRID_SIZE, GRID_SIZE ));
+    // Areas containing changed blocks and runs of changed blocks outside of
+    // all areas, i.e., newly occupied ones, have to be analyzed again
+    std::vector< bool > keep( regions.size(), true );
+    for( int32_t y = 0; y < _h; y++ )
+    {
+        const uint8_t* cur = &_mask[ y*_wb ];
+        const uint8_t* prv = &mask[ y*_wb ];
+        if( memcmp( cur, prv, _w ) == 0 )
+            continue;
+
+        for( int32_t x = 0; x < _w; x++ )
+        {
+            if( cur[x] == prv[x] )
+                continue;
+
+            const int32_t owner = _owners[ y*_w + x ];
+            if( owner >= 0 )
+            {
+                if( keep[ owner ] )
+                    changed.push_back( regions[ owner ] );
+                keep[ owner ] = false;
+                continue;
+            }
+
+            PixelViewport run( x, y, 1, 1 );
+            while( x+1 < _w && cur[x+1] != prv[x+1] &&
+                   _owners[ y*_w + x+1 ] < 0 )
+            {
+                ++x;
+                ++run.w;
+            }
+            changed.push_back( run );
+        }
+    }
+
+    // Merge touching changed areas and grow them to all areas they overlap,
+    // the kept areas still cover all unchanged blocks outside
+    for( bool merged = true; merged; )
+    {
+        merged = false;
+        for( size_t i = 0; i < changed.size(); i++ )
+        {
+            for( size_t j = i + 1; j < changed.size(); )
+            {
+                if( _touches( changed[i], changed[j] ))
+                {
+                    changed[i].merge( changed[j] );
+                    changed[j] = changed.back();
+                    changed.pop_back();
+                    merged = true;
+                }
+                else
+                    ++j;
+            }
+
+            for( size_t j = 0; j < regions.size(); j++ )
+            {
+                if( keep[j] && _overlaps( changed[i], regions[j] ))
+                {
+                    changed[i].merge( regions[j] );
+                    keep[j] = false;
+                    merged = true;
+                }
+            }
+        }
+    }
+
+    uint32_t changedArea = 0;
+    for( size_t i = 0; i < changed.size(); i++ )
+        changedArea += changed[i].getArea();
+
+    // a full split finds better areas at about the same cost
+    if( changedArea * 2 > uint32_t( _wh ))
+    {
+        changed.assign( 1, PixelViewport( 0, 0, _w, _h ));
+        return;
     }
 
+    for( size_t i = 0; i < regions.size(); i++ )
+        if( keep[i] )
+            _regions.push_back( regions[i] );
+    _reused = 1.f - float( changedArea ) / float( _wh );
 }
 
 const void* ROIFinder::_getInfoKey( ) const
@@ -637,6 +782,10 @@ PixelViewports ROIFinder::findRegions( const uint32_t         buffers,
         return result;
     }
 
+    const PixelViewport blocks = _getBoundingPVP( pvp );
+    if( blocks.w > MAX_BLOCKS || blocks.h > MAX_BLOCKS )
+        return result;
+
 #ifdef EQ_ROI_USE_TRACKER
     uint8_t* ticket;
     if( !_roiTracker.useROIFinder( pvp, stage, frameID, ticket ))
@@ -644,7 +793,7 @@ PixelViewports ROIFinder::findRegions( const uint32_t         buffers,
 #endif
 
     _pvpOriginal = pvp;
-    _resize( _getBoundingPVP( pvp ));
+    _resize( blocks );
 
     // go through depth buffer and check min/max/BG values
     // render to and read-back usefull info from FBO
@@ -654,17 +803,120 @@ PixelViewports ROIFinder::findRegions( const uint32_t         buffers,
     // Analyze readed back data and find regions of interest
     _init( );
 
-    _emptyFinder.update( &_mask[0], _wb, _hb );
-    _emptyFinder.setLimits( 200, 0.002f );
-
     result.clear();
-    _findAreas( result );
-
 #ifdef EQ_ROI_USE_TRACKER
+    _analyze( result, ticket );
     _roiTracker.updateDelay( result, ticket );
+#else
+    _analyze( result, 0 );
 #endif
 
     return result;
 }
 
+PixelViewports ROIFinder::findRegions( const uint32_t*      pixels,
+                                       const MaskType       type,
+                                       const PixelViewport& pvp )
+{
+    PixelViewports result;
+    if( !pvp.hasArea( ))
+        return result;
+
+    // analyze the mask in its own coordinates, the grid starts at its origin
+    const PixelViewport maskPVP( 0, 0, pvp.w, pvp.h );
+    const PixelViewport blocks = _getBoundingPVP( maskPVP );
+    if( blocks.w > MAX_BLOCKS || blocks.h > MAX_BLOCKS )
+    {
+        result.push_back( pvp );
+        return result;
+    }
+
+    _pvpOriginal = maskPVP;
+    _resize( blocks );
+    _init( pixels, type, maskPVP );
+    _analyze( result, 0 );
+
+    // areas are aligned to the grid, clip them to the mask
+    for( size_t i = 0; i < result.size(); ++i )
+    {
+        PixelViewport& area = result[i];
+        area.intersect( maskPVP );
+        area.x += pvp.x;
+        area.y += pvp.y;
+    }
+    return result;
+}
+
+PixelViewports ROIFinder::findRegions( const uint32_t*      pixels,
+                                       const MaskType       type,
+                                       const PixelViewport& pvp,
+                                       const uint32_t       stage,
+                                       const uint128_t&     frameID )
+{
+    const PixelViewport maskPVP( 0, 0, pvp.w, pvp.h );
+    const PixelViewport blocks = _getBoundingPVP( maskPVP );
+    _reused = 0.f;
+
+    if( !pvp.hasArea() || blocks.w > MAX_BLOCKS || blocks.h > MAX_BLOCKS )
+        return findRegions( pixels, type, pvp );
+
+    // skipped by the tracker, as in the GL path
+    uint8_t* ticket;
+    if( !_roiTracker.useROIFinder( pvp, stage, frameID, ticket ))
+        return PixelViewports( 1, pvp );
+
+    PixelViewports result;
+    _pvpOriginal = maskPVP;
+    _resize( blocks );
+    _init( pixels, type, maskPVP );
+    _analyze( result, ticket );
+    _roiTracker.updateDelay( result, ticket );
+
+    for( size_t i = 0; i < result.size(); ++i )
+    {
+        PixelViewport& area = result[i];
+        area.intersect( maskPVP );
+        area.x += pvp.x;
+        area.y += pvp.y;
+    }
+    return result;
+}
+
+void ROIFinder::_analyze( PixelViewports& resultPVPs, const uint8_t* ticket )
+{
+    _regions.clear();
+    _reused = 0.f;
+
+    _changed.clear();
+    const Vectorub* mask = 0;
+    const PixelViewports* regions = 0;
+    if( ticket && _roiTracker.getPrevious( ticket, mask, regions ))
+        _reuseAreas( *mask, *regions, _changed );
+    else
+        _changed.push_back( PixelViewport( 0, 0, _w, _h ));
+
+    if( !_changed.empty( ))
+    {
+        _emptyFinder.update( &_mask[0], _wb, _hb );
+        _emptyFinder.setLimits( 200, 0.002f );
+
+        for( size_t i = 0; i < _changed.size(); i++ )
+            _findAreas( _changed[i], _regions );
+    }
+
+    if( ticket )
+        _roiTracker.setRegions( &_mask[0], _wbhb, _regions, ticket );
+
+    // correct position and sizes
+    for( size_t i = 0; i < _regions.size(); i++ )
+    {
+        PixelViewport pvp = _regions[i];
+        pvp.x += _pvp.x;
+        pvp.y += _pvp.y;
+
+        pvp.apply( Zoom( GRID_SIZE, GRID_SIZE ));
+        resultPVPs.push_back( pvp );
+    }
+}
+
 }
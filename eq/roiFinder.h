@@ -34,6 +34,13 @@ namespace eq
 class ROIFinder
 {
 public:
+    /** The content of a mask in main memory. */
+    enum MaskType
+    {
+        MASK_DEPTH, //!< 32 bit depth, the far plane is background
+        MASK_ALPHA  //!< 8 bit RGBA or BGRA, zero alpha is background
+    };
+
     ROIFinder();
     virtual ~ROIFinder() {}
 
@@ -55,6 +62,52 @@ public:
                                 const uint32_t         stage,
                                 const uint128_t&       frameID,
                                 util::ObjectManager&   glObjects );
+
+    /**
+     * Selects the non-empty areas of a mask in main memory.
+     *
+     * Does not use OpenGL. Masks larger than 4080x4080 pixels are not
+     * analyzed.
+     *
+     * @param pixels the tightly packed 32 bit pixels of the mask.
+     * @param type   the content of the mask.
+     * @param pvp    the viewport of the mask.
+     *
+     * @return Areas within pvp covering all non-background pixels
+     */
+    PixelViewports findRegions( const uint32_t*      pixels,
+                                const MaskType       type,
+                                const PixelViewport& pvp );
+
+    /**
+     * Selects the non-empty areas of a mask in main memory, reusing the areas
+     * of the previous frame.
+     *
+     * If the previous frame analyzed a mask with the same viewport in the same
+     * stage, only the areas around the blocks whose occupancy changed are
+     * recomputed. Areas are not analyzed when the ROI tracker disables them,
+     * in which case the whole viewport is returned.
+     *
+     * @param pixels  the tightly packed 32 bit pixels of the mask.
+     * @param type    the content of the mask.
+     * @param pvp     the viewport of the mask.
+     * @param stage   compositing stage (to track separate statistics).
+     * @param frameID ID of current frame (to track separate statistics).
+     *
+     * @return Areas within pvp covering all non-background pixels
+     */
+    PixelViewports findRegions( const uint32_t*      pixels,
+                                const MaskType       type,
+                                const PixelViewport& pvp,
+                                const uint32_t       stage,
+                                const uint128_t&     frameID );
+
+    /**
+     * @return the fraction of the last analyzed mask whose areas were reused
+     *         from the previous frame.
+     */
+    float getReusedRatio() const { return _reused; }
+
 private:
     ROIFinder( const ROIFinder& ) = delete;
     ROIFinder& operator=( const ROIFinder& ) = delete;
@@ -71,6 +124,25 @@ private:
         that was previously read-back from GPU in _readbackInfo */
     void _init( );
 
+    /** Clears masks, fills per-block occupancy _mask from CPU pixels */
+    void _init( const uint32_t* pixels, const MaskType type,
+                const PixelViewport& pvp );
+
+    /**
+     * Finds areas in the occupancy _mask filled by one of the _init. Reuses
+     * and updates the areas of the previous frame if a ticket from the
+     * _roiTracker is given.
+     */
+    void _analyze( PixelViewports& resultPVPs, const uint8_t* ticket );
+
+    /**
+     * Keeps the areas of the previous frame not touched by occupancy changes
+     * in _regions, and returns the disjoint parts of the mask to analyze
+     * again in changed, in blocks.
+     */
+    void _reuseAreas( const Vectorub& mask, const PixelViewports& regions,
+                      PixelViewports& changed );
+
     /** Updates dimensions and resizes arrays */
     void _resize( const PixelViewport& pvp );
 
@@ -84,8 +156,8 @@ private:
     /** Finds empty area in sub area. Used during optimal split search */
     void _updateSubArea( const uint8_t type );
 
-    /** Find areas in current mask*/
-    void _findAreas( PixelViewports& resultPVPs );
+    /** Find areas within the given blocks of the current mask */
+    void _findAreas( const PixelViewport& blocks, PixelViewports& resultPVPs );
 
     /** Only used in debug build, to invalidate unused areas */
     void _invalidateAreas( Area* areas, uint8_t num );
@@ -138,8 +210,13 @@ private:
 
     std::vector<float> _perBlockInfo; //!< buffer for data from GPU
 
-    uint8_t _histX[256]; //!< histogram to find BB along X axis
-    uint8_t _histY[256]; //!< histogram to find BB along Y axis
+    PixelViewports _regions; //!< areas found in _mask, in blocks
+    PixelViewports _changed; //!< parts of _mask to analyze, in blocks
+    std::vector< int32_t > _owners; //!< last frame's area of each block
+    float _reused;           //!< fraction of _mask reused from last frame
+
+    uint8_t _histX[256]; //!< non-zero for occupied columns, to find BB in X
+    uint8_t _histY[256]; //!< non-zero for occupied rows, to find BB in Y
 
     Image _tmpImg;   //!< used for dumping debug info
 
@@ -32,6 +32,7 @@ ROITracker::Area::Area( const PixelViewport& pvp_,
 ROITracker::ROITracker()
     : _needsUpdate( false )
     , _lastStage( 0 )
+    , _previous( 0 )
 {
     _ticket   = reinterpret_cast< uint8_t* >( this );
     _prvFrame = new stde::hash_map< uint32_t, Stage >;
@@ -62,6 +63,7 @@ bool ROITracker::useROIFinder( const PixelViewport& pvp,
 {
     LBASSERT( !_needsUpdate );
     ticket = 0;
+    _previous = 0;
 
     const uint32_t pvpArea = pvp.getArea();
     if( pvpArea < 100 )
@@ -114,6 +116,8 @@ bool ROITracker::useROIFinder( const PixelViewport& pvp,
 
     if( match->skip == 0 ) // don't skip frame
     {
+        if( match->pvp == pvp && !match->mask.empty( ))
+            _previous = match;
         curStage.areas.push_back( Area( pvp, match->lastSkip ));
         return _returnPositive( ticket );
     }
@@ -155,6 +159,38 @@ void ROITracker::updateDelay( const PixelViewports& pvps,
     _needsUpdate = false;
 }
 
+bool ROITracker::getPrevious( const uint8_t* ticket, const Vectorub*& mask,
+                              const PixelViewports*& regions ) const
+{
+    LBASSERT( _needsUpdate );
+    LBASSERTINFO( ticket == _ticket, "Wrong ticket" );
+
+    if( ticket != _ticket || !_previous )
+        return false;
+
+    mask = &_previous->mask;
+    regions = &_previous->regions;
+    return true;
+}
+
+void ROITracker::setRegions( const uint8_t* mask, const size_t size,
+                             const PixelViewports& regions,
+                             const uint8_t* ticket )
+{
+    LBASSERT( _needsUpdate );
+    LBASSERTINFO( ticket == _ticket, "Wrong ticket" );
+
+    if( ticket != _ticket )
+    {
+        LBERROR << "Wrong ticket" << std::endl;
+        return;
+    }
+
+    Area& area = (*_curFrame)[ _lastStage ].areas.back();
+    area.mask.assign( mask, mask + size );
+    area.regions = regions;
+}
+
 }
 
 
@@ -74,6 +74,34 @@ public:
      */
     void updateDelay( const PixelViewports& pvps, const uint8_t* ticket );
 
+    /**
+     * Get the block mask and regions of the previous frame for the area given
+     * to the last positive useROIFinder.
+     *
+     * Only available if the previous frame analyzed an area with the same
+     * viewport in the same stage. Has to be called before updateDelay.
+     *
+     * @param  ticket  value from useROIFinder
+     * @param  mask    returns the block occupancy mask of the previous frame
+     * @param  regions returns the regions found in mask, in blocks
+     * @return true if the previous mask and regions are available.
+     */
+    bool getPrevious( const uint8_t* ticket, const Vectorub*& mask,
+                      const PixelViewports*& regions ) const;
+
+    /**
+     * Store the block mask and regions found for the area given to the last
+     * positive useROIFinder, for getPrevious in the next frame. Has to be
+     * called before updateDelay.
+     *
+     * @param  mask    the block occupancy mask
+     * @param  size    the number of blocks in mask
+     * @param  regions the regions found in mask, in blocks
+     * @param  ticket  value from useROIFinder
+     */
+    void setRegions( const uint8_t* mask, const size_t size,
+                     const PixelViewports& regions, const uint8_t* ticket );
+
 private:
     ROITracker( const ROITracker& ) = delete;
     ROITracker& operator=( const ROITracker& ) = delete;
@@ -88,6 +116,8 @@ private:
         PixelViewport pvp;
         uint32_t      lastSkip; //!< Previousely skiped number of frames
         uint32_t      skip;     //!< Number of frames to skip ROIFinder
+        Vectorub      mask;     //!< Block occupancy found by ROIFinder
+        PixelViewports regions; //!< Regions found in mask, in blocks
     };
     /** Set of readback areas per compositiong stage */
     struct Stage
@@ -106,6 +136,7 @@ private:
     bool     _needsUpdate;//!< true after getDelay, false after updateDelay
     uint128_t _lastFrameID;//!< used to determine new frames
     uint32_t _lastStage;  //!< used in updateDelay to find last added area
+    const Area* _previous;//!< same area in the previous frame, if analyzed
 
     bool _returnPositive( uint8_t*& ticket );
 };
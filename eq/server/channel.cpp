@@ -87,6 +87,8 @@ Channel::Channel( Window* parent )
         , _segment( 0 )
         , _state( STATE_STOPPED )
         , _lastDrawCompound( 0 )
+        , _taskScheduleVersion( 0 )
+        , _hasLastContext( false )
         , _private( 0 )
 {
     const Global* global = Global::instance();
@@ -109,6 +111,8 @@ Channel::Channel( const Channel& from )
         , _segment( 0 )
         , _state( STATE_STOPPED )
         , _lastDrawCompound( 0 )
+        , _taskScheduleVersion( 0 )
+        , _hasLastContext( false )
         , _private( 0 )
 {
     // Don't copy view and segment. Will be re-set by segment copy ctor
@@ -127,6 +131,8 @@ void Channel::attach( const uint128_t& id, const uint32_t instanceID )
                      CmdFunc( this, &Channel::_cmdConfigExitReply ), cmdQ );
     registerCommand( fabric::CMD_CHANNEL_FRAME_FINISH_REPLY,
                      CmdFunc( this, &Channel::_cmdFrameFinishReply ), mainQ );
+    registerCommand( fabric::CMD_CHANNEL_FRAME_TILE_COSTS,
+                     CmdFunc( this, &Channel::_cmdFrameTileCosts ), mainQ );
 }
 
 Channel::~Channel()
@@ -139,6 +145,8 @@ void Channel::postDelete()
     // command invokation after channel deletion
     registerCommand( fabric::CMD_CHANNEL_FRAME_FINISH_REPLY,
                      CmdFunc( this, &Channel::_cmdNop ), 0 );
+    registerCommand( fabric::CMD_CHANNEL_FRAME_TILE_COSTS,
+                     CmdFunc( this, &Channel::_cmdNop ), 0 );
 }
 
 Config* Channel::getConfig()
@@ -312,6 +320,7 @@ void Channel::configInit( const uint128_t& initID, const uint32_t /*frame*/ )
     LBLOG( LOG_INIT ) << "Init channel" << std::endl;
     getWindow()->send( fabric::CMD_WINDOW_CREATE_CHANNEL ) << getID();
     send( fabric::CMD_CHANNEL_CONFIG_INIT ) << initID;
+    _hasLastContext = false; // new client channel
 }
 
 bool Channel::syncConfigInit()
@@ -381,32 +390,58 @@ bool Channel::update( const uint128_t& frameID, const uint32_t frameNumber )
 
     RenderContext context;
     _setupRenderContext( frameID, context );
-    send( fabric::CMD_CHANNEL_FRAME_START )
-            << context << getVersion() << frameNumber;
+    sendTask( fabric::CMD_CHANNEL_FRAME_START, context )
+            << getVersion() << frameNumber;
     LBLOG( LOG_TASKS ) << "TASK channel " << getName() << " start frame  "
                        << frameNumber << std::endl;
 
     bool updated = false;
-    const Compounds& compounds = getCompounds();
-    for( Compounds::const_iterator i = compounds.begin();
-         i != compounds.end(); ++i )
+    _updateTaskSchedule();
+    if( _lastDrawCompound && _isScheduled( _lastDrawCompound ))
     {
-        const Compound* compound = *i;
-        ChannelUpdateVisitor visitor( this, frameID, frameNumber );
+        // Only visit the compounds using this channel and their parents, which
+        // include the last draw compound sending the draw finish
+        for( const TaskSteps& steps : _taskSchedule )
+        {
+            ChannelUpdateVisitor visitor( this, frameID, frameNumber );
 
-        visitor.setEye( EYE_CYCLOP );
-        compound->accept( visitor );
+            visitor.setEye( EYE_CYCLOP );
+            _runTaskSchedule( steps, visitor );
 
-        visitor.setEye( EYE_LEFT );
-        compound->accept( visitor );
+            visitor.setEye( EYE_LEFT );
+            _runTaskSchedule( steps, visitor );
 
-        visitor.setEye( EYE_RIGHT );
-        compound->accept( visitor );
+            visitor.setEye( EYE_RIGHT );
+            _runTaskSchedule( steps, visitor );
 
-        updated |= visitor.isUpdated();
+            updated |= visitor.isUpdated();
+        }
     }
+    else
+    {
+        // Full traversal, the draw finish is sent for the first compound or
+        // for a last draw compound not using this channel, e.g., another root
+        const Compounds& compounds = getCompounds();
+        for( Compounds::const_iterator i = compounds.begin();
+             i != compounds.end(); ++i )
+        {
+            const Compound* compound = *i;
+            ChannelUpdateVisitor visitor( this, frameID, frameNumber );
+
+            visitor.setEye( EYE_CYCLOP );
+            compound->accept( visitor );
 
-    send( fabric::CMD_CHANNEL_FRAME_FINISH ) << context << frameNumber;
+            visitor.setEye( EYE_LEFT );
+            compound->accept( visitor );
+
+            visitor.setEye( EYE_RIGHT );
+            compound->accept( visitor );
+
+            updated |= visitor.isUpdated();
+        }
+    }
+
+    sendTask( fabric::CMD_CHANNEL_FRAME_FINISH, context ) << frameNumber;
     LBLOG( LOG_TASKS ) << "TASK channel " << getName() << " finish frame  "
                            << frameNumber << std::endl;
     _lastDrawCompound = 0;
@@ -414,11 +449,111 @@ bool Channel::update( const uint128_t& frameID, const uint32_t frameNumber )
     return updated;
 }
 
+void Channel::_updateTaskSchedule()
+{
+    const uint32_t version = getConfig()->getTaskScheduleVersion();
+    if( version == _taskScheduleVersion )
+        return;
+
+    _taskSchedule.clear();
+    const Compounds& compounds = getCompounds();
+    for( Compounds::const_iterator i = compounds.begin();
+         i != compounds.end(); ++i )
+    {
+        TaskSteps steps;
+        if( _addTaskSteps( *i, steps ))
+            _taskSchedule.push_back( steps );
+    }
+    _taskScheduleVersion = version;
+}
+
+bool Channel::_addTaskSteps( const Compound* compound, TaskSteps& steps ) const
+{
+    if( compound->isLeaf( ))
+    {
+        if( compound->getChannel() != this )
+            return false;
+
+        const TaskStep step = { compound, TaskStep::LEAF, 0 };
+        steps.push_back( step );
+        return true;
+    }
+
+    const size_t pre = steps.size();
+    const TaskStep step = { compound, TaskStep::PRE, 0 };
+    steps.push_back( step );
+
+    bool used = compound->getChannel() == this;
+    const Compounds& children = compound->getChildren();
+    for( Compounds::const_iterator i = children.begin();
+         i != children.end(); ++i )
+    {
+        used |= _addTaskSteps( *i, steps );
+    }
+
+    if( !used )
+    {
+        steps.resize( pre );
+        return false;
+    }
+
+    const TaskStep post = { compound, TaskStep::POST, 0 };
+    steps.push_back( post );
+    steps[ pre ].next = steps.size();
+    return true;
+}
+
+bool Channel::_isScheduled( const Compound* compound ) const
+{
+    for( const TaskSteps& steps : _taskSchedule )
+        for( const TaskStep& step : steps )
+            if( step.compound == compound )
+                return true;
+    return false;
+}
+
+void Channel::_runTaskSchedule( const TaskSteps& steps,
+                                ChannelUpdateVisitor& visitor ) const
+{
+    // same visits as Compound::accept, without the unrelated compounds
+    size_t i = 0;
+    while( i < steps.size( ))
+    {
+        const TaskStep& step = steps[i];
+        switch( step.type )
+        {
+        case TaskStep::PRE:
+            if( visitor.visitPre( step.compound ) == TRAVERSE_PRUNE )
+            {
+                i = step.next;
+                continue;
+            }
+            break;
+        case TaskStep::LEAF:
+            visitor.visitLeaf( step.compound );
+            break;
+        case TaskStep::POST:
+            visitor.visitPost( step.compound );
+            break;
+        }
+        ++i;
+    }
+}
+
 co::ObjectOCommand Channel::send( const uint32_t cmd )
 {
     return getNode()->send( cmd, getID( ));
 }
 
+co::ObjectOCommand Channel::sendTask( const uint32_t cmd,
+                                      const RenderContext& context )
+{
+    co::ObjectOCommand command = send( cmd );
+    context.serializeDelta( command, _lastContext, !_hasLastContext );
+    _hasLastContext = true;
+    return command;
+}
+
 //---------------------------------------------------------------------------
 // Listener interface
 //---------------------------------------------------------------------------
@@ -439,15 +574,24 @@ void Channel::removeListener(  ChannelListener* listener )
         _listeners.erase( i );
 }
 
-void Channel::_fireLoadData( const uint32_t frameNumber,
-                             const fabric::Statistics& statistics,
-                             const Viewport& region )
+void Channel::fireLoadData( const uint32_t frameNumber,
+                            const fabric::Statistics& statistics,
+                            const Viewport& region )
 {
     LB_TS_SCOPED( _serverThread );
     for( ChannelListener* listener : _listeners )
         listener->notifyLoadData( this, frameNumber, statistics, region );
 }
 
+void Channel::_fireTileCosts( const uint32_t frameNumber,
+                              const std::vector< PixelViewport >& tiles,
+                              const std::vector< float >& times )
+{
+    LB_TS_SCOPED( _serverThread );
+    for( ChannelListener* listener : _listeners )
+        listener->notifyTileCosts( this, frameNumber, tiles, times );
+}
+
 //===========================================================================
 // command handling
 //===========================================================================
@@ -480,7 +624,20 @@ bool Channel::_cmdFrameFinishReply( co::ICommand& cmd )
     const uint32_t frameNumber = command.read< uint32_t >();
     const Statistics& statistics = command.read< Statistics >();
 
-    _fireLoadData( frameNumber, statistics, region );
+    fireLoadData( frameNumber, statistics, region );
+    return true;
+}
+
+bool Channel::_cmdFrameTileCosts( co::ICommand& cmd )
+{
+    co::ObjectICommand command( cmd );
+    const uint32_t frameNumber = command.read< uint32_t >();
+    const std::vector< PixelViewport >& tiles =
+        command.read< std::vector< PixelViewport > >();
+    const std::vector< float >& times = command.read< std::vector< float > >();
+
+    LBASSERT( tiles.size() == times.size( ));
+    _fireTileCosts( frameNumber, tiles, times );
     return true;
 }
 
@@ -511,6 +668,9 @@ void Channel::output( std::ostream& os ) const
 
         os << ( i==IATTR_HINT_STATISTICS ? "hint_statistics   " :
                 i==IATTR_HINT_SENDTOKEN ?  "hint_sendtoken    " :
+                i==IATTR_HINT_BATCH_TRANSMIT ? "hint_batch_transmit " :
+                i==IATTR_HINT_TRIM_TRANSMIT ? "hint_trim_transmit " :
+                i==IATTR_HINT_DUMP_IMAGE ? "hint_dump_image   " :
                                            "ERROR " )
            << static_cast< fabric::IAttribute >( value ) << std::endl;
     }
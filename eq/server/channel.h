@@ -25,6 +25,7 @@
 
 #include <eq/fabric/channel.h>       // base class
 #include <eq/fabric/pixelViewport.h> // member
+#include <eq/fabric/renderContext.h> // member
 #include <eq/fabric/viewport.h>      // member
 #include <lunchbox/monitor.h> // member
 
@@ -35,6 +36,8 @@ namespace eq
 {
 namespace server
 {
+class ChannelUpdateVisitor;
+
 class Channel : public fabric::Channel< Window, Channel >
 {
 public:
@@ -163,6 +166,12 @@ public:
     bool update( const uint128_t& frameID, const uint32_t frameNumber );
 
     co::ObjectOCommand send( const uint32_t cmd );
+
+    /**
+     * Send a task command with the render context, encoded as the difference
+     * to the context of the last task.
+     */
+    co::ObjectOCommand sendTask( uint32_t cmd, const RenderContext& context );
     //@}
 
     /** @name Channel listener interface. */
@@ -173,6 +182,11 @@ public:
     void removeListener( ChannelListener* listener );
     /** @return true if the channel has listeners */
     bool hasListeners() const { return !_listeners.empty(); }
+
+    /** @internal Notify the listeners about the statistics of a frame. */
+    void fireLoadData( const uint32_t frameNumber,
+                       const Statistics& statistics,
+                       const Viewport& region );
     //@}
 
     bool omitOutput() const; //!< @internal
@@ -201,6 +215,27 @@ private:
     /** The last draw compound for this entity */
     const Compound* _lastDrawCompound;
 
+    /** A visit of the task generation traversal of the compounds. */
+    struct TaskStep
+    {
+        enum Type { PRE, LEAF, POST };
+
+        const Compound* compound;
+        Type type;
+        size_t next; //!< step after the subtree, if pruned in PRE
+    };
+    typedef std::vector< TaskStep > TaskSteps;
+
+    /** The compounds using this channel and their parents, per root. */
+    std::vector< TaskSteps > _taskSchedule;
+
+    /** The config task schedule version of _taskSchedule. */
+    uint32_t _taskScheduleVersion;
+
+    /** The render context of the last task, as known by the render client. */
+    RenderContext _lastContext;
+    bool _hasLastContext;
+
     typedef std::vector< ChannelListener* > ChannelListeners;
     ChannelListeners _listeners;
 
@@ -215,14 +250,21 @@ private:
     void _setupRenderContext( const uint128_t& frameID,
                               RenderContext& context );
 
-    void _fireLoadData( const uint32_t frameNumber,
-                        const Statistics& statistics,
-                        const Viewport& region );
+    void _updateTaskSchedule();
+    bool _addTaskSteps( const Compound* compound, TaskSteps& steps ) const;
+    bool _isScheduled( const Compound* compound ) const;
+    void _runTaskSchedule( const TaskSteps& steps,
+                           ChannelUpdateVisitor& visitor ) const;
+
+    void _fireTileCosts( const uint32_t frameNumber,
+                         const std::vector< PixelViewport >& tiles,
+                         const std::vector< float >& times );
 
     /* command handler functions. */
     bool _cmdConfigInitReply( co::ICommand& command );
     bool _cmdConfigExitReply( co::ICommand& command );
     bool _cmdFrameFinishReply( co::ICommand& command );
+    bool _cmdFrameTileCosts( co::ICommand& command );
     bool _cmdNop( co::ICommand& /*command*/ )
         { return true; }
 
@@ -41,6 +41,19 @@ public:
     virtual void notifyLoadData( Channel* channel, uint32_t frameNumber,
                                  const Statistics& statistics,
                                  const Viewport& region ) = 0;
+
+    /**
+     * Notify that the channel has rendered tiles of a tile queue.
+     *
+     * @param channel the channel
+     * @param frameNumber the frame number.
+     * @param tiles the pixel viewports of the rendered tiles.
+     * @param times the processing time of each tile in milliseconds.
+     */
+    virtual void notifyTileCosts( Channel* /*channel*/,
+                                  uint32_t /*frameNumber*/,
+                                  const std::vector< PixelViewport >& /*tiles*/,
+                                  const std::vector< float >& /*times*/ ) {}
 };
 }
 }
@@ -157,6 +157,7 @@ void Compound::_addChild( Compound* child )
     LBASSERT( child->_parent == this );
     _children.push_back( child );
     _fireChildAdded( child );
+    _invalidateTaskSchedules();
 }
 
 bool Compound::_removeChild( Compound* child )
@@ -167,9 +168,17 @@ bool Compound::_removeChild( Compound* child )
 
     _fireChildRemove( child );
     _children.erase( i );
+    _invalidateTaskSchedules();
     return true;
 }
 
+void Compound::_invalidateTaskSchedules()
+{
+    Config* config = getConfig();
+    if( config )
+        config->invalidateTaskSchedules();
+}
+
 Compound* Compound::getNext() const
 {
     if( !_parent )
@@ -201,6 +210,7 @@ ServerPtr Compound::getServer()
 void Compound::setChannel( Channel* channel )
 {
     _data.channel = channel;
+    _invalidateTaskSchedules();
 
     // Update swap barrier
     if( !isDestination( ))
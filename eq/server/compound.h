@@ -597,6 +597,7 @@ private:
 
     void _fireChildAdded( Compound* child );
     void _fireChildRemove( Compound* child );
+    void _invalidateTaskSchedules();
 
     void _computeFrustum( RenderContext& context ) const;
     void _computePerspective( RenderContext& context,
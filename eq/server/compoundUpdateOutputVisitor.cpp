@@ -26,6 +26,7 @@
 #include "tileQueue.h"
 #include "window.h"
 
+#include "equalizers/tileEqualizer.h"
 #include "tiles/zigzagStrategy.h"
 
 #include <eq/fabric/iAttribute.h>
@@ -188,7 +189,22 @@ void CompoundUpdateOutputVisitor::_generateTiles( TileQueue* queue,
     std::vector< Vector2i > tiles;
     tiles.reserve( dim.x() * dim.y() );
 
-    tiles::generateZigzag( tiles, dim );
+    const Equalizers& equalizers = compound->getEqualizers();
+    for( Equalizer* equalizer : equalizers )
+    {
+        if( equalizer->getType() != fabric::TILE_EQUALIZER )
+            continue;
+
+        const TileEqualizer* tileEqualizer =
+            static_cast< const TileEqualizer* >( equalizer );
+        if( tileEqualizer->getQueueName() == queue->getName( ))
+        {
+            tileEqualizer->generateTiles( tiles, dim );
+            break;
+        }
+    }
+    if( tiles.empty( )) // queue from config file
+        tiles::generateZigzag( tiles, dim );
     _addTilesToQueue( queue, compound, tiles );
 }
 
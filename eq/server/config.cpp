@@ -44,6 +44,8 @@
 
 #include <lunchbox/sleep.h>
 #include <boost/foreach.hpp>
+#include <algorithm>
+#include <cstring>
 
 #include "channelStopFrameVisitor.h"
 #include "configDeregistrator.h"
@@ -62,6 +64,7 @@ using fabric::OFF;
 
 Config::Config( ServerPtr parent )
         : Super( parent )
+        , _taskScheduleVersion( 1 )
         , _currentFrame( 0 )
         , _incarnation( 1 )
         , _finishedFrame( 0 )
@@ -120,6 +123,9 @@ void Config::attach( const uint128_t& id, const uint32_t instanceID )
 
 namespace
 {
+// running nodes from which AUTO generates their tasks in parallel
+const size_t _minParallelNodes = 8;
+
 class ChannelViewFinder : public ConfigVisitor
 {
 public:
@@ -400,6 +406,7 @@ void Config::addCompound( Compound* compound )
 {
     LBASSERT( compound->_config == this );
     _compounds.push_back( compound );
+    invalidateTaskSchedules();
 }
 
 bool Config::removeCompound( Compound* compound )
@@ -410,6 +417,7 @@ bool Config::removeCompound( Compound* compound )
         return false;
 
     _compounds.erase( i );
+    invalidateTaskSchedules();
     return true;
 }
 
@@ -867,6 +875,7 @@ void Config::_startFrame( const uint128_t& frameID )
     _verifyFrameFinished( _currentFrame );
     _syncClock();
 
+    const int64_t startTime = getServer()->getTime();
     ++_currentFrame;
     ++_incarnation;
     LBLOG( LOG_TASKS ) << "----- Start Frame ----- " << _currentFrame
@@ -883,12 +892,17 @@ void Config::_startFrame( const uint128_t& frameID )
     accept( configDataVisitor );
 
     const Nodes& nodes = getNodes();
+    const uint64_t bytes = updateNodes( frameID, _currentFrame );
+
     co::NodePtr appNode = findApplicationNetNode();
+    uint32_t nUpdated = 0;
     for( Nodes::const_iterator i = nodes.begin(); i != nodes.end(); ++i )
     {
-        Node* node = *i;
-        node->update( frameID, _currentFrame );
-        if( node->isRunning() && node->isApplicationNode( ))
+        const Node* node = *i;
+        if( !node->isRunning( ))
+            continue;
+        ++nUpdated;
+        if( node->isApplicationNode( ))
             appNode = 0; // release sent (see below)
     }
 
@@ -896,10 +910,58 @@ void Config::_startFrame( const uint128_t& frameID )
         send( appNode,
               fabric::CMD_CONFIG_RELEASE_FRAME_LOCAL ) << _currentFrame;
 
+    if( getIAttribute( IATTR_HINT_STATISTICS ) != OFF )
+        _sendStatistic( Statistic::CONFIG_SERVER_FRAME, startTime, nUpdated,
+                        uint32_t( std::min( bytes, uint64_t( 0xffffffffu ))));
+
     // Fix 2976899: Config::finishFrame deadlocks when no nodes are active
     notifyNodeFrameFinished( _currentFrame );
 }
 
+uint64_t Config::updateNodes( const uint128_t& frameID,
+                              const uint32_t frameNumber )
+{
+    Nodes nodes;
+    for( Node* node : getNodes( ))
+        if( node->isRunning( ))
+            nodes.push_back( node );
+
+    const int32_t hint = getIAttribute( IATTR_HINT_PARALLEL_TASKS );
+    const bool parallel = hint == ON ||
+                          ( hint == AUTO && nodes.size() >= _minParallelNodes );
+
+    // The tasks of a node only depend on the updated compounds and on its own
+    // resources, and are sent in order from one thread on its connection
+    uint64_t bytes = 0;
+#pragma omp parallel for schedule( dynamic ) reduction( + : bytes ) \
+    if( parallel )
+    for( ssize_t i = 0; i < ssize_t( nodes.size( )); ++i )
+        bytes += nodes[i]->update( frameID, frameNumber );
+
+    return bytes;
+}
+
+void Config::_sendStatistic( const Statistic::Type type,
+                             const int64_t startTime, const uint32_t value0,
+                             const uint32_t value1 )
+{
+    co::NodePtr appNode = findApplicationNetNode();
+    if( !appNode )
+        return;
+
+    Statistic statistic = Statistic();
+    statistic.type = type;
+    statistic.frameNumber = _currentFrame;
+    statistic.plugins[0] = value0;
+    statistic.plugins[1] = value1;
+    statistic.startTime = startTime;
+    statistic.endTime = std::max( getServer()->getTime(), startTime + 1 );
+    ::strncpy( statistic.resourceName, "server", 31 );
+
+    EventOCommand cmd( send( appNode, fabric::CMD_CONFIG_EVENT ));
+    cmd << uint32_t( Event::STATISTIC ) << getSerial() << statistic;
+}
+
 void Config::_verifyFrameFinished( const uint32_t frameNumber )
 {
     const Nodes& nodes = getNodes();
@@ -85,6 +85,19 @@ public:
     /** @return the vector of compounds. */
     const Compounds& getCompounds() const { return _compounds; }
 
+    /**
+     * @internal Generate and send the tasks of all running nodes for a frame,
+     * in parallel depending on IATTR_HINT_PARALLEL_TASKS.
+     * @return the number of bytes of the task commands.
+     */
+    uint64_t updateNodes( const uint128_t& frameID, uint32_t frameNumber );
+
+    /** @internal Invalidate the cached task schedules of all channels. */
+    void invalidateTaskSchedules() { ++_taskScheduleVersion; }
+
+    /** @internal @return the version of the compound trees. */
+    uint32_t getTaskScheduleVersion() const { return _taskScheduleVersion; }
+
     /**
      * Find the first channel of a given name.
      *
@@ -222,6 +235,9 @@ private:
     /** The list of compounds. */
     Compounds _compounds;
 
+    /** Changed whenever a compound tree changes, starting at 1. */
+    uint32_t _taskScheduleVersion;
+
     /** Auto-configured server connections. */
     co::Connections _connections;
 
@@ -277,6 +293,8 @@ private:
     bool _init( const uint128_t& initID );
 
     void _startFrame( const uint128_t& frameID );
+    void _sendStatistic( Statistic::Type type, int64_t startTime,
+                         uint32_t value0, uint32_t value1 );
     void _flushAllFrames();
     //@}
 
@@ -38,6 +38,7 @@ std::ostream& operator << ( std::ostream& os, const LoadEqualizer::Node* );
 
 LoadEqualizer::LoadEqualizer()
         : _tree( 0 )
+        , _modelFrame( 0 )
 {
     LBVERB << "New LoadEqualizer @" << (void*)this << std::endl;
 }
@@ -45,6 +46,7 @@ LoadEqualizer::LoadEqualizer()
 LoadEqualizer::LoadEqualizer( const fabric::Equalizer& from )
         : Equalizer( from )
         , _tree( 0 )
+        , _modelFrame( 0 )
 {}
 
 LoadEqualizer::~LoadEqualizer()
@@ -90,6 +92,8 @@ void LoadEqualizer::notifyUpdatePre( Compound* compound,
         _history.back().first = frameNumber;
     }
 
+    if( isPredictive( ))
+        _updateModels();
     _update( _tree, Viewport(), Range( ));
     _computeSplit();
 }
@@ -296,6 +300,60 @@ void LoadEqualizer::_checkHistory()
     }
 }
 
+void LoadEqualizer::_updateModels()
+{
+    const LBFrameData& frameData = _history.front();
+    const LBDatas& items = frameData.second;
+    if( frameData.first <= _modelFrame )
+        return;
+
+    for( LBDatas::const_iterator i = items.begin(); i != items.end(); ++i )
+        if( i->time < 0 )
+            return; // incomplete
+
+    _modelFrame = frameData.first;
+    for( LBDatas::const_iterator i = items.begin(); i != items.end(); ++i )
+    {
+        const Data& data = *i;
+        Node* leaf = _findLeaf( _tree, data.channel );
+        if( !leaf || data.work <= 0.f )
+            continue;
+
+        leaf->fit.addSample( data.work, float( data.time ));
+        LBLOG( LOG_LB2 ) << data.channel->getName() << " model " << leaf->fit
+                         << std::endl;
+    }
+}
+
+LoadEqualizer::Node* LoadEqualizer::_findLeaf( Node* node,
+                                               const Channel* channel )
+{
+    if( !node || !channel )
+        return 0;
+    if( node->compound )
+        return node->compound->getChannel() == channel ? node : 0;
+
+    Node* leaf = _findLeaf( node->left, channel );
+    return leaf ? leaf : _findLeaf( node->right, channel );
+}
+
+bool LoadEqualizer::_predictSplit( const Node* node, const float begin,
+                                   const float end, const float scale,
+                                   float& splitPos ) const
+{
+    if( !isPredictive() || scale <= 0.f || !node->left->model.isValid() ||
+        !node->right->model.isValid( ))
+    {
+        return false;
+    }
+
+    const float work = ( end - begin ) * scale;
+    const float share = LoadModel::split( node->left->model,
+                                          node->right->model, work );
+    splitPos = begin + share / scale;
+    return true;
+}
+
 float LoadEqualizer::_getTotalResources( ) const
 {
     const Compounds& children = getCompound()->getChildren();
@@ -342,6 +400,7 @@ void LoadEqualizer::_updateLeaf( Node* node )
     LBASSERT( channel );
     const PixelViewport& pvp = channel->getPixelViewport();
     node->resources = compound->isActive() ? compound->getUsage() : 0.f;
+    node->model = node->resources > 0.f ? node->fit : LoadModel();
     LBLOG( LOG_LB2 ) << channel->getName() << " active " << compound->isActive()
                      << " using " << node->resources << std::endl;
     LBASSERT( node->resources >= 0.f );
@@ -359,6 +418,7 @@ void LoadEqualizer::_updateLeaf( Node* node )
     if( getAssembleOnlyLimit() <= nResources - node->resources )
     {
         node->resources = 0.f;
+        node->model = LoadModel();
         return; // OPT
     }
 
@@ -367,6 +427,9 @@ void LoadEqualizer::_updateLeaf( Node* node )
     if( assembleTime == 0.f || node->resources == 0.f )
         return;
 
+    if( node->model.isValid( )) // compositing delays the destination channel
+        node->model.setOverhead( node->model.getOverhead() + assembleTime );
+
     const float timePerResource = time / ( nResources - node->resources );
     const float renderTime = timePerResource * node->resources ;
 
@@ -421,6 +484,7 @@ void LoadEqualizer::_updateNode( Node* node, const Viewport& vp,
     _update( right, rightVP, rightRange );
 
     node->resources = left->resources + right->resources;
+    node->model = LoadModel::combine( left->model, right->model );
 
     if( left->resources == 0.f )
     {
@@ -705,7 +769,12 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
             }
 
             LBLOG( LOG_LB2 ) << "Should split at X " << splitPos << std::endl;
-            if( getDamping() < 1.f )
+            if( _predictSplit( node, vp.x, end, vp.h, splitPos ))
+            {
+                LBLOG( LOG_LB2 ) << "Predicted split at X " << splitPos
+                                 << std::endl;
+            }
+            else if( getDamping() < 1.f )
                 splitPos = (1.f - getDamping()) * splitPos +
                             getDamping() * node->split;
             LBLOG( LOG_LB2 ) << "Dampened split at X " << splitPos << std::endl;
@@ -873,7 +942,12 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
             }
 
             LBLOG( LOG_LB2 ) << "Should split at Y " << splitPos << std::endl;
-            if( getDamping() < 1.f )
+            if( _predictSplit( node, vp.y, end, vp.w, splitPos ))
+            {
+                LBLOG( LOG_LB2 ) << "Predicted split at Y " << splitPos
+                                 << std::endl;
+            }
+            else if( getDamping() < 1.f )
                 splitPos = (1.f - getDamping( )) * splitPos +
                             getDamping() * node->split;
             LBLOG( LOG_LB2 ) << "Dampened split at Y " << splitPos << std::endl;
@@ -1013,7 +1087,13 @@ void LoadEqualizer::_computeSplit( Node* node, const float time,
                 }
             }
             LBLOG( LOG_LB2 ) << "Should split at " << splitPos << std::endl;
-            if( getDamping() < 1.f )
+            if( _predictSplit( node, range.start, range.end, vp.getArea(),
+                               splitPos ))
+            {
+                LBLOG( LOG_LB2 ) << "Predicted split at " << splitPos
+                                 << std::endl;
+            }
+            else if( getDamping() < 1.f )
                 splitPos = (1.f - getDamping( )) * splitPos +
                             getDamping() * node->split;
             LBLOG( LOG_LB2 ) << "Dampened split at " << splitPos << std::endl;
@@ -1075,6 +1155,7 @@ void LoadEqualizer::_assign( Compound* compound, const Viewport& vp,
     data.range   = range;
     data.channel = compound->getChannel();
     data.taskID  = compound->getTaskID();
+    data.work    = vp.getArea() * range.getSize();
 
     const Compound* destCompound = getCompound();
     if( destCompound->getChannel() == compound->getChannel( ))
@@ -1137,6 +1218,9 @@ std::ostream& operator << ( std::ostream& os, const LoadEqualizer* lb )
     if( lb->getResistancef() != .0f )
         os << "    resistance " << lb->getResistancef() << std::endl;
 
+    if( lb->isPredictive( ))
+        os << "    predictive ON" << std::endl;
+
     os << '}' << std::endl << lunchbox::enableFlush;
     return os;
 }
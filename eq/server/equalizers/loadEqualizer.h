@@ -21,6 +21,7 @@
 
 #include "../channelListener.h" // base class
 #include "equalizer.h"          // base class
+#include "loadModel.h"          // member
 
 #include <eq/fabric/range.h>    // member
 #include <eq/fabric/viewport.h> // member
@@ -80,6 +81,8 @@ private:
         float     resistancef;
         Vector2i  resistance2i;
         Vector2i  maxSize;
+        LoadModel fit;       //<! Fitted cost model (only on leafs)
+        LoadModel model;     //<! Cost model of subtree for the current frame
     };
     friend std::ostream& operator << ( std::ostream& os, const Node* node );
     typedef std::vector< Node* > LBNodes;
@@ -89,7 +92,7 @@ private:
     struct Data
     {
         Data() : channel( 0 ), taskID( 0 ), destTaskID( 0 )
-               , time( -1 ), assembleTime( 0 ) {}
+               , time( -1 ), assembleTime( 0 ), work( 0.f ) {}
         Channel* channel;
         uint32_t taskID;
         uint32_t destTaskID;
@@ -97,12 +100,14 @@ private:
         Range    range;
         int64_t  time;
         int64_t  assembleTime;
+        float    work; //<! assigned area * range
     };
 
     typedef std::vector< Data > LBDatas;
     typedef std::pair< uint32_t,  LBDatas > LBFrameData;
 
     std::deque< LBFrameData > _history;
+    uint32_t _modelFrame; //<! last frame used to fit the cost models
 
     //-------------------- Methods --------------------
     /** @return true if we have a valid LB tree */
@@ -124,6 +129,17 @@ private:
     /** Obsolete _history so that front-most item is youngest available. */
     void _checkHistory();
 
+    /** Fit the leaf cost models to the front-most _history, if complete. */
+    void _updateModels();
+    Node* _findLeaf( Node* node, const Channel* channel );
+
+    /**
+     * Compute the split between begin and end from the children's models.
+     * @return false if the split can't be predicted.
+     */
+    bool _predictSplit( const Node* node, float begin, float end,
+                        float scale, float& splitPos ) const;
+
     /** Update all node fields influencing the split */
     void _update( Node* node, const Viewport& vp, const Range& range );
     void _updateLeaf( Node* node );
@@ -0,0 +1,130 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "loadModel.h"
+
+#include <lunchbox/debug.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+const float _minRate = std::numeric_limits< float >::epsilon();
+// Minimum work variance, relative to the mean, to fit the overhead
+const float _minVariance = 1e-2f;
+// Relative prediction error which discards the previous samples
+const float _maxError = .2f;
+}
+
+LoadModel::LoadModel( const float history )
+    : _history( history )
+    , _nSamples( 0 )
+    , _weight( 0.f )
+    , _work( 0.f )
+    , _time( 0.f )
+    , _work2( 0.f )
+    , _workTime( 0.f )
+    , _overhead( 0.f )
+    , _rate( 0.f )
+{
+    LBASSERT( history >= 0.f && history < 1.f );
+}
+
+void LoadModel::addSample( const float work, const float time )
+{
+    if( work <= 0.f || time < 0.f )
+        return;
+
+    // The load changed, e.g., due to camera motion: start over from the new
+    // sample, keeping the last overhead estimate. A model fitted from one
+    // sample can't predict well, so it always gets a second sample.
+    if( _nSamples > 1 &&
+        std::abs( predict( work ) - time ) > _maxError * time )
+    {
+        _nSamples = 0;
+        _weight = _work = _time = _work2 = _workTime = 0.f;
+    }
+    ++_nSamples;
+
+    _weight   = _history * _weight   + 1.f;
+    _work     = _history * _work     + work;
+    _time     = _history * _time     + time;
+    _work2    = _history * _work2    + work * work;
+    _workTime = _history * _workTime + work * time;
+
+    const float meanWork = _work / _weight;
+    const float meanTime = _time / _weight;
+    const float variance = _work2 / _weight - meanWork * meanWork;
+
+    if( variance > _minVariance * meanWork * meanWork )
+    {
+        const float covariance = _workTime / _weight - meanWork * meanTime;
+        const float rate = covariance / variance;
+        const float overhead = meanTime - rate * meanWork;
+        if( rate > _minRate && overhead >= 0.f )
+        {
+            _rate = rate;
+            _overhead = overhead;
+            return;
+        }
+    }
+
+    // Not enough information for both parameters, keep the overhead
+    _overhead = std::min( _overhead, meanTime );
+    _rate = std::max( ( meanTime - _overhead ) / meanWork, _minRate );
+}
+
+LoadModel LoadModel::combine( const LoadModel& left, const LoadModel& right )
+{
+    if( !left.isValid( ))
+        return right;
+    if( !right.isValid( ))
+        return left;
+
+    // Both sides finish at T: work = (T - oL) / rL + (T - oR) / rR
+    LoadModel model( left );
+    model._rate = 1.f / ( 1.f / left._rate + 1.f / right._rate );
+    model._overhead = model._rate * ( left._overhead / left._rate +
+                                      right._overhead / right._rate );
+    return model;
+}
+
+float LoadModel::split( const LoadModel& left, const LoadModel& right,
+                        const float work )
+{
+    // oL + rL * x = oR + rR * ( work - x )
+    const float rates = left._rate + right._rate;
+    if( rates <= 0.f )
+        return work * .5f;
+
+    const float x = ( right._overhead - left._overhead + right._rate * work ) /
+                    rates;
+    return std::max( 0.f, std::min( x, work ));
+}
+
+std::ostream& operator << ( std::ostream& os, const LoadModel& model )
+{
+    os << model.getOverhead() << " ms + " << model.getRate() << " ms/work";
+    return os;
+}
+
+}
+}
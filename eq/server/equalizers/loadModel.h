@@ -0,0 +1,97 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQS_LOADMODEL_H
+#define EQS_LOADMODEL_H
+
+#include <eq/server/api.h>
+
+#include <iostream>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * A linear cost model of a rendering resource for the predictive
+ * LoadEqualizer.
+ *
+ * The model predicts the time to render a share of the work, i.e., the
+ * viewport area or range, as time = overhead + rate * work. It is fitted using
+ * least squares over all samples, where each sample's weight decays
+ * exponentially with its age. If the recent samples do not vary enough in work
+ * to separate the overhead from the rate, the overhead is kept and only the
+ * rate is updated.
+ */
+class LoadModel
+{
+public:
+    /**
+     * Construct a new, invalid model.
+     *
+     * @param history the weight of the previous samples for each new sample,
+     *                in [0, 1).
+     */
+    EQSERVER_API explicit LoadModel( float history = .5f );
+
+    /** Add the measured time in ms to render the given work. */
+    EQSERVER_API void addSample( float work, float time );
+
+    /** @return true if the model has samples. */
+    bool isValid() const { return _weight > 0.f; }
+
+    /** @return the fixed time of the resource in ms. */
+    float getOverhead() const { return _overhead; }
+
+    /** Add a fixed time to the prediction, e.g., for compositing. */
+    void setOverhead( const float overhead ) { _overhead = overhead; }
+
+    /** @return the time in ms per unit of work. */
+    float getRate() const { return _rate; }
+
+    /** @return the predicted time in ms to render the given work. */
+    float predict( const float work ) const { return _overhead + _rate * work; }
+
+    /**
+     * @return the model of two resources sharing work with a balanced split.
+     */
+    EQSERVER_API static LoadModel combine( const LoadModel& left,
+                                           const LoadModel& right );
+
+    /**
+     * @return the share of the given work for the left resource, so that both
+     *         resources finish at the same predicted time.
+     */
+    EQSERVER_API static float split( const LoadModel& left,
+                                     const LoadModel& right, float work );
+
+private:
+    float _history;
+    uint32_t _nSamples; //!< since the last change of the load
+    float _weight;   //!< sum of the sample weights
+    float _work;     //!< weighted sum of work
+    float _time;     //!< weighted sum of time
+    float _work2;    //!< weighted sum of work^2
+    float _workTime; //!< weighted sum of work * time
+    float _overhead;
+    float _rate;
+};
+
+EQSERVER_API std::ostream& operator << ( std::ostream& os, const LoadModel& );
+}
+}
+
+#endif // EQS_LOADMODEL_H
@@ -19,12 +19,15 @@
 
 #include "tileEqualizer.h"
 
+#include "../channel.h"
 #include "../compound.h"
 #include "../compoundVisitor.h"
 #include "../config.h"
 #include "../server.h"
 #include "../tileQueue.h"
 #include "../view.h"
+#include "../tiles/rasterStrategy.h"
+#include "../tiles/squareStrategy.h"
 
 namespace eq
 {
@@ -107,12 +110,37 @@ private:
     const std::string& _name;
 };
 
+class SourceChannelFinder : public CompoundVisitor
+{
+public:
+    explicit SourceChannelFinder( Channels& channels )
+        : CompoundVisitor()
+        , _channels( channels )
+    {}
+
+    /** Visit a leaf compound. */
+    virtual VisitorResult visitLeaf( Compound* compound )
+    {
+        Channel* channel = compound->getChannel();
+        if( channel && std::find( _channels.begin(), _channels.end(),
+                                  channel ) == _channels.end( ))
+        {
+            _channels.push_back( channel );
+        }
+        return TRAVERSE_CONTINUE;
+    }
+
+private:
+    Channels& _channels;
+};
+
 }
 
 TileEqualizer::TileEqualizer()
     : Equalizer()
     , _created( false )
     , _name( "TileEqualizer" )
+    , _strategy( STRATEGY_ZIGZAG )
 {
 }
 
@@ -120,10 +148,17 @@ TileEqualizer::TileEqualizer( const TileEqualizer& from )
     : Equalizer( from )
     , _created( from._created )
     , _name( from._name )
+    , _strategy( from._strategy )
+{
+}
+
+TileEqualizer::~TileEqualizer()
 {
+    for( Channel* channel : _channels )
+        channel->removeListener( this );
 }
 
-std::string TileEqualizer::_getQueueName() const
+std::string TileEqualizer::getQueueName() const
 {
     std::ostringstream name;
     name << "queue." << _name << (void*)this;
@@ -133,7 +168,7 @@ std::string TileEqualizer::_getQueueName() const
 void TileEqualizer::_createQueues( Compound* compound )
 {
     _created = true;
-    const std::string& name = _getQueueName();
+    const std::string& name = getQueueName();
     if( !_findQueue( name, compound->getOutputTileQueues( )))
     {
         TileQueue* output = new TileQueue;
@@ -148,11 +183,24 @@ void TileEqualizer::_createQueues( Compound* compound )
 
     InputQueueCreator creator( getTileSize(), name );
     compound->accept( creator );
+
+    if( _strategy != STRATEGY_COST )
+        return;
+
+    SourceChannelFinder finder( _channels );
+    compound->accept( finder );
+    for( Channel* channel : _channels )
+        channel->addListener( this );
 }
 
 void TileEqualizer::_destroyQueues( Compound* compound )
 {
-    const std::string& name = _getQueueName();
+    for( Channel* channel : _channels )
+        channel->removeListener( this );
+    _channels.clear();
+    _costs.clear();
+
+    const std::string& name = getQueueName();
     TileQueue* q = _findQueue( name, compound->getOutputTileQueues() );
     if ( q )
     {
@@ -178,6 +226,53 @@ void TileEqualizer::notifyUpdatePre( Compound* compound,
         _destroyQueues( compound );
 }
 
+void TileEqualizer::generateTiles( std::vector< Vector2i >& tiles,
+                                   const Vector2i& dim ) const
+{
+    switch( _strategy )
+    {
+      case STRATEGY_RASTER:
+          tiles::RasterStrategy()( tiles, dim );
+          break;
+      case STRATEGY_SQUARE:
+          tiles::SquareStrategy()( tiles, dim );
+          break;
+      case STRATEGY_COST:
+          tiles::generateByCost( tiles, dim, _costs );
+          break;
+      case STRATEGY_ZIGZAG:
+      default:
+          tiles::generateZigzag( tiles, dim );
+          break;
+    }
+}
+
+void TileEqualizer::notifyTileCosts( Channel*, const uint32_t,
+                                     const std::vector< PixelViewport >& tiles,
+                                     const std::vector< float >& times )
+{
+    const Vector2i& size = getTileSize();
+    if( size.x() <= 0 || size.y() <= 0 )
+        return;
+
+    // Costs arrive per source channel, after the queue for the next frame may
+    // already be filled. The latest measurement of each tile is used.
+    for( size_t i = 0; i < tiles.size() && i < times.size(); ++i )
+    {
+        const Vector2i tile( tiles[i].x / size.x(), tiles[i].y / size.y( ));
+        _costs[ tiles::getTileKey( tile )] = times[i];
+    }
+}
+
+std::ostream& operator << ( std::ostream& os,
+                            const TileEqualizer::Strategy strategy )
+{
+    os << ( strategy == TileEqualizer::STRATEGY_RASTER ? "RASTER" :
+            strategy == TileEqualizer::STRATEGY_SQUARE ? "SQUARE" :
+            strategy == TileEqualizer::STRATEGY_COST   ? "COST" : "ZIGZAG" );
+    return os;
+}
+
 std::ostream& operator << ( std::ostream& os, const TileEqualizer* lb )
 {
     if( lb )
@@ -186,8 +281,10 @@ std::ostream& operator << ( std::ostream& os, const TileEqualizer* lb )
            << "tile_equalizer" << std::endl
            << "{" << std::endl
            << "    name \"" << lb->getName() << "\"" << std::endl
-           << "    size " << lb->getTileSize() << std::endl
-           << "}" << std::endl << lunchbox::enableFlush;
+           << "    size " << lb->getTileSize() << std::endl;
+        if( lb->getStrategy() != TileEqualizer::STRATEGY_ZIGZAG )
+            os << "    strategy " << lb->getStrategy() << std::endl;
+        os << "}" << std::endl << lunchbox::enableFlush;
     }
     return os;
 }
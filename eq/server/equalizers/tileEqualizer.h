@@ -20,6 +20,8 @@
 #define EQS_TILEEQUALIZER_H
 
 #include "equalizer.h"
+#include "../channelListener.h" // base class
+#include "../tiles/costStrategy.h" // member
 
 namespace eq
 {
@@ -28,12 +30,21 @@ namespace server
 
 std::ostream& operator << ( std::ostream& os, const TileEqualizer* );
 
-class TileEqualizer : public Equalizer
+class TileEqualizer : public Equalizer, protected ChannelListener
 {
 public:
+    /** The order in which tiles are queued. */
+    enum Strategy
+    {
+        STRATEGY_ZIGZAG, //!< alternating rows
+        STRATEGY_RASTER, //!< rows from bottom to top
+        STRATEGY_SQUARE, //!< squares growing from the center
+        STRATEGY_COST //!< most expensive tiles of the last frame first
+    };
+
     EQSERVER_API TileEqualizer();
     TileEqualizer( const TileEqualizer& from );
-    ~TileEqualizer() {}
+    ~TileEqualizer();
 
     /** @sa CompoundListener::notifyUpdatePre */
     void notifyUpdatePre( Compound* compound,
@@ -44,21 +55,45 @@ public:
 
     const std::string& getName() const { return _name; }
 
+    void setStrategy( const Strategy strategy ) { _strategy = strategy; }
+    Strategy getStrategy() const { return _strategy; }
+
+    /** @return the name of the output tile queue of this equalizer. */
+    std::string getQueueName() const;
+
+    /** Append the tiles of a frame with dim tiles in queue order. */
+    void generateTiles( std::vector< Vector2i >& tiles,
+                        const Vector2i& dim ) const;
+
     uint32_t getType() const final { return fabric::TILE_EQUALIZER; }
 
 protected:
     void notifyChildAdded( Compound*, Compound* ) override {}
     void notifyChildRemove( Compound*, Compound* ) override {}
 
+    /** @sa ChannelListener::notifyLoadData */
+    void notifyLoadData( Channel*, uint32_t, const Statistics&,
+                         const Viewport& ) override {}
+
+    /** @sa ChannelListener::notifyTileCosts */
+    void notifyTileCosts( Channel* channel, uint32_t frameNumber,
+                          const std::vector< PixelViewport >& tiles,
+                          const std::vector< float >& times ) override;
+
 private:
-    std::string _getQueueName() const;
     void _destroyQueues( Compound* compound );
     void _createQueues( Compound* compound );
 
     bool _created;
     std::string _name;
+    Strategy _strategy;
+
+    Channels _channels; //!< source channels listened to for tile costs
+    tiles::TileCosts _costs;
 };
 
+std::ostream& operator << ( std::ostream& os, const TileEqualizer::Strategy );
+
 } //server
 } //eq
 
@@ -67,6 +67,8 @@ void Global::_setupDefaults()
 
     _configFAttributes[Config::FATTR_EYE_BASE]         = 0.05f;
     _configIAttributes[Config::IATTR_ROBUSTNESS]       = fabric::AUTO;
+    _configIAttributes[Config::IATTR_HINT_PARALLEL_TASKS] = fabric::AUTO;
+    _configIAttributes[Config::IATTR_HINT_STATISTICS]  = fabric::OFF;
 
     // node
     for( uint32_t i=0; i < Node::CATTR_ALL; ++i )
@@ -76,6 +78,8 @@ void Global::_setupDefaults()
 
     _nodeIAttributes[Node::IATTR_LAUNCH_TIMEOUT] = 60000; // ms
     _nodeIAttributes[Node::IATTR_HINT_AFFINITY] = fabric::AUTO;
+    _nodeIAttributes[Node::IATTR_HINT_TRANSMIT_THREADS] = fabric::AUTO;
+    _nodeIAttributes[Node::IATTR_HINT_TILE_PREFETCH] = fabric::AUTO;
     _nodeSAttributes[Node::SATTR_LAUNCH_COMMAND] =
         "ssh -n %h %c --eq-logfile %q%d/%h.%n.log%q";
 #ifdef WIN32
@@ -126,6 +130,9 @@ void Global::_setupDefaults()
     _channelIAttributes[Channel::IATTR_HINT_STATISTICS] = fabric::NICEST;
 #endif
     _channelIAttributes[Channel::IATTR_HINT_SENDTOKEN] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_BATCH_TRANSMIT] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_TRIM_TRANSMIT] = fabric::OFF;
+    _channelIAttributes[Channel::IATTR_HINT_DUMP_IMAGE] = fabric::ON;
 
     // compound
     for( uint32_t i=0; i<Compound::IATTR_ALL; ++i )
@@ -102,6 +102,9 @@
 %token EQTOKEN_GLOBAL
 %token EQTOKEN_CHANNEL_IATTR_HINT_STATISTICS
 %token EQTOKEN_CHANNEL_IATTR_HINT_SENDTOKEN
+%token EQTOKEN_CHANNEL_IATTR_HINT_BATCH_TRANSMIT
+%token EQTOKEN_CHANNEL_IATTR_HINT_TRIM_TRANSMIT
+%token EQTOKEN_CHANNEL_IATTR_HINT_DUMP_IMAGE
 %token EQTOKEN_CHANNEL_SATTR_DUMP_IMAGE
 %token EQTOKEN_COMPOUND_IATTR_STEREO_MODE
 %token EQTOKEN_COMPOUND_IATTR_STEREO_ANAGLYPH_LEFT_MASK
@@ -114,10 +117,14 @@
 %token EQTOKEN_CONNECTION_IATTR_PORT
 %token EQTOKEN_CONFIG_FATTR_EYE_BASE
 %token EQTOKEN_CONFIG_IATTR_ROBUSTNESS
+%token EQTOKEN_CONFIG_IATTR_HINT_PARALLEL_TASKS
+%token EQTOKEN_CONFIG_IATTR_HINT_STATISTICS
 %token EQTOKEN_NODE_SATTR_LAUNCH_COMMAND
 %token EQTOKEN_NODE_CATTR_LAUNCH_COMMAND_QUOTE
 %token EQTOKEN_NODE_IATTR_THREAD_MODEL
 %token EQTOKEN_NODE_IATTR_HINT_AFFINITY
+%token EQTOKEN_NODE_IATTR_HINT_TRANSMIT_THREADS
+%token EQTOKEN_NODE_IATTR_HINT_TILE_PREFETCH
 %token EQTOKEN_NODE_IATTR_HINT_STATISTICS
 %token EQTOKEN_NODE_IATTR_LAUNCH_TIMEOUT
 %token EQTOKEN_PIPE_IATTR_HINT_CUDA_GL_INTEROP
@@ -159,10 +166,16 @@
 %token EQTOKEN_HINT_DECORATION
 %token EQTOKEN_HINT_STATISTICS
 %token EQTOKEN_HINT_SENDTOKEN
+%token EQTOKEN_HINT_BATCH_TRANSMIT
+%token EQTOKEN_HINT_TRIM_TRANSMIT
+%token EQTOKEN_HINT_DUMP_IMAGE
+%token EQTOKEN_HINT_PARALLEL_TASKS
 %token EQTOKEN_HINT_SWAPSYNC
 %token EQTOKEN_HINT_DRAWABLE
 %token EQTOKEN_HINT_THREAD
 %token EQTOKEN_HINT_AFFINITY
+%token EQTOKEN_HINT_TRANSMIT_THREADS
+%token EQTOKEN_HINT_TILE_PREFETCH
 %token EQTOKEN_HINT_CUDA_GL_INTEROP
 %token EQTOKEN_HINT_SCREENSAVER
 %token EQTOKEN_HINT_GRAB_POINTER
@@ -287,9 +300,15 @@
 %token EQTOKEN_DB
 %token EQTOKEN_BOUNDARY
 %token EQTOKEN_RESISTANCE
+%token EQTOKEN_PREDICTIVE
 %token EQTOKEN_ZOOM
 %token EQTOKEN_MONO
 %token EQTOKEN_STEREO
+%token EQTOKEN_STRATEGY
+%token EQTOKEN_ZIGZAG
+%token EQTOKEN_RASTER
+%token EQTOKEN_SQUARE
+%token EQTOKEN_COST
 %token EQTOKEN_STRING
 %token EQTOKEN_CHARACTER
 %token EQTOKEN_FLOAT
@@ -310,6 +329,7 @@
     co::ConnectionType   _connectionType;
     eq::server::LoadEqualizer::Mode _loadEqualizerMode;
     eq::server::TreeEqualizer::Mode _treeEqualizerMode;
+    eq::server::TileEqualizer::Strategy _tileEqualizerStrategy;
     float                   _viewport[4];
 }
 
@@ -320,6 +340,7 @@
 %type <_connectionType>   connectionType;
 %type <_loadEqualizerMode> loadEqualizerMode;
 %type <_treeEqualizerMode> treeEqualizerMode;
+%type <_tileEqualizerStrategy> tileEqualizerStrategy;
 %type <_viewport>         viewport;
 %type <_float>            FLOAT;
 
@@ -375,6 +396,16 @@ global:
          eq::server::Global::instance()->setConfigIAttribute(
              eq::server::Config::IATTR_ROBUSTNESS, $2 );
      }
+     | EQTOKEN_CONFIG_IATTR_HINT_PARALLEL_TASKS IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_HINT_PARALLEL_TASKS, $2 );
+     }
+     | EQTOKEN_CONFIG_IATTR_HINT_STATISTICS IATTR
+     {
+         eq::server::Global::instance()->setConfigIAttribute(
+             eq::server::Config::IATTR_HINT_STATISTICS, $2 );
+     }
      | EQTOKEN_NODE_SATTR_LAUNCH_COMMAND STRING
      {
          eq::server::Global::instance()->setNodeSAttribute(
@@ -395,6 +426,16 @@ global:
          eq::server::Global::instance()->setNodeIAttribute(
              eq::server::Node::IATTR_HINT_AFFINITY, $2 );
      }
+     | EQTOKEN_NODE_IATTR_HINT_TRANSMIT_THREADS IATTR
+     {
+         eq::server::Global::instance()->setNodeIAttribute(
+             eq::server::Node::IATTR_HINT_TRANSMIT_THREADS, $2 );
+     }
+     | EQTOKEN_NODE_IATTR_HINT_TILE_PREFETCH IATTR
+     {
+         eq::server::Global::instance()->setNodeIAttribute(
+             eq::server::Node::IATTR_HINT_TILE_PREFETCH, $2 );
+     }
      | EQTOKEN_NODE_IATTR_LAUNCH_TIMEOUT UNSIGNED
      {
          eq::server::Global::instance()->setNodeIAttribute(
@@ -525,6 +566,21 @@ global:
          eq::server::Global::instance()->setChannelIAttribute(
              eq::server::Channel::IATTR_HINT_SENDTOKEN, $2 );
      }
+     | EQTOKEN_CHANNEL_IATTR_HINT_BATCH_TRANSMIT IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_BATCH_TRANSMIT, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_TRIM_TRANSMIT IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_TRIM_TRANSMIT, $2 );
+     }
+     | EQTOKEN_CHANNEL_IATTR_HINT_DUMP_IMAGE IATTR
+     {
+         eq::server::Global::instance()->setChannelIAttribute(
+             eq::server::Channel::IATTR_HINT_DUMP_IMAGE, $2 );
+     }
      | EQTOKEN_COMPOUND_IATTR_STEREO_MODE IATTR
      {
          eq::server::Global::instance()->setCompoundIAttribute(
@@ -605,6 +661,10 @@ configAttribute:
                              eq::server::Config::FATTR_EYE_BASE, $2 ); }
     | EQTOKEN_ROBUSTNESS IATTR { config->setIAttribute(
                                  eq::server::Config::IATTR_ROBUSTNESS, $2 ); }
+    | EQTOKEN_HINT_PARALLEL_TASKS IATTR { config->setIAttribute(
+                          eq::server::Config::IATTR_HINT_PARALLEL_TASKS, $2 ); }
+    | EQTOKEN_HINT_STATISTICS IATTR { config->setIAttribute(
+                              eq::server::Config::IATTR_HINT_STATISTICS, $2 ); }
 
 node: appNode | renderNode
 renderNode: EQTOKEN_NODE '{' {
@@ -662,6 +722,12 @@ nodeAttribute:
         }
     | EQTOKEN_HINT_AFFINITY IATTR
         { node->setIAttribute( eq::server::Node::IATTR_HINT_AFFINITY, $2 ); }
+    | EQTOKEN_HINT_TRANSMIT_THREADS IATTR
+        { node->setIAttribute( eq::server::Node::IATTR_HINT_TRANSMIT_THREADS,
+                               $2 ); }
+    | EQTOKEN_HINT_TILE_PREFETCH IATTR
+        { node->setIAttribute( eq::server::Node::IATTR_HINT_TILE_PREFETCH,
+                               $2 ); }
 
 
 pipe: EQTOKEN_PIPE '{'
@@ -782,6 +848,15 @@ channelAttribute:
     | EQTOKEN_HINT_SENDTOKEN IATTR
         { channel->setIAttribute( eq::server::Channel::IATTR_HINT_SENDTOKEN,
                                   $2 ); }
+    | EQTOKEN_HINT_BATCH_TRANSMIT IATTR
+        { channel->setIAttribute(
+                eq::server::Channel::IATTR_HINT_BATCH_TRANSMIT, $2 ); }
+    | EQTOKEN_HINT_TRIM_TRANSMIT IATTR
+        { channel->setIAttribute(
+                eq::server::Channel::IATTR_HINT_TRIM_TRANSMIT, $2 ); }
+    | EQTOKEN_HINT_DUMP_IMAGE IATTR
+        { channel->setIAttribute(
+                eq::server::Channel::IATTR_HINT_DUMP_IMAGE, $2 ); }
     | EQTOKEN_DUMP_IMAGE STRING
         { channel->setSAttribute( eq::server::Channel::SATTR_DUMP_IMAGE,
                                   $2 ); }
@@ -1211,6 +1286,8 @@ loadEqualizerField:
     | EQTOKEN_RESISTANCE '[' UNSIGNED UNSIGNED ']'
         { loadEqualizer->setResistance( eq::fabric::Vector2i( $3, $4 )); }
     | EQTOKEN_RESISTANCE FLOAT  { loadEqualizer->setResistance( $2 ); }
+    | EQTOKEN_PREDICTIVE IATTR
+        { loadEqualizer->setPredictive( $2 == eq::fabric::ON ); }
 
 loadEqualizerMode:
     EQTOKEN_2D           { $$ = eq::server::LoadEqualizer::MODE_2D; }
@@ -1240,6 +1317,14 @@ tileEqualizerField:
     EQTOKEN_NAME STRING                   { tileEqualizer->setName( $2 ); }
     | EQTOKEN_SIZE '[' UNSIGNED UNSIGNED ']'
                    { tileEqualizer->setTileSize( eq::fabric::Vector2i( $3, $4 )); }
+    | EQTOKEN_STRATEGY tileEqualizerStrategy
+                   { tileEqualizer->setStrategy( $2 ); }
+
+tileEqualizerStrategy:
+    EQTOKEN_ZIGZAG   { $$ = eq::server::TileEqualizer::STRATEGY_ZIGZAG; }
+    | EQTOKEN_RASTER { $$ = eq::server::TileEqualizer::STRATEGY_RASTER; }
+    | EQTOKEN_SQUARE { $$ = eq::server::TileEqualizer::STRATEGY_SQUARE; }
+    | EQTOKEN_COST   { $$ = eq::server::TileEqualizer::STRATEGY_COST; }
 
 swapBarrier:
     EQTOKEN_SWAPBARRIER '{' { swapBarrier = new eq::server::SwapBarrier; }
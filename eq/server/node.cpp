@@ -88,6 +88,7 @@ Node::Node( Config* parent )
     , _flushedFrame( 0 )
     , _state( STATE_STOPPED )
     , _bufferedTasks( new co::BufferConnection )
+    , _flushedBytes( 0 )
     , _lastDrawPipe( 0 )
 {
     const Global* global = Global::instance();
@@ -451,13 +452,14 @@ bool Node::syncConfigExit()
 //---------------------------------------------------------------------------
 // update
 //---------------------------------------------------------------------------
-void Node::update( const uint128_t& frameID, const uint32_t frameNumber )
+uint64_t Node::update( const uint128_t& frameID, const uint32_t frameNumber )
 {
     if( !isRunning( ))
-        return;
+        return 0;
 
     LBVERB << "Start frame " << frameNumber << std::endl;
     LBASSERT( isActive( ));
+    const uint64_t flushedBytes = _flushedBytes;
 
     _frameIDs[ frameNumber ] = frameID;
 
@@ -486,6 +488,7 @@ void Node::update( const uint128_t& frameID, const uint32_t frameNumber )
 
     _finish( frameNumber );
     flushSendBuffer();
+    return _flushedBytes - flushedBytes;
 }
 
 uint32_t Node::_getFinishLatency() const
@@ -639,7 +642,12 @@ EventOCommand Node::sendError( const uint32_t error )
 
 void Node::flushSendBuffer()
 {
-    _bufferedTasks->sendBuffer( _node->getConnection( ));
+    _flushedBytes += _bufferedTasks->getSize();
+    co::ConnectionPtr connection = _node ? _node->getConnection() : 0;
+    if( connection )
+        _bufferedTasks->sendBuffer( connection );
+    else // not launched, e.g., simulated
+        _bufferedTasks->getBuffer().setSize( 0 );
 }
 
 //===========================================================================
@@ -751,6 +759,10 @@ void Node::output( std::ostream& os ) const
         os << ( i== Node::IATTR_LAUNCH_TIMEOUT ? "launch_timeout       " :
                 i== Node::IATTR_THREAD_MODEL   ? "thread_model         " :
                 i== Node::IATTR_HINT_AFFINITY  ? "hint_affinity        " :
+                i== Node::IATTR_HINT_TRANSMIT_THREADS ?
+                                                 "hint_transmit_threads " :
+                i== Node::IATTR_HINT_TILE_PREFETCH ?
+                                                 "hint_tile_prefetch   " :
                 "ERROR" )
            << static_cast< fabric::IAttribute >( value ) << std::endl;
     }
@@ -129,8 +129,9 @@ public:
      * @param frameID a per-frame identifier passed to all rendering
      *                methods.
      * @param frameNumber the number of the frame.
+     * @return the number of bytes of the frame's task commands.
      */
-    void update( const uint128_t& frameID, const uint32_t frameNumber );
+    uint64_t update( const uint128_t& frameID, const uint32_t frameNumber );
 
     /**
      * Flush the processing of frames, including frameNumber.
@@ -275,6 +276,9 @@ private:
     /** Task commands for the current operation. */
     co::BufferConnectionPtr _bufferedTasks;
 
+    /** The number of bytes of all flushed task commands. */
+    uint64_t _flushedBytes;
+
     /** The last draw pipe for this entity */
     const Pipe* _lastDrawPipe;
 
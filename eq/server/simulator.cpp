@@ -0,0 +1,398 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "simulator.h"
+
+#include "canvas.h"
+#include "channel.h"
+#include "compound.h"
+#include "compoundUpdateActivateVisitor.h"
+#include "compoundUpdateDataVisitor.h"
+#include "config.h"
+#include "configUpdateDataVisitor.h"
+#include "node.h"
+#include "observer.h"
+#include "pipe.h"
+#include "window.h"
+
+#include <lunchbox/clock.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace eq
+{
+namespace server
+{
+namespace
+{
+const PixelViewport _defaultPVP( 0, 0, 1920, 1200 );
+
+/** Samples the draw time of all active rendering tasks of a frame. */
+class DrawVisitor : public CompoundVisitor
+{
+public:
+    DrawVisitor( const Simulator::CostModel& model, const Channels& channels,
+                 const uint32_t frameNumber )
+        : _model( model )
+        , _channels( channels )
+        , _frameNumber( frameNumber )
+        , _times( channels.size(), 0.f )
+        , _shares( channels.size(), 0.f )
+        , _statistics( channels.size( ))
+    {}
+
+    VisitorResult visit( Compound* compound ) override
+    {
+        if( !compound->isActive() ||
+            !compound->testInheritTask( fabric::TASK_DRAW ))
+        {
+            return TRAVERSE_CONTINUE;
+        }
+
+        Channel* channel = compound->getChannel();
+        const size_t index = std::find( _channels.begin(), _channels.end(),
+                                        channel ) - _channels.begin();
+        LBASSERT( index < _channels.size( ));
+
+        for( size_t i = 0; i < NUM_EYES; ++i )
+        {
+            const Eye eye = Eye( 1 << i );
+            if( !compound->isInheritActive( eye ))
+                continue;
+
+            const RenderContext context = compound->setupRenderContext( eye );
+            const float start = _times[ index ];
+            _times[ index ] += _model.getDrawTime( *channel, context,
+                                                   _frameNumber );
+            _shares[ index ] += context.vp.getArea() *
+                                context.range.getSize();
+
+            Statistic stat = Statistic();
+            stat.type = Statistic::CHANNEL_DRAW;
+            stat.frameNumber = _frameNumber;
+            stat.task = compound->getTaskID();
+            stat.startTime = int64_t( std::round( start ));
+            stat.endTime = int64_t( std::round( _times[ index ] ));
+            strncpy( stat.resourceName, channel->getName().c_str(),
+                     sizeof( stat.resourceName ) - 1 );
+            _statistics[ index ].push_back( stat );
+        }
+        return TRAVERSE_CONTINUE;
+    }
+
+    const std::vector< float >& getTimes() const { return _times; }
+    const std::vector< float >& getShares() const { return _shares; }
+    std::vector< Statistics >& getStatistics() { return _statistics; }
+
+private:
+    const Simulator::CostModel& _model;
+    const Channels& _channels;
+    const uint32_t _frameNumber;
+    std::vector< float > _times; //!< per channel, relative to frame start
+    std::vector< float > _shares;
+    std::vector< Statistics > _statistics;
+};
+}
+
+Simulator::HeatMap::HeatMap( const size_t width, const size_t height,
+                             const std::vector< float >& costs )
+    : _width( width )
+    , _height( height )
+    , _costs( costs )
+    , _motion( 0.f )
+{
+    LBASSERT( _costs.size() == _width * _height );
+}
+
+float Simulator::HeatMap::getDrawTime( const Channel& channel,
+                                       const RenderContext& context,
+                                       const uint32_t frameNumber ) const
+{
+    const float width = float( _width );
+    float offset = std::fmod( _motion * float( frameNumber ), width );
+    if( offset < 0.f )
+        offset += width;
+
+    // Integrate the cells covered by the viewport, in cell units
+    const Viewport& vp = context.vp;
+    const float x0 = vp.x * width + offset;
+    const float x1 = x0 + vp.w * width;
+    const float y0 = vp.y * float( _height );
+    const float y1 = y0 + vp.h * float( _height );
+
+    float time = 0.f;
+    for( size_t y = size_t( y0 ); y < _height && float( y ) < y1; ++y )
+    {
+        const float yCover = std::min( y1, float( y + 1 )) -
+                             std::max( y0, float( y ));
+        for( size_t x = size_t( x0 ); float( x ) < x1; ++x )
+        {
+            const float xCover = std::min( x1, float( x + 1 )) -
+                                 std::max( x0, float( x ));
+            time += _costs[ y * _width + x % _width ] * xCover * yCover;
+        }
+    }
+    time *= context.range.getSize();
+
+    std::map< std::string, float >::const_iterator i =
+        _speeds.find( channel.getName( ));
+    return i == _speeds.end() ? time : time / i->second;
+}
+
+Simulator::Simulator( Config& config, const CostModel& model )
+    : _config( config )
+    , _model( model )
+    , _frameNumber( 0 )
+    , _time( 0 )
+    , _generateTasks( false )
+{
+    LBASSERT( !config.isRunning( ));
+
+    for( Node* node : config.getNodes( ))
+    {
+        node->setState( STATE_RUNNING );
+        for( Pipe* pipe : node->getPipes( ))
+        {
+            if( !pipe->getPixelViewport().hasArea( ))
+                pipe->setPixelViewport( _defaultPVP );
+            pipe->setState( STATE_RUNNING );
+
+            for( Window* window : pipe->getWindows( ))
+            {
+                window->setState( STATE_RUNNING );
+                for( Channel* channel : window->getChannels( ))
+                {
+                    channel->setState( STATE_RUNNING );
+                    _channels.push_back( channel );
+                }
+            }
+        }
+    }
+    _shares.resize( _channels.size(), 0.f );
+
+    // as Config::_init, but without launching and initializing the nodes
+    for( Compound* compound : config.getCompounds( ))
+        compound->init();
+    for( Observer* observer : config.getObservers( ))
+        observer->init();
+    for( Canvas* canvas : config.getCanvases( ))
+        canvas->init();
+
+    _update( 0 );
+}
+
+Simulator::~Simulator()
+{
+    for( Canvas* canvas : _config.getCanvases( ))
+        canvas->exit();
+    for( Compound* compound : _config.getCompounds( ))
+        compound->exit();
+    for( Node* node : _config.getNodes( ))
+    {
+        for( Pipe* pipe : node->getPipes( ))
+        {
+            for( Window* window : pipe->getWindows( ))
+            {
+                for( Channel* channel : window->getChannels( ))
+                    channel->setState( STATE_STOPPED );
+                window->setState( STATE_STOPPED );
+            }
+            pipe->setState( STATE_STOPPED );
+        }
+        node->setState( STATE_STOPPED );
+    }
+}
+
+void Simulator::run( const uint32_t nFrames )
+{
+    const uint32_t latency = _config.getLatency();
+    for( uint32_t i = 0; i < nFrames; ++i )
+    {
+        ++_frameNumber;
+        if( _frameNumber > latency )
+            _deliver( _frameNumber - latency - 1 );
+
+        lunchbox::Clock clock;
+        _update( _frameNumber );
+        _updateTimes.push_back( clock.getTimef( ));
+
+        if( _generateTasks )
+        {
+            // as Config::_startFrame after the compound update
+            clock.reset();
+            ConfigUpdateDataVisitor configDataVisitor;
+            _config.accept( configDataVisitor );
+            const uint128_t frameID( 0, _frameNumber );
+            const uint64_t bytes = _config.updateNodes( frameID, _frameNumber );
+            _taskTimes.push_back( clock.getTimef( ));
+            _taskBytes.push_back( float( bytes ));
+        }
+
+        _render();
+    }
+}
+
+void Simulator::_update( const uint32_t frameNumber )
+{
+    // as Compound::update, without the output and input frames
+    for( Compound* compound : _config.getCompounds( ))
+    {
+        CompoundUpdateActivateVisitor activateVisitor( frameNumber );
+        compound->accept( activateVisitor );
+
+        CompoundUpdateDataVisitor dataVisitor( frameNumber );
+        compound->accept( dataVisitor );
+    }
+}
+
+void Simulator::_render()
+{
+    DrawVisitor visitor( _model, _channels, _frameNumber );
+    for( Compound* compound : _config.getCompounds( ))
+        compound->accept( visitor );
+
+    // channel times and imbalance
+    const std::vector< float >& times = visitor.getTimes();
+    float maxTime = 0.f;
+    float sumTime = 0.f;
+    size_t nChannels = 0;
+    for( const float time : times )
+    {
+        if( time <= 0.f )
+            continue;
+        maxTime = std::max( maxTime, time );
+        sumTime += time;
+        ++nChannels;
+    }
+    _imbalances.push_back( nChannels == 0 ? 0.f :
+                           maxTime * float( nChannels ) / sumTime - 1.f );
+
+    // work moved between the channels since the last frame
+    const std::vector< float >& shares = visitor.getShares();
+    float sumShares = 0.f;
+    for( const float share : shares )
+        sumShares += share;
+
+    float moved = 0.f;
+    for( size_t i = 0; i < shares.size(); ++i )
+    {
+        const float share = sumShares > 0.f ? shares[i] / sumShares : 0.f;
+        moved += std::abs( share - _shares[i] );
+        _shares[i] = share;
+    }
+    if( _frameNumber > 1 )
+        _movedWork.push_back( moved * .5f );
+
+    // make statistics absolute and queue them for delivery
+    std::vector< Statistics >& statistics = visitor.getStatistics();
+    for( Statistics& channelStatistics : statistics )
+    {
+        for( Statistic& stat : channelStatistics )
+        {
+            stat.startTime += _time;
+            stat.endTime += _time;
+        }
+    }
+    _time += int64_t( std::ceil( maxTime )) + 1;
+
+    _pending.push_back( FrameStatistics( ));
+    _pending.back().frameNumber = _frameNumber;
+    _pending.back().statistics.swap( statistics );
+}
+
+void Simulator::_deliver( const uint32_t frameNumber )
+{
+    while( !_pending.empty() && _pending.front().frameNumber <= frameNumber )
+    {
+        const FrameStatistics& frame = _pending.front();
+        for( size_t i = 0; i < _channels.size(); ++i )
+        {
+            const Statistics& statistics = frame.statistics[i];
+            if( !statistics.empty( ))
+                _channels[i]->fireLoadData( frame.frameNumber, statistics,
+                                            Viewport::FULL );
+        }
+        _pending.pop_front();
+    }
+}
+
+Simulator::Result Simulator::getResult( const float threshold ) const
+{
+    Result result;
+    result.frames = uint32_t( _imbalances.size( ));
+    result.convergence = result.frames;
+    result.imbalance = 0.f;
+    result.maxImbalance = 0.f;
+    result.stability = 0.f;
+    result.updateTime = 0.f;
+    result.taskTime = 0.f;
+    result.taskBytes = 0.f;
+
+    for( size_t i = 0; i < _imbalances.size(); ++i )
+    {
+        if( _imbalances[i] < threshold )
+        {
+            result.convergence = uint32_t( i );
+            break;
+        }
+    }
+
+    for( size_t i = result.convergence; i < _imbalances.size(); ++i )
+    {
+        result.imbalance += _imbalances[i];
+        result.maxImbalance = std::max( result.maxImbalance, _imbalances[i] );
+    }
+    if( result.convergence < result.frames )
+        result.imbalance /= float( result.frames - result.convergence );
+
+    for( const float moved : _movedWork )
+        result.stability += moved;
+    if( !_movedWork.empty( ))
+        result.stability /= float( _movedWork.size( ));
+
+    for( const float time : _updateTimes )
+        result.updateTime += time;
+    if( !_updateTimes.empty( ))
+        result.updateTime /= float( _updateTimes.size( ));
+
+    for( const float time : _taskTimes )
+        result.taskTime += time;
+    if( !_taskTimes.empty( ))
+        result.taskTime /= float( _taskTimes.size( ));
+
+    for( const float bytes : _taskBytes )
+        result.taskBytes += bytes;
+    if( !_taskBytes.empty( ))
+        result.taskBytes /= float( _taskBytes.size( ));
+    return result;
+}
+
+std::ostream& operator << ( std::ostream& os, const Simulator::Result& result )
+{
+    os << result.frames << " frames, converged after " << result.convergence
+       << ", imbalance " << result.imbalance * 100.f << "% (max "
+       << result.maxImbalance * 100.f << "%), moved "
+       << result.stability * 100.f << "% work/frame, update "
+       << result.updateTime << " ms/frame";
+    if( result.taskTime > 0.f )
+        os << ", tasks " << result.taskTime << " ms/frame "
+           << result.taskBytes / 1024.f << " KB/frame";
+    return os;
+}
+
+}
+}
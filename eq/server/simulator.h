@@ -0,0 +1,180 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_SIMULATOR_H
+#define EQSERVER_SIMULATOR_H
+
+#include <eq/server/api.h>
+#include "types.h"
+
+#include <boost/noncopyable.hpp>
+#include <deque>
+#include <iostream>
+#include <map>
+
+namespace eq
+{
+namespace server
+{
+/**
+ * Runs the equalizers of a loaded configuration without render clients.
+ *
+ * The simulator initializes the compounds of a stopped config as Config::init
+ * does, but marks all channels as running instead of launching nodes. Each
+ * frame updates the compounds and equalizers as Config::startFrame does,
+ * without distributing output frames and tile queues, and feeds the draw time
+ * of each rendering task given by a CostModel back to the equalizers as channel
+ * statistics. The statistics of a frame are delivered after the config latency,
+ * as by a render client.
+ *
+ * Optionally, the tasks of all nodes are generated each frame as by
+ * Config::startFrame, and discarded since the nodes are not launched.
+ *
+ * Configurations using tile equalizers are not supported, since they need
+ * registered tile queues.
+ */
+class Simulator : public boost::noncopyable
+{
+public:
+    /** The rendering cost of the simulated channels. */
+    class CostModel
+    {
+    public:
+        virtual ~CostModel() {}
+
+        /**
+         * @return the time in ms for the channel to draw the given rendering
+         *         task of a frame.
+         */
+        virtual float getDrawTime( const Channel& channel,
+                                   const RenderContext& context,
+                                   uint32_t frameNumber ) const = 0;
+    };
+
+    /**
+     * A cost model with a grid of costs over the destination channel.
+     *
+     * Each cell has the time to render its area of the destination with the
+     * full database range, which scales linearly with the rendered range.
+     */
+    class HeatMap : public CostModel
+    {
+    public:
+        /**
+         * Construct a new heat map.
+         *
+         * @param width the number of cells in x.
+         * @param height the number of cells in y.
+         * @param costs the time in ms of each cell, row by row from the bottom.
+         */
+        EQSERVER_API HeatMap( size_t width, size_t height,
+                              const std::vector< float >& costs );
+
+        /**
+         * Move the costs horizontally by the given number of cells per frame,
+         * wrapping around, to simulate camera motion.
+         */
+        void setMotion( const float cellsPerFrame ) { _motion = cellsPerFrame; }
+
+        /** Set the relative rendering speed of a channel, 1 by default. */
+        void setSpeed( const std::string& channelName, const float speed )
+            { _speeds[ channelName ] = speed; }
+
+        EQSERVER_API float getDrawTime( const Channel& channel,
+                                        const RenderContext& context,
+                                        uint32_t frameNumber ) const override;
+
+    private:
+        const size_t _width;
+        const size_t _height;
+        const std::vector< float > _costs;
+        float _motion;
+        std::map< std::string, float > _speeds;
+    };
+
+    /** The balancing quality and update cost of a simulation run. */
+    struct Result
+    {
+        uint32_t frames; //!< number of simulated frames
+        uint32_t convergence; //!< frames until the imbalance first fell below
+                              //!  the threshold, or frames if never
+        float imbalance; //!< mean imbalance from convergence on
+        float maxImbalance; //!< max imbalance from convergence on
+        float stability; //!< mean share of the work moved per frame
+        float updateTime; //!< mean CPU time of the compound update in ms
+        float taskTime; //!< mean CPU time of the task generation in ms
+        float taskBytes; //!< mean size of the task commands of a frame
+    };
+
+    /**
+     * Initialize the compounds of the given config for simulation.
+     *
+     * The config has to be loaded and converted, but not be initialized. Pipes
+     * without a pixel viewport get a 1920x1200 one.
+     */
+    EQSERVER_API Simulator( Config& config, const CostModel& model );
+
+    /** Exit the compounds of the config. */
+    EQSERVER_API ~Simulator();
+
+    /** Generate the tasks of all nodes each frame, off by default. */
+    void setTaskGeneration( const bool enable ) { _generateTasks = enable; }
+
+    /** Simulate the given number of frames. */
+    EQSERVER_API void run( uint32_t nFrames );
+
+    /**
+     * @return the result of all simulated frames, where the imbalance is the
+     *         max channel time over the mean channel time minus one.
+     */
+    EQSERVER_API Result getResult( float threshold = .1f ) const;
+
+    /** @return the imbalance of each simulated frame. */
+    const std::vector< float >& getImbalances() const { return _imbalances; }
+
+private:
+    Config& _config;
+    const CostModel& _model;
+    Channels _channels;
+    uint32_t _frameNumber;
+    int64_t _time; //!< simulated time in ms
+    bool _generateTasks;
+
+    struct FrameStatistics
+    {
+        uint32_t frameNumber;
+        std::vector< Statistics > statistics; //!< per channel
+    };
+    std::deque< FrameStatistics > _pending; //!< statistics not yet delivered
+    std::vector< float > _shares; //!< per-channel work share of last frame
+
+    std::vector< float > _imbalances;
+    std::vector< float > _movedWork;
+    std::vector< float > _updateTimes;
+    std::vector< float > _taskTimes;
+    std::vector< float > _taskBytes;
+
+    void _update( uint32_t frameNumber );
+    void _render();
+    void _deliver( uint32_t frameNumber );
+};
+
+EQSERVER_API std::ostream& operator << ( std::ostream& os,
+                                         const Simulator::Result& result );
+}
+}
+
+#endif // EQSERVER_SIMULATOR_H
@@ -0,0 +1,78 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EQSERVER_TILES_COSTSTRATEGY_H
+#define EQSERVER_TILES_COSTSTRATEGY_H
+
+#include "zigzagStrategy.h"
+
+#include <lunchbox/stdExt.h>
+#include <algorithm>
+#include <limits>
+
+namespace eq
+{
+namespace server
+{
+namespace tiles
+{
+/** The processing time in ms of each tile, indexed by getTileKey(). */
+typedef stde::hash_map< uint64_t, float > TileCosts;
+
+/** @return the cost map key of the tile at the given grid position. */
+inline uint64_t getTileKey( const Vector2i& tile )
+{
+    return ( uint64_t( uint32_t( tile.y( ))) << 32 ) | uint32_t( tile.x( ));
+}
+
+/**
+ * Generates tiles for a channel in longest-processing-time-first order.
+ *
+ * Tiles are sorted by decreasing cost of the previous frame, so that the
+ * expensive tiles do not end up as the last tiles of a frame. Tiles without a
+ * known cost are emitted first, and tiles of equal cost keep the zigzag order.
+ */
+inline void generateByCost( std::vector< Vector2i >& tiles,
+                            const Vector2i& dim, const TileCosts& costs )
+{
+    const size_t first = tiles.size();
+    generateZigzag( tiles, dim );
+    if( costs.empty( ))
+        return;
+
+    std::vector< std::pair< float, Vector2i > > sorted;
+    sorted.reserve( tiles.size() - first );
+    for( size_t i = first; i < tiles.size(); ++i )
+    {
+        TileCosts::const_iterator j = costs.find( getTileKey( tiles[i] ));
+        const float cost = j == costs.end() ?
+                               std::numeric_limits< float >::max() : j->second;
+        sorted.push_back( std::make_pair( cost, tiles[i] ));
+    }
+
+    std::stable_sort( sorted.begin(), sorted.end(),
+                      []( const std::pair< float, Vector2i >& a,
+                          const std::pair< float, Vector2i >& b )
+                          { return a.first > b.first; });
+
+    for( size_t i = 0; i < sorted.size(); ++i )
+        tiles[ first + i ] = sorted[i].second;
+}
+}
+}
+}
+
+#endif // EQSERVER_TILES_COSTSTRATEGY_H
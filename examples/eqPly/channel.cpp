@@ -598,6 +598,10 @@ void Channel::_drawModel( const Model* scene )
     state.setProjectionModelViewMatrix( projection * view * model );
     state.setRange( triply::Range( &getRange().start ));
 
+    const eq::PixelViewport& pvp = getPixelViewport();
+    state.setLODThreshold( frameData.getLODThreshold( ));
+    state.setViewportSize( float( pvp.w ), float( pvp.h ));
+
     const eq::Pipe* pipe = getPipe();
     const GLuint program = state.getProgram( pipe );
     if( program != VertexBufferState::INVALID )
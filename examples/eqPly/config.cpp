@@ -77,6 +77,7 @@ bool Config::init()
         _frameData.setColorMode( COLOR_WHITE );
 
     _frameData.setRenderMode( _initData.getRenderMode( ));
+    _frameData.setLODThreshold( _initData.getLODThreshold( ));
     registerObject( &_frameData );
     _frameData.setAutoObsolete( getLatency( ));
 
@@ -147,6 +148,8 @@ void Config::_loadModels()
 
             if( _initData.useInvertedFaces() )
                 model->useInvertedFaces();
+            if( _initData.useCompactModels( ))
+                model->useCompactData();
 
             if( !model->readFromFile( filename.c_str( )))
             {
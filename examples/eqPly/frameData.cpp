@@ -36,6 +36,7 @@ FrameData::FrameData()
     : _renderMode( triply::RENDER_MODE_DISPLAY_LIST )
     , _colorMode( COLOR_MODEL )
     , _quality( 1.0f )
+    , _lodThreshold( 0.f )
     , _ortho( false )
     , _statistics( false )
     , _help( false )
@@ -55,7 +56,7 @@ void FrameData::serialize( co::DataOStream& os, const uint64_t dirtyBits )
     if( dirtyBits & DIRTY_FLAGS )
         os << _modelID << _renderMode << _colorMode << _quality << _ortho
            << _statistics << _help << _wireframe << _pilotMode << _idle
-           << _compression;
+           << _compression << _lodThreshold;
     if( dirtyBits & DIRTY_VIEW )
         os << _currentViewID;
     if( dirtyBits & DIRTY_MESSAGE )
@@ -70,7 +71,7 @@ void FrameData::deserialize( co::DataIStream& is, const uint64_t dirtyBits )
     if( dirtyBits & DIRTY_FLAGS )
         is >> _modelID >> _renderMode >> _colorMode >> _quality >> _ortho
            >> _statistics >> _help >> _wireframe >> _pilotMode >> _idle
-           >> _compression;
+           >> _compression >> _lodThreshold;
     if( dirtyBits & DIRTY_VIEW )
         is >> _currentViewID;
     if( dirtyBits & DIRTY_MESSAGE )
@@ -107,6 +108,12 @@ void FrameData::setIdle( const bool idle )
     setDirty( DIRTY_FLAGS );
 }
 
+void FrameData::setLODThreshold( const float pixels )
+{
+    _lodThreshold = pixels;
+    setDirty( DIRTY_FLAGS );
+}
+
 void FrameData::toggleOrtho()
 {
     _ortho = !_ortho;
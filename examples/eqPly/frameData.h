@@ -58,6 +58,7 @@ public:
     void setColorMode( const ColorMode color );
     void setRenderMode( const triply::RenderMode mode );
     void setIdle( const bool idleMode );
+    void setLODThreshold( const float pixels );
 
     void toggleOrtho();
     void toggleStatistics();
@@ -80,6 +81,7 @@ public:
     bool isIdle() const { return _idle; }
     triply::RenderMode getRenderMode() const { return _renderMode; }
     bool useCompression() const { return _compression; }
+    float getLODThreshold() const { return _lodThreshold; }
     //*}
 
     /** @name Camera parameters. */
@@ -139,6 +141,7 @@ private:
     triply::RenderMode  _renderMode;
     ColorMode        _colorMode;
     float            _quality;
+    float            _lodThreshold;
     bool             _ortho;
     bool             _statistics;
     bool             _help;
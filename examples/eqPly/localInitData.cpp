@@ -48,6 +48,7 @@ LocalInitData::LocalInitData()
     , _maxFrames( 0xffffffffu )
     , _color( true )
     , _isResident( false )
+    , _compact( false )
 {
     _filenames.push_back( lunchbox::getRootPath() +
                           "/share/Equalizer/data" );
@@ -58,6 +59,7 @@ LocalInitData& LocalInitData::operator = ( const LocalInitData& from )
     _maxFrames   = from._maxFrames;
     _color       = from._color;
     _isResident  = from._isResident;
+    _compact     = from._compact;
     _filenames    = from._filenames;
     _pathFilename = from._pathFilename;
 
@@ -71,6 +73,7 @@ LocalInitData& LocalInitData::operator = ( const LocalInitData& from )
         disableLogo();
     if( !from.useROI( ))
         disableROI();
+    setLODThreshold( from.getLODThreshold( ));
 
     return *this;
 }
@@ -101,6 +104,7 @@ void LocalInitData::parseArguments( const int argc, char** argv )
     bool userDefinedInvertFaces( false );
     bool userDefinedDisableLogo( false );
     bool userDefinedDisableROI( false );
+    float userDefinedLODThreshold( 0.f );
 
     const std::string& desc = EqPly::getHelp();
     po::options_description options( desc + " Version " +
@@ -129,6 +133,10 @@ void LocalInitData::parseArguments( const int argc, char** argv )
         ( "invertFaces,i"
           , po::bool_switch(&userDefinedInvertFaces)->default_value( false ),
           "Invert faces (valid during binary file creation)" )
+        ( "compact", po::bool_switch(&_compact)->default_value( false ),
+          "Use quantized vertices and normals, and compressed indices" )
+        ( "lod", po::value<float>( &userDefinedLODThreshold ),
+          "Draw simplified meshes with the given max error in pixels" )
         ( "cameraPath,a", po::value<std::string>(&_pathFilename),
           "File containing camera path animation" )
         ( "noOverlay,o",
@@ -202,6 +210,9 @@ void LocalInitData::parseArguments( const int argc, char** argv )
 
     if( userDefinedDisableROI )
         disableROI();
+
+    if( userDefinedLODThreshold > 0.f )
+        setLODThreshold( userDefinedLODThreshold );
 }
 
 }
@@ -50,6 +50,7 @@ namespace eqPly
         uint32_t           getMaxFrames()    const { return _maxFrames; }
         bool               useColor()        const { return _color; }
         bool               isResident()      const { return _isResident; }
+        bool               useCompactModels() const { return _compact; }
 
         const std::vector< std::string >& getFilenames() const
             { return _filenames; }
@@ -62,6 +63,7 @@ namespace eqPly
         uint32_t    _maxFrames;
         bool        _color;
         bool        _isResident;
+        bool        _compact;
     };
 }
 
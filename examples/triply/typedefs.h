@@ -73,6 +73,7 @@ namespace triply
 // class forward declarations
 class VertexBufferBase;
 class VertexBufferData;
+class VertexBufferLeaf;
 class VertexBufferNode;
 class VertexBufferRoot;
 class VertexBufferState;
@@ -82,6 +83,8 @@ class VertexData;
 typedef vmml::Vector3f Vertex;
 typedef vmml::vector< 3, uint8_t > Color;
 typedef vmml::Vector3f Normal;
+typedef vmml::vector< 3, int16_t > QuantizedVertex; // relative to leaf box
+typedef vmml::vector< 2, int8_t > PackedNormal; // octahedral
 using vmml::Matrix4f;
 using vmml::Vector4f;
 typedef size_t Index;
@@ -133,7 +136,10 @@ typedef ArrayWrapper< float, 2 >    Range;
 const Index             LEAF_SIZE( 21845 );
 
 // binary mesh file version, increment if changing the file format
-const unsigned short    FILE_VERSION( 0x0118 );
+const unsigned short    FILE_VERSION( 0x011b );
+
+// alignment of the data arrays in the binary mesh file, used in place
+const size_t            FILE_ALIGNMENT( 16 );
 
 // enumeration for the sort axis
 enum Axis
@@ -34,6 +34,7 @@
 #include <triply/api.h>
 #include "typedefs.h"
 #include <fstream>
+#include <vector>
 
 namespace eqPly
 {
@@ -62,6 +63,11 @@ public:
     virtual VertexBufferBase* getLeft() { return 0; }
     virtual VertexBufferBase* getRight() { return 0; }
 
+    /*  @return the simplified proxy mesh of the subtree, or 0 if it has none,
+                and the max distance of its vertices to the full mesh.  */
+    virtual const VertexBufferBase* getLOD() const { return 0; }
+    virtual float getLODError() const { return 0.f; }
+
     TRIPLY_API virtual const BoundingSphere& updateBoundingSphere() = 0;
 
 protected:
@@ -94,6 +100,11 @@ protected:
 
     virtual void updateRange() = 0;
 
+    /*  Quantize the vertices relative to the leaf bounding boxes into the
+        given vector, @return the max position error.  */
+    virtual float quantize( std::vector< QuantizedVertex >& vertices ) const
+        = 0;
+
     friend class VertexBufferDist;
     BoundingSphere  _boundingSphere;
     Range           _range;
@@ -0,0 +1,169 @@
+/* Copyright (c) 2007, Tobias Wolf <twolf@access.unizh.ch>
+ *                    2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of Eyescale Software GmbH nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "vertexBufferData.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace triply
+{
+namespace
+{
+const float _maxQuantized = 32767.f;
+const float _maxPacked = 127.f;
+
+inline float _sign( const float value ) { return value < 0.f ? -1.f : 1.f; }
+
+/*  Fold the lower hemisphere of the octahedron onto the upper one.  */
+inline void _wrap( float& x, float& y )
+{
+    const float oldX = x;
+    x = ( 1.f - std::abs( y )) * _sign( oldX );
+    y = ( 1.f - std::abs( oldX )) * _sign( y );
+}
+}
+
+void getQuantization( const BoundingBox& box, Vertex& center, float& scale )
+{
+    center = ( box[0] + box[1] ) * .5f;
+    const Vertex size = box[1] - box[0];
+    const float halfSize = std::max( size.x(), std::max( size.y(), size.z( )))
+                           * .5f;
+    // uniform scale, so that normals are not distorted by the transformation
+    scale = halfSize > 0.f ? halfSize / _maxQuantized : 1.f;
+}
+
+QuantizedVertex quantize( const Vertex& vertex, const BoundingBox& box )
+{
+    Vertex center;
+    float scale;
+    getQuantization( box, center, scale );
+
+    QuantizedVertex result;
+    for( size_t i = 0; i < 3; ++i )
+    {
+        const float value = ( vertex[i] - center[i] ) / scale;
+        result[i] = int16_t( std::lround(
+                       std::max( -_maxQuantized, std::min( value,
+                                                           _maxQuantized ))));
+    }
+    return result;
+}
+
+Vertex dequantize( const QuantizedVertex& vertex, const BoundingBox& box )
+{
+    Vertex center;
+    float scale;
+    getQuantization( box, center, scale );
+    return Vertex( center.x() + float( vertex.x( )) * scale,
+                   center.y() + float( vertex.y( )) * scale,
+                   center.z() + float( vertex.z( )) * scale );
+}
+
+PackedNormal packNormal( const Normal& normal )
+{
+    const float length = std::abs( normal.x( )) + std::abs( normal.y( )) +
+                         std::abs( normal.z( ));
+    if( length <= 0.f )
+        return PackedNormal( 0, 0 );
+
+    float x = normal.x() / length;
+    float y = normal.y() / length;
+    if( normal.z() < 0.f )
+        _wrap( x, y );
+
+    x = std::max( -1.f, std::min( x, 1.f ));
+    y = std::max( -1.f, std::min( y, 1.f ));
+    return PackedNormal( int8_t( std::lround( x * _maxPacked )),
+                         int8_t( std::lround( y * _maxPacked )));
+}
+
+Normal unpackNormal( const PackedNormal& normal )
+{
+    float x = float( normal.x( )) / _maxPacked;
+    float y = float( normal.y( )) / _maxPacked;
+    const float z = 1.f - std::abs( x ) - std::abs( y );
+    if( z < 0.f )
+        _wrap( x, y );
+
+    Normal result( x, y, z );
+    result.normalize();
+    return result;
+}
+
+void encodeIndices( const ShortIndex* indices, const size_t nIndices,
+                    std::vector< uint8_t >& bytes )
+{
+    bytes.clear();
+    bytes.reserve( nIndices * 2 );
+
+    int32_t previous = 0;
+    for( size_t i = 0; i < nIndices; ++i )
+    {
+        const int32_t delta = int32_t( indices[i] ) - previous;
+        previous = indices[i];
+
+        // zigzag, then 7 bits per byte with the high bit set if more follow
+        uint32_t value = uint32_t(( delta << 1 ) ^ ( delta >> 31 ));
+        while( value >= 0x80 )
+        {
+            bytes.push_back( uint8_t( value | 0x80 ));
+            value >>= 7;
+        }
+        bytes.push_back( uint8_t( value ));
+    }
+}
+
+bool decodeIndices( const uint8_t* bytes, const size_t nBytes,
+                    const size_t nIndices, std::vector< ShortIndex >& indices )
+{
+    indices.resize( nIndices );
+
+    const uint8_t* const end = bytes + nBytes;
+    int32_t previous = 0;
+    for( size_t i = 0; i < nIndices; ++i )
+    {
+        uint32_t value = 0;
+        for( unsigned shift = 0; ; shift += 7 )
+        {
+            if( bytes == end || shift > 21 )
+                return false;
+            const uint8_t byte = *bytes++;
+            value |= uint32_t( byte & 0x7f ) << shift;
+            if( !( byte & 0x80 ))
+                break;
+        }
+
+        previous += int32_t( value >> 1 ) ^ -int32_t( value & 1 );
+        indices[i] = ShortIndex( previous );
+    }
+    return bytes == end;
+}
+
+}
@@ -31,14 +31,103 @@
 #define PLYLIB_VERTEXBUFFERDATA_H
 
 
+#include <triply/api.h>
 #include "typedefs.h"
 #include <vector>
 #include <fstream>
 
 
-namespace triply 
-{    
-    /** Holds the final kd-tree data, sorted and reindexed.  */
+namespace triply
+{
+    /**
+     * An array of kd-tree data, either owned or a read-only view into a
+     * memory-mapped binary file.
+     */
+    template< class T > class MappedVector
+    {
+    public:
+        MappedVector() : _data( 0 ), _size( 0 ) {}
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        const T* data() const { return _data; }
+        const T& operator[]( const size_t i ) const { return _data[i]; }
+
+        /*  Append a value, the data has to be owned.  */
+        void push_back( const T& value )
+        {
+            PLYLIBASSERT( _size == _vector.size( ));
+            _vector.push_back( value );
+            _data = &_vector[0];
+            _size = _vector.size();
+        }
+
+        void clear()
+        {
+            _vector.clear();
+            _data = 0;
+            _size = 0;
+        }
+
+        /*  Take over the contents of the given vector.  */
+        void swap( std::vector< T >& vector )
+        {
+            clear();
+            _vector.swap( vector );
+            _data = _vector.empty() ? 0 : &_vector[0];
+            _size = _vector.size();
+        }
+
+        /*  Use the given memory, which has to stay valid, without copying.  */
+        void map( const T* data, const size_t size )
+        {
+            clear();
+            _data = data;
+            _size = size;
+        }
+
+    private:
+        MappedVector( const MappedVector& ) = delete;
+        MappedVector& operator=( const MappedVector& ) = delete;
+
+        std::vector< T > _vector;
+        const T*         _data;
+        size_t           _size;
+    };
+
+    /*  Quantize a vertex relative to the given leaf bounding box.  */
+    TRIPLY_API QuantizedVertex quantize( const Vertex& vertex,
+                                         const BoundingBox& box );
+
+    /*  @return the vertex of a quantized vertex in the given leaf box.  */
+    TRIPLY_API Vertex dequantize( const QuantizedVertex& vertex,
+                                  const BoundingBox& box );
+
+    /*  Get the center and the scale transforming quantized vertices into
+        the given leaf bounding box.  */
+    TRIPLY_API void getQuantization( const BoundingBox& box, Vertex& center,
+                                     float& scale );
+
+    /*  Octahedral encoding of unit normals into two bytes.  */
+    TRIPLY_API PackedNormal packNormal( const Normal& normal );
+    TRIPLY_API Normal unpackNormal( const PackedNormal& normal );
+
+    /*  Delta-encode the indices as zigzag variable-length integers.  */
+    TRIPLY_API void encodeIndices( const ShortIndex* indices, size_t nIndices,
+                                   std::vector< uint8_t >& bytes );
+
+    /*  Decode nIndices delta-encoded indices, @return false on error.  */
+    TRIPLY_API bool decodeIndices( const uint8_t* bytes, size_t nBytes,
+                                   size_t nIndices,
+                                   std::vector< ShortIndex >& indices );
+
+    /**
+     * Holds the final kd-tree data, sorted and reindexed.
+     *
+     * Compact data replaces the vertices and normals by vertices quantized
+     * relative to the bounding box of their leaf and octahedral normals, and
+     * stores delta-encoded indices.
+     */
     class VertexBufferData
     {
     public:
@@ -48,62 +137,124 @@ namespace triply
             colors.clear();
             normals.clear();
             indices.clear();
+            quantizedVertices.clear();
+            packedNormals.clear();
         }
-        
+
+        bool isCompact() const { return !quantizedVertices.empty(); }
+
         /*  Write the vectors' sizes and contents to the given stream.  */
         void toStream( std::ostream& os )
         {
-            writeVector( os, vertices );
+            size_t compact = isCompact();
+            os.write( reinterpret_cast< char* >( &compact ), sizeof( size_t ));
+            if( !compact )
+            {
+                writeVector( os, vertices );
+                writeVector( os, colors );
+                writeVector( os, normals );
+                writeVector( os, indices );
+                return;
+            }
+
+            writeVector( os, quantizedVertices );
             writeVector( os, colors );
-            writeVector( os, normals );
-            writeVector( os, indices );
+            writeVector( os, packedNormals );
+
+            size_t nIndices = indices.size();
+            os.write( reinterpret_cast< char* >( &nIndices ), sizeof( size_t ));
+            std::vector< uint8_t > bytes;
+            encodeIndices( indices.data(), nIndices, bytes );
+            MappedVector< uint8_t > packedIndices;
+            packedIndices.swap( bytes );
+            writeVector( os, packedIndices );
         }
-        
-        /*  Read the vectors' sizes and contents from the given MMF address.  */
+
+        /*  Map the vectors' contents at the given MMF address, which has to
+            stay mapped while the data is used. Delta-encoded indices are
+            decoded.  */
         void fromMemory( char** addr )
         {
             clear();
-            readVector( addr, vertices );
+            size_t compact;
+            memRead( reinterpret_cast< char* >( &compact ), addr,
+                     sizeof( size_t ));
+            if( !compact )
+            {
+                readVector( addr, vertices );
+                readVector( addr, colors );
+                readVector( addr, normals );
+                readVector( addr, indices );
+                return;
+            }
+
+            readVector( addr, quantizedVertices );
             readVector( addr, colors );
-            readVector( addr, normals );
-            readVector( addr, indices );
+            readVector( addr, packedNormals );
+
+            size_t nIndices;
+            memRead( reinterpret_cast< char* >( &nIndices ), addr,
+                     sizeof( size_t ));
+            MappedVector< uint8_t > packedIndices;
+            readVector( addr, packedIndices );
+
+            std::vector< ShortIndex > decoded;
+            if( !decodeIndices( packedIndices.data(), packedIndices.size(),
+                                nIndices, decoded ))
+            {
+                throw MeshException( "Error reading binary file. Invalid "
+                                     "delta-encoded indices." );
+            }
+            indices.swap( decoded );
         }
-        
-        std::vector< Vertex >       vertices;
-        std::vector< Color >        colors;
-        std::vector< Normal >       normals;
-        std::vector< ShortIndex >   indices;
-        
+
+        MappedVector< Vertex >      vertices;
+        MappedVector< Color >       colors;
+        MappedVector< Normal >      normals;
+        MappedVector< ShortIndex >  indices;
+
+        MappedVector< QuantizedVertex > quantizedVertices;
+        MappedVector< PackedNormal >    packedNormals;
+
     private:
-        /*  Helper function to write a vector to output stream.  */
+        /*  @return the padding from the given offset to the next array.  */
+        static size_t getPadding( const size_t offset )
+        {
+            return ( FILE_ALIGNMENT - offset % FILE_ALIGNMENT ) %
+                   FILE_ALIGNMENT;
+        }
+
+        /*  Helper function to write a vector to output stream. The contents
+            are aligned relative to the stream start.  */
         template< class T >
-        void writeVector( std::ostream& os, std::vector< T >& v )
+        void writeVector( std::ostream& os, const MappedVector< T >& v )
         {
             size_t length = v.size();
-            os.write( reinterpret_cast< char* >( &length ), 
+            os.write( reinterpret_cast< char* >( &length ),
                       sizeof( size_t ) );
+
+            static const char padding[ FILE_ALIGNMENT ] = { 0 };
+            os.write( padding, getPadding( size_t( os.tellp( ))));
+
             if( length > 0 )
-                os.write( reinterpret_cast< char* >( &v[0] ), 
+                os.write( reinterpret_cast< const char* >( v.data( )),
                           length * sizeof( T ) );
         }
-        
-        /*  Helper function to read a vector from the MMF address.  */
+
+        /*  Helper function to map a vector from the MMF address. The file is
+            mapped page-aligned, so the stream offsets align the address.  */
         template< class T >
-        void readVector( char** addr, std::vector< T >& v )
+        void readVector( char** addr, MappedVector< T >& v )
         {
             size_t length;
-            memRead( reinterpret_cast< char* >( &length ), addr, 
+            memRead( reinterpret_cast< char* >( &length ), addr,
                      sizeof( size_t ) );
-            if( length > 0 )
-            {
-                v.resize( length );
-                memRead( reinterpret_cast< char* >( &v[0] ), addr, 
-                         length * sizeof( T ) );
-            }
+            *addr += getPadding( reinterpret_cast< size_t >( *addr ));
+
+            v.map( reinterpret_cast< const T* >( *addr ), length );
+            *addr += length * sizeof( T );
         }
     };
-    
-    
 }
 
 
@@ -34,6 +34,26 @@
 
 namespace triply
 {
+namespace
+{
+/*  Serialize an array as the std::vector it is deserialized to.  */
+template< class T >
+void _writeArray( co::DataOStream& os, const MappedVector< T >& array )
+{
+    const uint64_t nElems = array.size();
+    os << nElems;
+    if( nElems > 0 )
+        os << co::Array< const T >( array.data(), nElems );
+}
+
+template< class T >
+void _readArray( co::DataIStream& is, MappedVector< T >& array )
+{
+    std::vector< T > vector;
+    is >> vector;
+    array.swap( vector );
+}
+}
 
 VertexBufferDist::VertexBufferDist()
     : _root( 0 )
@@ -136,8 +156,37 @@ void VertexBufferDist::getInstanceData( co::DataOStream& os )
             LBASSERT( _root );
             const VertexBufferData& data = _root->_data;
 
-            os << data.vertices << data.colors << data.normals << data.indices
-               << _root->_name;
+            const bool compact = data.isCompact();
+            os << compact;
+            if( compact )
+            {
+                std::vector< uint8_t > indices;
+                encodeIndices( data.indices.data(), data.indices.size(),
+                               indices );
+                _writeArray( os, data.quantizedVertices );
+                _writeArray( os, data.colors );
+                _writeArray( os, data.packedNormals );
+                os << uint64_t( data.indices.size( )) << indices;
+            }
+            else
+            {
+                _writeArray( os, data.vertices );
+                _writeArray( os, data.colors );
+                _writeArray( os, data.normals );
+                _writeArray( os, data.indices );
+            }
+            os << _root->_name;
+        }
+
+        const VertexBufferNode* node =
+            static_cast< const VertexBufferNode* >( _node );
+        const VertexBufferLeaf* lod = node->_lod;
+        os << bool( lod );
+        if( lod )
+        {
+            os << node->_lodError;
+            _writeLeaf( os, *lod );
+            os << lod->_boundingSphere << lod->_range;
         }
     }
     else
@@ -145,12 +194,7 @@ void VertexBufferDist::getInstanceData( co::DataOStream& os )
         os << eq::uint128_t() << eq::uint128_t();
 
         LBASSERT( dynamic_cast< const VertexBufferLeaf* >( _node ));
-        const VertexBufferLeaf* leaf =
-            static_cast< const VertexBufferLeaf* >( _node );
-
-        os << leaf->_boundingBox[0] << leaf->_boundingBox[1]
-           << uint64_t( leaf->_vertexStart ) << uint64_t( leaf->_indexStart )
-           << uint64_t( leaf->_indexLength ) << leaf->_vertexLength;
+        _writeLeaf( os, *static_cast< const VertexBufferLeaf* >( _node ));
     }
 
     os << _node->_boundingSphere << _node->_range;
@@ -173,8 +217,29 @@ void VertexBufferDist::applyInstanceData( co::DataIStream& is )
             VertexBufferRoot* root = new VertexBufferRoot;
             VertexBufferData& data = root->_data;
 
-            is >> data.vertices >> data.colors >> data.normals >> data.indices
-               >> root->_name;
+            const bool compact = is.read< bool >();
+            if( compact )
+            {
+                _readArray( is, data.quantizedVertices );
+                _readArray( is, data.colors );
+                _readArray( is, data.packedNormals );
+
+                const uint64_t nIndices = is.read< uint64_t >();
+                std::vector< uint8_t > bytes;
+                std::vector< ShortIndex > indices;
+                is >> bytes;
+                LBCHECK( decodeIndices( bytes.data(), bytes.size(), nIndices,
+                                        indices ));
+                data.indices.swap( indices );
+            }
+            else
+            {
+                _readArray( is, data.vertices );
+                _readArray( is, data.colors );
+                _readArray( is, data.normals );
+                _readArray( is, data.indices );
+            }
+            is >> root->_name;
 
             node  = root;
             _root = root;
@@ -185,6 +250,14 @@ void VertexBufferDist::applyInstanceData( co::DataIStream& is )
             node = new VertexBufferNode;
         }
 
+        if( is.read< bool >( ))
+        {
+            is >> node->_lodError;
+            node->_lod = new VertexBufferLeaf( _root->_data );
+            _readLeaf( is, *node->_lod );
+            is >> node->_lod->_boundingSphere >> node->_lod->_range;
+        }
+
         base   = node;
         _left  = new VertexBufferDist( _root, 0 );
         _right = new VertexBufferDist( _root, 0 );
@@ -203,14 +276,7 @@ void VertexBufferDist::applyInstanceData( co::DataIStream& is )
         LBASSERT( !_isRoot );
         VertexBufferData& data = _root->_data;
         VertexBufferLeaf* leaf = new VertexBufferLeaf( data );
-
-        uint64_t i1, i2, i3;
-        is >> leaf->_boundingBox[0] >> leaf->_boundingBox[1]
-           >> i1 >> i2 >> i3 >> leaf->_vertexLength;
-        leaf->_vertexStart = size_t( i1 );
-        leaf->_indexStart = size_t( i2 );
-        leaf->_indexLength = size_t( i3 );
-
+        _readLeaf( is, *leaf );
         base = leaf;
     }
 
@@ -220,4 +286,22 @@ void VertexBufferDist::applyInstanceData( co::DataIStream& is )
     _node = base;
 }
 
+void VertexBufferDist::_writeLeaf( co::DataOStream& os,
+                                   const VertexBufferLeaf& leaf )
+{
+    os << leaf._boundingBox[0] << leaf._boundingBox[1]
+       << uint64_t( leaf._vertexStart ) << uint64_t( leaf._indexStart )
+       << uint64_t( leaf._indexLength ) << leaf._vertexLength;
+}
+
+void VertexBufferDist::_readLeaf( co::DataIStream& is, VertexBufferLeaf& leaf )
+{
+    uint64_t i1, i2, i3;
+    is >> leaf._boundingBox[0] >> leaf._boundingBox[1]
+       >> i1 >> i2 >> i3 >> leaf._vertexLength;
+    leaf._vertexStart = size_t( i1 );
+    leaf._indexStart = size_t( i2 );
+    leaf._indexLength = size_t( i3 );
+}
+
 }
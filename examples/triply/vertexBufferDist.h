@@ -60,6 +60,9 @@ protected:
     TRIPLY_API virtual void applyInstanceData( co::DataIStream& is );
 
 private:
+    static void _writeLeaf( co::DataOStream& os, const VertexBufferLeaf& leaf );
+    static void _readLeaf( co::DataIStream& is, VertexBufferLeaf& leaf );
+
     VertexBufferRoot* _root;
     VertexBufferBase* _node;
     VertexBufferDist* _left;
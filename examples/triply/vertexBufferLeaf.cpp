@@ -32,19 +32,22 @@
 #include "vertexBufferData.h"
 #include "vertexBufferState.h"
 #include "vertexData.h"
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <set>
 
 namespace triply
 {
 
-/*  Finish partial setup - sort, reindex and merge into global data.  */
+/*  Finish partial setup - reindex and merge into global data. The triangles
+    are already sorted, see VertexBufferNode::sortTree().  */
 void VertexBufferLeaf::setupTree( VertexData& data, const Index start,
-                                  const Index length, const Axis axis,
+                                  const Index length, const Axis /*axis*/,
                                   const size_t depth,
                                   VertexBufferData& globalData,
                                   boost::progress_display& progress )
 {
-    data.sort( start, length, axis );
     _vertexStart = globalData.vertices.size();
     _vertexLength = 0;
     _indexStart = globalData.indices.size();
@@ -183,6 +186,185 @@ void VertexBufferLeaf::updateRange()
     _range[1] = _range[0] + 1.0f * _indexLength / _globalData.indices.size();
 }
 
+/*  Quantize the leaf's vertices relative to its bounding box.  */
+float VertexBufferLeaf::quantize( std::vector< QuantizedVertex >& vertices )
+    const
+{
+    float maxError = 0.f;
+    for( Index i = _vertexStart; i < _vertexStart + _vertexLength; ++i )
+    {
+        const Vertex& vertex = _globalData.vertices[i];
+        vertices[i] = triply::quantize( vertex, _boundingBox );
+
+        const Vertex error = dequantize( vertices[i], _boundingBox ) - vertex;
+        maxError = std::max( maxError, error.length( ));
+    }
+    return maxError;
+}
+
+/*  Set up the leaf as the simplified proxy of two leaves or proxies, by
+    clustering their vertices on a grid over their bounding box, which is
+    coarsened until at most a quarter of their triangles remain. @return the
+    max distance of a vertex to its cluster, or a negative value if no useful
+    proxy remains.  */
+float VertexBufferLeaf::setupProxy( const VertexBufferLeaf& left,
+                                    const VertexBufferLeaf& right )
+{
+    const VertexBufferLeaf* const sources[2] = { &left, &right };
+    BoundingBox box = left._boundingBox;
+    for( size_t i = 0; i < 3; ++i )
+    {
+        box[0][i] = std::min( box[0][i], right._boundingBox[0][i] );
+        box[1][i] = std::max( box[1][i], right._boundingBox[1][i] );
+    }
+    const Vertex size = box[1] - box[0];
+    const float extent = std::max( size.x(), std::max( size.y(), size.z( )));
+    const Index maxTriangles =
+        std::min( LEAF_SIZE, ( left._indexLength + right._indexLength ) / 12 );
+    if( extent <= 0.f || maxTriangles == 0 )
+        return -1.f;
+
+    // the cluster of each source vertex, and the remaining triangles with
+    // 21 bit cluster indices, rotated to start with the smallest index
+    std::vector< Index > clusters[2];
+    std::set< uint64_t > triangles;
+    size_t nClusters = 0;
+    for( size_t resolution = 64; ; resolution /= 2 )
+    {
+        std::map< size_t, Index > cells;
+        for( size_t s = 0; s < 2; ++s )
+        {
+            const VertexBufferLeaf& source = *sources[s];
+            clusters[s].resize( source._vertexLength );
+            for( Index i = 0; i < source._vertexLength; ++i )
+            {
+                const Vertex& vertex =
+                    _globalData.vertices[ source._vertexStart + i ];
+                size_t cell = 0;
+                for( size_t j = 0; j < 3; ++j )
+                {
+                    const float pos = ( vertex[j] - box[0][j] ) / extent;
+                    const size_t k = size_t( std::max( 0.f, pos ) *
+                                             float( resolution ));
+                    cell = cell * resolution + std::min( k, resolution - 1 );
+                }
+                clusters[s][i] =
+                    cells.insert( std::make_pair( cell, cells.size( )))
+                        .first->second;
+            }
+        }
+
+        triangles.clear();
+        for( size_t s = 0; s < 2; ++s )
+        {
+            const VertexBufferLeaf& source = *sources[s];
+            for( Index i = 0; i < source._indexLength; i += 3 )
+            {
+                Index c[3];
+                for( size_t j = 0; j < 3; ++j )
+                    c[j] = clusters[s][ _globalData.indices[
+                                            source._indexStart + i + j ]];
+                if( c[0] == c[1] || c[1] == c[2] || c[0] == c[2] )
+                    continue; // collapsed
+
+                while( c[0] > c[1] || c[0] > c[2] )
+                {
+                    const Index first = c[0];
+                    c[0] = c[1];
+                    c[1] = c[2];
+                    c[2] = first;
+                }
+                triangles.insert( uint64_t( c[0] ) << 42 |
+                                  uint64_t( c[1] ) << 21 | uint64_t( c[2] ));
+            }
+        }
+
+        nClusters = cells.size();
+        if( triangles.size() <= maxTriangles || resolution <= 2 )
+            break;
+    }
+    if( triangles.empty() || triangles.size() > maxTriangles )
+        return -1.f;
+
+    // average the vertices of each cluster
+    const bool hasColors = !_globalData.colors.empty();
+    std::vector< Vertex > positions( nClusters, Vertex( 0.f ));
+    std::vector< Normal > normals( nClusters, Normal( 0.f ));
+    std::vector< Vertex > colors( hasColors ? nClusters : 0, Vertex( 0.f ));
+    std::vector< float > counts( nClusters, 0.f );
+    for( size_t s = 0; s < 2; ++s )
+    {
+        const VertexBufferLeaf& source = *sources[s];
+        for( Index i = 0; i < source._vertexLength; ++i )
+        {
+            const Index cluster = clusters[s][i];
+            const Index j = source._vertexStart + i;
+            positions[ cluster ] += _globalData.vertices[j];
+            normals[ cluster ] += _globalData.normals[j];
+            if( hasColors )
+            {
+                const Color& color = _globalData.colors[j];
+                colors[ cluster ] += Vertex( color[0], color[1], color[2] );
+            }
+            ++counts[ cluster ];
+        }
+    }
+    for( size_t i = 0; i < nClusters; ++i )
+    {
+        positions[i] /= counts[i];
+        if( hasColors )
+            colors[i] /= counts[i];
+        if( normals[i].squared_length() > 0.f )
+            normals[i].normalize();
+    }
+
+    float maxError = 0.f;
+    for( size_t s = 0; s < 2; ++s )
+    {
+        const VertexBufferLeaf& source = *sources[s];
+        for( Index i = 0; i < source._vertexLength; ++i )
+        {
+            const Vertex error = positions[ clusters[s][i] ] -
+                _globalData.vertices[ source._vertexStart + i ];
+            maxError = std::max( maxError, error.length( ));
+        }
+    }
+
+    // append the referenced clusters and the triangles to the global data
+    _vertexStart = _globalData.vertices.size();
+    _vertexLength = 0;
+    _indexStart = _globalData.indices.size();
+    _indexLength = 0;
+
+    std::map< Index, ShortIndex > newIndex;
+    for( std::set< uint64_t >::const_iterator i = triangles.begin();
+         i != triangles.end(); ++i )
+    {
+        for( size_t j = 0; j < 3; ++j )
+        {
+            const Index cluster = Index(( *i >> ( 42 - j * 21 )) & 0x1fffff );
+            if( newIndex.find( cluster ) == newIndex.end( ))
+            {
+                newIndex[ cluster ] = _vertexLength++;
+                PLYLIBASSERT( _vertexLength );
+                _globalData.vertices.push_back( positions[ cluster ] );
+                _globalData.normals.push_back( normals[ cluster ] );
+                if( hasColors )
+                {
+                    const Vertex& color = colors[ cluster ];
+                    _globalData.colors.push_back(
+                        Color( uint8_t( color[0] + .5f ),
+                               uint8_t( color[1] + .5f ),
+                               uint8_t( color[2] + .5f )));
+                }
+            }
+            _globalData.indices.push_back( newIndex[ cluster ] );
+            ++_indexLength;
+        }
+    }
+    return maxError;
+}
+
 #define glewGetContext state.glewGetContext
 
 /*  Set up rendering of the leaf nodes.  */
@@ -197,18 +379,35 @@ void VertexBufferLeaf::setupRendering( VertexBufferState& state,
     case RENDER_MODE_BUFFER_OBJECT:
     {
         const char* charThis = reinterpret_cast< const char* >( this );
+        const bool compact = _globalData.isCompact();
 
         if( data[VERTEX_OBJECT] == state.INVALID )
             data[VERTEX_OBJECT] = state.newBufferObject( charThis + 0 );
         glBindBuffer( GL_ARRAY_BUFFER, data[VERTEX_OBJECT] );
-        glBufferData( GL_ARRAY_BUFFER, _vertexLength * sizeof( Vertex ),
-                        &_globalData.vertices[_vertexStart], GL_STATIC_DRAW );
+        if( compact )
+            glBufferData( GL_ARRAY_BUFFER,
+                          _vertexLength * sizeof( QuantizedVertex ),
+                          &_globalData.quantizedVertices[_vertexStart],
+                          GL_STATIC_DRAW );
+        else
+            glBufferData( GL_ARRAY_BUFFER, _vertexLength * sizeof( Vertex ),
+                          &_globalData.vertices[_vertexStart], GL_STATIC_DRAW );
 
         if( data[NORMAL_OBJECT] == state.INVALID )
             data[NORMAL_OBJECT] = state.newBufferObject( charThis + 1 );
         glBindBuffer( GL_ARRAY_BUFFER, data[NORMAL_OBJECT] );
-        glBufferData( GL_ARRAY_BUFFER, _vertexLength * sizeof( Normal ),
-                        &_globalData.normals[_vertexStart], GL_STATIC_DRAW );
+        if( compact )
+        {
+            // GL_BYTE normals, since vertex arrays can't decode octahedral
+            std::vector< GLbyte > normals( _vertexLength * 3 );
+            for( Index i = 0; i < _vertexLength; ++i )
+                getByteNormal( _vertexStart + i, &normals[ i * 3 ] );
+            glBufferData( GL_ARRAY_BUFFER, normals.size(), &normals[0],
+                          GL_STATIC_DRAW );
+        }
+        else
+            glBufferData( GL_ARRAY_BUFFER, _vertexLength * sizeof( Normal ),
+                          &_globalData.normals[_vertexStart], GL_STATIC_DRAW );
 
         if( data[COLOR_OBJECT] == state.INVALID )
             data[COLOR_OBJECT] = state.newBufferObject( charThis + 2 );
@@ -253,19 +452,35 @@ void VertexBufferLeaf::draw( VertexBufferState& state ) const
         return;
 
     state.updateRegion( _boundingBox );
+
+    // compact vertices are transformed into the bounding box
+    const bool compact = _globalData.isCompact();
+    if( compact )
+    {
+        Vertex center;
+        float scale;
+        getQuantization( _boundingBox, center, scale );
+        glPushMatrix();
+        glTranslatef( center.x(), center.y(), center.z( ));
+        glScalef( scale, scale, scale );
+    }
+
     switch( state.getRenderMode() )
     {
       case RENDER_MODE_IMMEDIATE:
           renderImmediate( state );
-          return;
+          break;
       case RENDER_MODE_BUFFER_OBJECT:
           renderBufferObject( state );
-          return;
+          break;
       case RENDER_MODE_DISPLAY_LIST:
       default:
           renderDisplayList( state );
-          return;
+          break;
     }
+
+    if( compact )
+        glPopMatrix();
 }
 
 /*  Render the leaf with buffer objects.  */
@@ -287,10 +502,11 @@ void VertexBufferLeaf::renderBufferObject( VertexBufferState& state ) const
         glBindBuffer( GL_ARRAY_BUFFER, buffers[COLOR_OBJECT] );
         glColorPointer( 3, GL_UNSIGNED_BYTE, 0, 0 );
     }
+    const bool compact = _globalData.isCompact();
     glBindBuffer( GL_ARRAY_BUFFER, buffers[NORMAL_OBJECT] );
-    glNormalPointer( GL_FLOAT, 0, 0 );
+    glNormalPointer( compact ? GL_BYTE : GL_FLOAT, 0, 0 );
     glBindBuffer( GL_ARRAY_BUFFER, buffers[VERTEX_OBJECT] );
-    glVertexPointer( 3, GL_FLOAT, 0, 0 );
+    glVertexPointer( 3, compact ? GL_SHORT : GL_FLOAT, 0, 0 );
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, buffers[INDEX_OBJECT] );
     glDrawElements( GL_TRIANGLES, GLsizei(_indexLength), GL_UNSIGNED_SHORT, 0 );
 }
@@ -317,19 +533,39 @@ void VertexBufferLeaf::renderDisplayList( VertexBufferState& state ) const
 inline
 void VertexBufferLeaf::renderImmediate( VertexBufferState& state ) const
 {
+    const bool compact = _globalData.isCompact();
     glBegin( GL_TRIANGLES );
     for( Index offset = 0; offset < _indexLength; ++offset )
     {
         const Index i =_vertexStart + _globalData.indices[_indexStart + offset];
         if( state.useColors() )
             glColor3ubv( &_globalData.colors[i][0] );
-        glNormal3fv( &_globalData.normals[i][0] );
-        glVertex3fv( &_globalData.vertices[i][0] );
+        if( compact )
+        {
+            GLbyte normal[3];
+            getByteNormal( i, normal );
+            glNormal3bv( normal );
+            glVertex3sv( &_globalData.quantizedVertices[i][0] );
+        }
+        else
+        {
+            glNormal3fv( &_globalData.normals[i][0] );
+            glVertex3fv( &_globalData.vertices[i][0] );
+        }
     }
     glEnd();
 }
 
 
+/*  Decode a packed normal for rendering.  */
+void VertexBufferLeaf::getByteNormal( const Index i, GLbyte* normal ) const
+{
+    const Normal decoded = unpackNormal( _globalData.packedNormals[i] );
+    for( size_t j = 0; j < 3; ++j )
+        normal[j] = GLbyte( std::lround( decoded[j] * 127.f ));
+}
+
+
 /*  Read leaf node from memory.  */
 void VertexBufferLeaf::fromMemory( char** addr, VertexBufferData& globalData )
 {
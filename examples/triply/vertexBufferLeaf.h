@@ -57,14 +57,19 @@ protected:
                             boost::progress_display& );
     virtual const BoundingSphere& updateBoundingSphere();
     virtual void updateRange();
+    virtual float quantize( std::vector< QuantizedVertex >& vertices ) const;
 
 private:
     void setupRendering( VertexBufferState& state, GLuint* data ) const;
     void renderImmediate( VertexBufferState& state ) const;
     void renderDisplayList( VertexBufferState& state ) const;
     void renderBufferObject( VertexBufferState& state ) const;
+    void getByteNormal( Index i, GLbyte* normal ) const;
+    float setupProxy( const VertexBufferLeaf& left,
+                      const VertexBufferLeaf& right );
 
     friend class VertexBufferDist;
+    friend class VertexBufferNode;
     VertexBufferData&   _globalData;
     BoundingBox         _boundingBox;
     Index               _vertexStart;
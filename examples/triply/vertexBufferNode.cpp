@@ -32,6 +32,8 @@
 #include "vertexBufferLeaf.h"
 #include "vertexBufferState.h"
 #include "vertexData.h"
+
+#include <algorithm>
 #include <set>
 
 namespace triply
@@ -42,8 +44,15 @@ VertexBufferNode::~VertexBufferNode()
 {
     delete _left;
     delete _right;
+    delete _lod;
     _left = 0;
     _right = 0;
+    _lod = 0;
+}
+
+const VertexBufferBase* VertexBufferNode::getLOD() const
+{
+    return _lod;
 }
 
 inline static bool _subdivide( const Index length, const size_t depth )
@@ -51,14 +60,147 @@ inline static bool _subdivide( const Index length, const size_t depth )
     return ( length > LEAF_SIZE ) || ( depth < 3 && length > 1 );
 }
 
-/*  Continue kd-tree setup, create intermediary or leaf nodes as required.  */
+namespace
+{
+/*  A triangle with its centroid, computed once for sorting.  */
+struct Entry
+{
+    Vertex   centroid;
+    Triangle triangle;
+};
+
+/*  Orders triangles as VertexData::sort, and by their vertex indices if the
+    centroids are equal to get the same tree regardless of scheduling.  */
+class EntryLess
+{
+public:
+    explicit EntryLess( const Axis axis ) : _axis( axis ) {}
+
+    bool operator() ( const Entry& e1, const Entry& e2 ) const
+    {
+        int axis = _axis;
+        do
+        {
+            if( e1.centroid[axis] != e2.centroid[axis] )
+                return e1.centroid[axis] < e2.centroid[axis];
+            axis = ( axis + 1 ) % 3;
+        }
+        while( axis != _axis );
+
+        for( size_t i = 0; i < 3; ++i )
+            if( e1.triangle[i] != e2.triangle[i] )
+                return e1.triangle[i] < e2.triangle[i];
+        return false;
+    }
+
+private:
+    const int _axis;
+};
+
+/*  Same as VertexData::getLongestAxis for a range of entries.  */
+Axis _getLongestAxis( const VertexData& data, const Entry* entries,
+                      const Index length )
+{
+    BoundingBox bb;
+    bb[0] = data.vertices[ entries[0].triangle[0] ];
+    bb[1] = data.vertices[ entries[0].triangle[0] ];
+
+    for( Index t = 0; t < length; ++t )
+        for( size_t v = 0; v < 3; ++v )
+            for( size_t i = 0; i < 3; ++i )
+            {
+                const Vertex& vertex = data.vertices[ entries[t].triangle[v] ];
+                bb[0][i] = std::min( bb[0][i], vertex[i] );
+                bb[1][i] = std::max( bb[1][i], vertex[i] );
+            }
+
+    const GLfloat bbX = bb[1][0] - bb[0][0];
+    const GLfloat bbY = bb[1][1] - bb[0][1];
+    const GLfloat bbZ = bb[1][2] - bb[0][2];
+
+    if( bbX >= bbY && bbX >= bbZ )
+        return AXIS_X;
+
+    if( bbY >= bbX && bbY >= bbZ )
+        return AXIS_Y;
+
+    return AXIS_Z;
+}
+
+void _sortNode( const VertexData* data, Entry* entries, Index length,
+                Axis axis, size_t depth );
+
+/*  Sort a child of a node at the given depth.  */
+void _sortChild( const VertexData* data, Entry* entries, const Index length,
+                 const size_t depth )
+{
+    if( length == 0 )
+        return;
+
+    if( _subdivide( length, depth ))
+        _sortNode( data, entries, length,
+                   _getLongestAxis( *data, entries, length ), depth + 1 );
+    else // leaf, sorted completely along the x axis
+        std::sort( entries, entries + length, EntryLess( AXIS_X ));
+}
+
+/*  Partition a node's range at its median and sort the children
+    concurrently. Only the median split matters for the children, which
+    sort their halves again.  */
+void _sortNode( const VertexData* data, Entry* entries, const Index length,
+                const Axis axis, const size_t depth )
+{
+    const Index leftLength = length / 2;
+    const Index rightLength = ( length + 1 ) / 2;
+    std::nth_element( entries, entries + leftLength, entries + length,
+                      EntryLess( axis ));
+
+#if _OPENMP >= 200805 // tasks need OpenMP 3.0
+#  pragma omp task if( leftLength > LEAF_SIZE )
+#endif
+    _sortChild( data, entries, leftLength, depth );
+    _sortChild( data, entries + leftLength, rightLength, depth );
+}
+}
+
+/*  Sort the triangles into the order of the kd-tree leaves.  */
+void VertexBufferNode::sortTree( VertexData& data, const Axis axis )
+{
+    const Index length = data.triangles.size();
+    std::vector< Entry > entries( length );
+
+#pragma omp parallel for
+    for( ssize_t i = 0; i < ssize_t( length ); ++i )
+    {
+        Entry& entry = entries[i];
+        entry.triangle = data.triangles[i];
+
+        const Vertex& v1 = data.vertices[ entry.triangle[0] ];
+        const Vertex& v2 = data.vertices[ entry.triangle[1] ];
+        const Vertex& v3 = data.vertices[ entry.triangle[2] ];
+        for( size_t j = 0; j < 3; ++j )
+            entry.centroid[j] = ( v1[j] + v2[j] + v3[j] ) / 3.0f;
+    }
+
+#pragma omp parallel
+    {
+#pragma omp single
+        _sortNode( &data, entries.data(), length, axis, 0 );
+    }
+
+#pragma omp parallel for
+    for( ssize_t i = 0; i < ssize_t( length ); ++i )
+        data.triangles[i] = entries[i].triangle;
+}
+
+/*  Continue kd-tree setup, create intermediary or leaf nodes as required. The
+    triangles have to be in tree order, see sortTree().  */
 void VertexBufferNode::setupTree( VertexData& data, const Index start,
                                   const Index length, const Axis axis,
                                   const size_t depth,
                                   VertexBufferData& globalData,
                                   boost::progress_display& progress )
 {
-    data.sort( start, length, axis );
     const Index median = start + ( length / 2 );
 
     // left child will include elements smaller than the median
@@ -79,18 +221,12 @@ void VertexBufferNode::setupTree( VertexData& data, const Index start,
     else
         _right = new VertexBufferLeaf( globalData );
 
-    // move to next axis and continue contruction in the child nodes
-    const Axis newAxisLeft  = subdivideLeft ?
-                        data.getLongestAxis( start , leftLength  ) : AXIS_X;
-
-    const Axis newAxisRight = subdivideRight ?
-                        data.getLongestAxis( median, rightLength ) : AXIS_X;
-
+    // continue contruction in the child nodes
     static_cast< VertexBufferNode* >
-            ( _left )->setupTree( data, start, leftLength, newAxisLeft, depth+1,
+            ( _left )->setupTree( data, start, leftLength, axis, depth+1,
                                   globalData, progress );
     static_cast< VertexBufferNode* >
-        ( _right )->setupTree( data, median, rightLength, newAxisRight, depth+1,
+        ( _right )->setupTree( data, median, rightLength, axis, depth+1,
                                globalData, progress );
     if( depth == 3 )
         ++progress;
@@ -135,6 +271,55 @@ void VertexBufferNode::updateRange()
 }
 
 
+/*  Build the proxy from the children's proxies, or from the leaves.  */
+void VertexBufferNode::setupLOD( VertexBufferData& globalData )
+{
+    VertexBufferBase* const children[2] = { _left, _right };
+    const VertexBufferLeaf* meshes[2] = { 0, 0 };
+    float childError = 0.f;
+
+    for( size_t i = 0; i < 2; ++i )
+    {
+        if( children[i]->getLeft( ))
+        {
+            VertexBufferNode* child =
+                static_cast< VertexBufferNode* >( children[i] );
+            child->setupLOD( globalData );
+            meshes[i] = child->_lod;
+            childError = std::max( childError, child->_lodError );
+        }
+        else
+            meshes[i] = static_cast< const VertexBufferLeaf* >( children[i] );
+    }
+    if( !meshes[0] || !meshes[1] )
+        return;
+
+    VertexBufferLeaf* lod = new VertexBufferLeaf( globalData );
+    const float error = lod->setupProxy( *meshes[0], *meshes[1] );
+    if( error < 0.f )
+    {
+        delete lod;
+        return;
+    }
+
+    lod->updateBoundingSphere();
+    lod->_range = _range;
+    _lod = lod;
+    _lodError = error + childError;
+}
+
+
+/*  Quantize the vertices of the children and of the proxy.  */
+float VertexBufferNode::quantize( std::vector< QuantizedVertex >& vertices )
+    const
+{
+    const float error = std::max(
+        static_cast< const VertexBufferNode* >( _left )->quantize( vertices ),
+        static_cast< const VertexBufferNode* >( _right )->quantize( vertices ));
+    return _lod ? std::max( error, _lod->quantize( vertices )) : error;
+}
+
+
 /*  Draw the node by rendering the children.  */
 void VertexBufferNode::draw( VertexBufferState& state ) const
 {
@@ -157,6 +342,17 @@ void VertexBufferNode::fromMemory( char** addr, VertexBufferData& globalData )
                              "node, but found something else instead." );
     VertexBufferBase::fromMemory( addr, globalData );
 
+    // read proxy, if any
+    size_t hasLOD;
+    memRead( reinterpret_cast< char* >( &hasLOD ), addr, sizeof( size_t ) );
+    if( hasLOD )
+    {
+        memRead( reinterpret_cast< char* >( &_lodError ), addr,
+                 sizeof( float ));
+        _lod = new VertexBufferLeaf( globalData );
+        _lod->fromMemory( addr, globalData );
+    }
+
     // read left child (peek ahead)
     memRead( reinterpret_cast< char* >( &nodeType ), addr, sizeof( size_t ) );
     if( nodeType != NODE_TYPE && nodeType != LEAF_TYPE )
@@ -189,6 +385,14 @@ void VertexBufferNode::toStream( std::ostream& os )
     size_t nodeType = NODE_TYPE;
     os.write( reinterpret_cast< char* >( &nodeType ), sizeof( size_t ) );
     VertexBufferBase::toStream( os );
+
+    size_t hasLOD = _lod ? 1 : 0;
+    os.write( reinterpret_cast< char* >( &hasLOD ), sizeof( size_t ) );
+    if( _lod )
+    {
+        os.write( reinterpret_cast< char* >( &_lodError ), sizeof( float ));
+        _lod->toStream( os );
+    }
     static_cast< VertexBufferNode* >( _left )->toStream( os );
     static_cast< VertexBufferNode* >( _right )->toStream( os );
 }
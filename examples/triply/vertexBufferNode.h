@@ -39,7 +39,8 @@ namespace triply
 class VertexBufferNode : public VertexBufferBase
 {
 public:
-    VertexBufferNode() : _left( 0 ), _right( 0 ) {}
+    VertexBufferNode()
+        : _left( 0 ), _right( 0 ), _lod( 0 ), _lodError( 0.f ) {}
     TRIPLY_API virtual ~VertexBufferNode();
 
     TRIPLY_API void draw( VertexBufferState& state ) const override;
@@ -51,6 +52,9 @@ public:
     VertexBufferBase* getLeft() override { return _left; }
     VertexBufferBase* getRight() override { return _right; }
 
+    TRIPLY_API const VertexBufferBase* getLOD() const override;
+    float getLODError() const override { return _lodError; }
+
 protected:
     TRIPLY_API void toStream( std::ostream& os ) override;
     TRIPLY_API void fromMemory( char** addr, VertexBufferData& globalData )
@@ -63,11 +67,28 @@ protected:
                                boost::progress_display& ) override;
     TRIPLY_API const BoundingSphere& updateBoundingSphere() override;
     TRIPLY_API void updateRange() override;
+    TRIPLY_API float quantize( std::vector< QuantizedVertex >& vertices ) const
+        override;
+
+    /**
+     * Build the simplified proxy meshes of the subtree bottom-up by vertex
+     * clustering, appending them to the global data after the leaves. Call
+     * after updateRange(), since the ranges only cover the leaves.
+     */
+    TRIPLY_API void setupLOD( VertexBufferData& globalData );
+
+    /**
+     * Sort the triangles into the order of the kd-tree leaves, with the
+     * subtrees sorted in parallel, as needed by setupTree().
+     */
+    TRIPLY_API static void sortTree( VertexData& data, Axis axis );
 
 private:
     friend class VertexBufferDist;
     VertexBufferBase*   _left;
     VertexBufferBase*   _right;
+    VertexBufferLeaf*   _lod;
+    float               _lodError;
 };
 }
 #endif // PLYLIB_VERTEXBUFFERNODE_H
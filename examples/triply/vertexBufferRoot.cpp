@@ -32,6 +32,9 @@
 #include "vertexBufferState.h"
 #include "vertexData.h"
 #include <vmmlib/frustumCuller.hpp>
+#include <algorithm>
+#include <cmath>
+#include <deque>
 #include <string>
 #include <sstream>
 #include <fcntl.h>
@@ -51,117 +54,216 @@ size_t getArchitectureBits();
 /*  Determine whether the current architecture is little endian or not.  */
 bool isArchitectureLittleEndian();
 /*  Construct architecture dependent file name.  */
-std::string getArchitectureFilename( const std::string& filename );
+std::string getArchitectureFilename( const std::string& filename,
+                                     bool compact );
+
+VertexBufferRoot::~VertexBufferRoot()
+{
+    _unmap();
+}
 
 /*  Begin kd-tree setup, go through full range starting with x axis.  */
 void VertexBufferRoot::setupTree( VertexData& data,
                                   boost::progress_display& progress )
 {
     // data is VertexData, _data is VertexBufferData
-    _data.clear();
+    _unmap();
 
     const Axis axis = data.getLongestAxis( 0, data.triangles.size() );
 
+    sortTree( data, axis );
     VertexBufferNode::setupTree( data, 0, data.triangles.size(),
                                  axis, 0, _data, progress );
     VertexBufferNode::updateBoundingSphere();
     VertexBufferNode::updateRange();
+    VertexBufferNode::setupLOD( _data );
+    if( _compact )
+        _compactData();
+}
+
+/*  Replace the vertices and normals by their compact representation.  */
+void VertexBufferRoot::_compactData()
+{
+    std::vector< QuantizedVertex > vertices( _data.vertices.size( ));
+    _maxVertexError = VertexBufferNode::quantize( vertices );
+
+    std::vector< PackedNormal > normals( _data.normals.size( ));
+    float minCosine = 1.f;
+    for( size_t i = 0; i < normals.size(); ++i )
+    {
+        const Normal& normal = _data.normals[i];
+        normals[i] = packNormal( normal );
+        if( normal.squared_length() > 0.f )
+            minCosine = std::min( minCosine,
+                                  unpackNormal( normals[i] ).dot( normal ));
+    }
+    _maxNormalError = std::acos( std::max( -1.f, minCosine )) * 180.f /
+                      3.14159265f;
+
+    _data.quantizedVertices.swap( vertices );
+    _data.packedNormals.swap( normals );
+    _data.vertices.clear();
+    _data.normals.clear();
 }
 
 // #define LOGCULL
-void VertexBufferRoot::cullDraw( VertexBufferState& state ) const
+namespace
 {
-    _beginRendering( state );
+typedef std::vector< const VertexBufferBase* > Candidates;
 
-#ifdef LOGCULL
-    size_t verticesRendered = 0;
-    size_t verticesOverlap  = 0;
-#endif
+// number of subtrees culled in parallel for large trees
+const size_t _nSubtrees = 64;
 
+/*  Cull a node: append it or its proxy to the draw list if it is to be drawn
+    completely, or append its children to the candidates.  */
+void _cullNode( const VertexBufferBase* treeNode,
+                const VertexBufferState& state, const FrustumCullerf& culler,
+                VertexBufferRoot::DrawList& list, Candidates& candidates )
+{
     const Range& range = state.getRange();
-    const FrustumCullerf culler( state.getProjectionModelViewMatrix( ));
+    const float lodThreshold = state.getLODThreshold();
 
-    // start with root node
-    std::vector< const triply::VertexBufferBase* > candidates;
-    candidates.push_back( this );
+    // completely out of range check
+    if( treeNode->getRange()[0] >= range[1] ||
+        treeNode->getRange()[1] < range[0] )
+    {
+        return;
+    }
 
-    while( !candidates.empty() )
+    // bounding sphere view frustum culling
+    const vmml::Visibility visibility = state.useFrustumCulling() ?
+                        culler.test( treeNode->getBoundingSphere( )) :
+                        vmml::VISIBILITY_FULL;
+    const bool inRange = treeNode->getRange()[0] >= range[0] &&
+                         treeNode->getRange()[1] <  range[1];
+
+    // if visible and fully in range, render the proxy if it is precise
+    // enough, otherwise the children select their proxies
+    const VertexBufferBase* lod = treeNode->getLOD();
+    if( lodThreshold > 0.f && lod && inRange &&
+        visibility != vmml::VISIBILITY_NONE )
     {
-        if( state.stopRendering( ))
+        if( state.getScreenError( treeNode->getBoundingSphere(),
+                                  treeNode->getLODError( )) <= lodThreshold )
+        {
+            list.push_back( lod );
             return;
+        }
+    }
 
-        const triply::VertexBufferBase* treeNode = candidates.back();
-        candidates.pop_back();
+    switch( visibility )
+    {
+        case vmml::VISIBILITY_FULL:
+            // if fully visible and fully in range, render it
+            if( inRange && ( lodThreshold <= 0.f || !treeNode->getLeft( )))
+            {
+                list.push_back( treeNode );
+                break;
+            }
+            // partial range or imprecise proxy, fall through to partial
+            // visibility
 
-        // completely out of range check
-        if( treeNode->getRange()[0] >= range[1] ||
-            treeNode->getRange()[1] < range[0] )
+        case vmml::VISIBILITY_PARTIAL:
         {
-            continue;
+            const VertexBufferBase* left  = treeNode->getLeft();
+            const VertexBufferBase* right = treeNode->getRight();
+
+            if( !left && !right )
+            {
+                if( treeNode->getRange()[0] >= range[0] )
+                    list.push_back( treeNode );
+                // else drop, to be drawn by 'previous' channel
+            }
+            else
+            {
+                if( left )
+                    candidates.push_back( left );
+                if( right )
+                    candidates.push_back( right );
+            }
+            break;
         }
+        case vmml::VISIBILITY_NONE:
+            // do nothing
+            break;
+    }
+}
+}
 
-        // bounding sphere view frustum culling
-        const vmml::Visibility visibility = state.useFrustumCulling() ?
-                            culler.test( treeNode->getBoundingSphere( )) :
-                            vmml::VISIBILITY_FULL;
-        switch( visibility )
+void VertexBufferRoot::cullDraw( VertexBufferState& state ) const
+{
+    DrawList list;
+    cull( state, list );
+    render( state, list );
+}
+
+/*  Cull the first levels of the tree breadth-first until there are enough
+    subtrees for all threads, and cull the subtrees in parallel.  */
+void VertexBufferRoot::cull( const VertexBufferState& state,
+                             DrawList& list ) const
+{
+    list.clear();
+    const FrustumCullerf culler( state.getProjectionModelViewMatrix( ));
+
+    std::deque< const VertexBufferBase* > subtrees( 1, this );
+    Candidates children;
+    while( !subtrees.empty() && subtrees.size() < _nSubtrees )
+    {
+        _cullNode( subtrees.front(), state, culler, list, children );
+        subtrees.pop_front();
+        subtrees.insert( subtrees.end(), children.begin(), children.end( ));
+        children.clear();
+    }
+    if( subtrees.empty( ))
+        return;
+
+    // keep the order of the subtrees in the draw list
+    std::vector< DrawList > lists( subtrees.size( ));
+#pragma omp parallel for schedule( dynamic )
+    for( ssize_t i = 0; i < ssize_t( subtrees.size( )); ++i )
+    {
+        Candidates candidates( 1, subtrees[i] );
+        while( !candidates.empty( ))
         {
-            case vmml::VISIBILITY_FULL:
-                // if fully visible and fully in range, render it
-                if( treeNode->getRange()[0] >= range[0] &&
-                    treeNode->getRange()[1] <  range[1] )
-                {
-                    treeNode->draw( state );
-                    //treeNode->drawBoundingSphere( state );
+            const VertexBufferBase* treeNode = candidates.back();
+            candidates.pop_back();
+            _cullNode( treeNode, state, culler, lists[i], candidates );
+        }
+    }
+
+    for( size_t i = 0; i < lists.size(); ++i )
+        list.insert( list.end(), lists[i].begin(), lists[i].end( ));
+}
+
+/*  Draw the nodes of a draw list.  */
+void VertexBufferRoot::render( VertexBufferState& state,
+                               const DrawList& list ) const
+{
+    _beginRendering( state );
+
 #ifdef LOGCULL
-                    verticesRendered += treeNode->getNumberOfVertices();
+    size_t verticesRendered = 0;
 #endif
-                    break;
-                }
-                // partial range, fall through to partial visibility
 
-            case vmml::VISIBILITY_PARTIAL:
-            {
-                const triply::VertexBufferBase* left  = treeNode->getLeft();
-                const triply::VertexBufferBase* right = treeNode->getRight();
-
-                if( !left && !right )
-                {
-                    if( treeNode->getRange()[0] >= range[0] )
-                    {
-                        treeNode->draw( state );
-                        //treeNode->drawBoundingSphere( state );
+    for( DrawList::const_iterator i = list.begin(); i != list.end(); ++i )
+    {
+        if( state.stopRendering( ))
+            break; // still restore the OpenGL state
+
+        (*i)->draw( state );
+        //(*i)->drawBoundingSphere( state );
 #ifdef LOGCULL
-                        verticesRendered += treeNode->getNumberOfVertices();
-                        if( visibility == vmml::VISIBILITY_PARTIAL )
-                            verticesOverlap  += treeNode->getNumberOfVertices();
+        verticesRendered += (*i)->getNumberOfVertices();
 #endif
-                    }
-                    // else drop, to be drawn by 'previous' channel
-                }
-                else
-                {
-                    if( left )
-                        candidates.push_back( left );
-                    if( right )
-                        candidates.push_back( right );
-                }
-                break;
-            }
-            case vmml::VISIBILITY_NONE:
-                // do nothing
-                break;
-        }
     }
 
     _endRendering( state );
 
 #ifdef LOGCULL
-    const size_t verticesTotal = model->getNumberOfVertices();
+    const size_t verticesTotal = getNumberOfVertices();
     PLYLIBINFO
         << getName() << " rendered " << verticesRendered * 100 / verticesTotal
-        << "% of model, overlap <= " << verticesOverlap * 100 / verticesTotal
-        << "%" << std::endl;
+        << "% of model" << std::endl;
 #endif
 }
 
@@ -170,6 +272,14 @@ void VertexBufferRoot::cullDraw( VertexBufferState& state ) const
 void VertexBufferRoot::_beginRendering( VertexBufferState& state ) const
 {
     state.resetRegion();
+
+    // the leaves scale compact vertices, and thus the normals
+    if( isCompact( ))
+    {
+        glPushAttrib( GL_ENABLE_BIT );
+        glEnable( GL_NORMALIZE );
+    }
+
     switch( state.getRenderMode() )
     {
 #ifdef GL_ARB_vertex_buffer_object
@@ -215,6 +325,9 @@ void VertexBufferRoot::_endRendering( VertexBufferState& state ) const
     default:
         ;
     }
+
+    if( isCompact( ))
+        glPopAttrib();
 }
 
 
@@ -235,11 +348,12 @@ bool isArchitectureLittleEndian()
 
 
 /*  Construct architecture dependent file name.  */
-std::string getArchitectureFilename( const std::string& filename )
+std::string getArchitectureFilename( const std::string& filename,
+                                     const bool compact )
 {
     std::ostringstream oss;
     oss << filename << ( isArchitectureLittleEndian() ? ".le" : ".be" );
-    oss << getArchitectureBits() << ".bin";
+    oss << getArchitectureBits() << ( compact ? ".compact.bin" : ".bin" );
     return oss.str();
 }
 
@@ -301,34 +415,31 @@ bool VertexBufferRoot::_readBinary( std::string filename )
         return false;
     }
 
-    // get a view of the mapping
+    // get a view of the mapping, which keeps the mapping open
     char* addr   = static_cast< char* >( MapViewOfFile( map, FILE_MAP_READ, 0,
                                                         0, 0 ) );
-    bool  result = false;
-
-    if( addr )
-    {
-        try
-        {
-            fromMemory( addr );
-            result = true;
-        }
-        catch( const std::exception& e )
-        {
-            PLYLIBERROR << "Unable to read binary file, an exception occured:  "
-                      << e.what() << std::endl;
-        }
-        UnmapViewOfFile( addr );
-    }
-    else
+    CloseHandle( map );
+    if( !addr )
     {
         PLYLIBERROR << "Unable to read binary file, memory mapping failed."
                   << std::endl;
         return false;
     }
+    _unmap();
+    _mapping = addr;
 
-    CloseHandle( map );
-    return result;
+    try
+    {
+        fromMemory( addr );
+        return true;
+    }
+    catch( const std::exception& e )
+    {
+        PLYLIBERROR << "Unable to read binary file, an exception occured:  "
+                  << e.what() << std::endl;
+    }
+    _unmap();
+    return false;
 
 #else
     // try to open binary file
@@ -340,39 +451,55 @@ bool VertexBufferRoot::_readBinary( std::string filename )
     struct stat status;
     fstat( fd, &status );
 
-    // create memory mapped file
+    // create memory mapped file, shared with other processes using the model
     char* addr   = static_cast< char* >( mmap( 0, status.st_size, PROT_READ,
                                                MAP_SHARED, fd, 0 ) );
-    bool  result = false;
-    if( addr != MAP_FAILED )
-    {
-        try
-        {
-            fromMemory( addr );
-            result = true;
-        }
-        catch( const std::exception& e )
-        {
-            PLYLIBERROR << "Unable to read binary file, an exception occured:  "
-                      << e.what() << std::endl;
-        }
-        munmap( addr, status.st_size );
-    }
-    else
+    close( fd );
+    if( addr == MAP_FAILED )
     {
         PLYLIBERROR << "Unable to read binary file, memory mapping failed."
                   << std::endl;
+        return false;
     }
+    _unmap();
+    _mapping = addr;
+    _mappingSize = status.st_size;
 
-    close( fd );
-    return result;
+    try
+    {
+        fromMemory( addr );
+        return true;
+    }
+    catch( const std::exception& e )
+    {
+        PLYLIBERROR << "Unable to read binary file, an exception occured:  "
+                  << e.what() << std::endl;
+    }
+    _unmap();
+    return false;
+#endif
+}
+
+/*  Release the binary file used by the kd-tree data.  */
+void VertexBufferRoot::_unmap()
+{
+    _data.clear();
+    if( !_mapping )
+        return;
+
+#ifdef WIN32
+    UnmapViewOfFile( _mapping );
+#else
+    munmap( _mapping, _mappingSize );
 #endif
+    _mapping = 0;
+    _mappingSize = 0;
 }
 
 /*  Read binary kd-tree representation, construct from ply if unavailable.  */
 bool VertexBufferRoot::readFromFile( const std::string& filename )
 {
-    if( _readBinary( getArchitectureFilename( filename )))
+    if( _readBinary( getArchitectureFilename( filename, _compact )))
     {
         _name = filename;
         return true;
@@ -390,7 +517,8 @@ bool VertexBufferRoot::writeToFile( const std::string& filename )
 {
     bool result = false;
 
-    std::ofstream output( getArchitectureFilename( filename ).c_str(),
+    std::ofstream output( getArchitectureFilename( filename,
+                                                   isCompact( )).c_str(),
                           std::ios::out | std::ios::binary );
     if( output )
     {
@@ -41,11 +41,28 @@ namespace triply
 class VertexBufferRoot : public VertexBufferNode
 {
 public:
-    TRIPLY_API VertexBufferRoot() : VertexBufferNode(), _invertFaces(false) {}
+    TRIPLY_API VertexBufferRoot() : VertexBufferNode(), _invertFaces(false)
+                                  , _compact( false ), _maxVertexError( 0.f )
+                                  , _maxNormalError( 0.f ), _mapping( 0 )
+                                  , _mappingSize( 0 ) {}
+    TRIPLY_API virtual ~VertexBufferRoot();
+
+    /*  The nodes, leaves and proxies to draw completely, in order.  */
+    typedef std::vector< const VertexBufferBase* > DrawList;
 
     TRIPLY_API virtual void cullDraw( VertexBufferState& state ) const;
     TRIPLY_API virtual void draw( VertexBufferState& state ) const;
 
+    /*  Select the parts of the model to draw for the matrix, range and LOD
+        threshold of the state, without using OpenGL. Large trees are culled
+        by all threads.  */
+    TRIPLY_API void cull( const VertexBufferState& state,
+                          DrawList& list ) const;
+
+    /*  Draw the parts of the model selected by cull().  */
+    TRIPLY_API void render( VertexBufferState& state,
+                            const DrawList& list ) const;
+
     TRIPLY_API void setupTree( VertexData& data, boost::progress_display&  );
     TRIPLY_API bool writeToFile( const std::string& filename );
     TRIPLY_API bool readFromFile( const std::string& filename );
@@ -53,6 +70,16 @@ public:
 
     void useInvertedFaces() { _invertFaces = true; }
 
+    /*  Use compact data with quantized vertices, octahedral normals and
+        delta-encoded indices for models loaded afterwards.  */
+    void useCompactData() { _compact = true; }
+    bool isCompact() const { return _data.isCompact(); }
+
+    /*  @return the max vertex distance and the max normal angle in degrees
+                of the compact data, if built by setupTree().  */
+    float getMaxVertexError() const { return _maxVertexError; }
+    float getMaxNormalError() const { return _maxNormalError; }
+
     const std::string& getName() const { return _name; }
 
 protected:
@@ -62,6 +89,8 @@ protected:
 private:
     bool _constructFromPly( const std::string& filename );
     bool _readBinary( std::string filename );
+    void _unmap();
+    void _compactData();
 
     void _beginRendering( VertexBufferState& state ) const;
     void _endRendering( VertexBufferState& state ) const;
@@ -69,7 +98,14 @@ private:
     friend class VertexBufferDist;
     VertexBufferData _data;
     bool             _invertFaces;
+    bool             _compact;
+    float            _maxVertexError;
+    float            _maxNormalError;
     std::string      _name;
+
+    // binary file used in place by _data while mapped
+    void*            _mapping;
+    size_t           _mappingSize;
 };
 }
 
@@ -32,13 +32,16 @@
 namespace triply
 {
 VertexBufferState::VertexBufferState( const GLEWContext* glewContext )
-        : _glewContext( glewContext )
+        : _lodThreshold( 0.f )
+        , _glewContext( glewContext )
         , _renderMode( RENDER_MODE_DISPLAY_LIST )
         , _useColors( false )
         , _useFrustumCulling( true )
 {
     _range[0] = 0.f;
     _range[1] = 1.f;
+    _viewportSize[0] = 0.f;
+    _viewportSize[1] = 0.f;
     resetRegion();
     PLYLIBASSERT( glewContext );
 }
@@ -104,6 +107,24 @@ void VertexBufferState::updateRegion( const BoundingBox& box )
     _region[3] = std::max( _region[3], normalized[3] );
 }
 
+float VertexBufferState::getScreenError( const BoundingSphere& sphere,
+                                         const float error ) const
+{
+    // clip-space w of the closest point, i.e., the eye distance for
+    // perspective and 1 for orthographic projections
+    const Matrix4f& pmv = _pmvMatrix;
+    const Vertex wRow( pmv( 3, 0 ), pmv( 3, 1 ), pmv( 3, 2 ));
+    const float w = wRow.dot( Vertex( sphere.array )) + pmv( 3, 3 ) -
+                    sphere.w() * wRow.length();
+    if( w <= 0.f ) // the eye is within the sphere
+        return std::numeric_limits< float >::max();
+
+    const Vertex xRow( pmv( 0, 0 ), pmv( 0, 1 ), pmv( 0, 2 ));
+    const Vertex yRow( pmv( 1, 0 ), pmv( 1, 1 ), pmv( 1, 2 ));
+    return error * .5f * std::max( xRow.length() * _viewportSize[0],
+                                   yRow.length() * _viewportSize[1] ) / w;
+}
+
 Vector4f VertexBufferState::getRegion() const
 {
     if( _region[0] > _region[2] || _region[1] > _region[3] )
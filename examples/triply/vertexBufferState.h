@@ -63,6 +63,21 @@ public:
     TRIPLY_API void setRange( const Range& range ) { _range = range; }
     TRIPLY_API const Range& getRange() const { return _range; }
 
+    /*  Set the max screen-space error of the level-of-detail proxies drawn
+        by cullDraw in pixels, 0 draws the full model.  */
+    TRIPLY_API void setLODThreshold( const float pixels )
+        { _lodThreshold = pixels; }
+    TRIPLY_API float getLODThreshold() const { return _lodThreshold; }
+
+    /*  Set the size of the viewport in pixels, used for the LOD selection. */
+    TRIPLY_API void setViewportSize( const float width, const float height )
+        { _viewportSize[0] = width; _viewportSize[1] = height; }
+
+    /*  @return the projected size in pixels of an object-space error at the
+                closest point of the given bounding sphere.  */
+    TRIPLY_API float getScreenError( const BoundingSphere& sphere,
+                                     float error ) const;
+
     TRIPLY_API void resetRegion();
     TRIPLY_API void updateRegion( const BoundingBox& box );
     TRIPLY_API virtual void declareRegion( const Vector4f& ) {}
@@ -83,6 +98,8 @@ protected:
 
     Matrix4f      _pmvMatrix; //!< projection * modelView matrix
     Range         _range; //!< normalized [0,1] part of the model to draw
+    float         _lodThreshold; //!< max proxy error in pixels
+    float         _viewportSize[2]; //!< width and height in pixels
     const GLEWContext* const _glewContext;
     RenderMode    _renderMode;
     Vector4f      _region; //!< normalized x1 y1 x2 y2 region from cullDraw
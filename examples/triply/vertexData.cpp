@@ -30,7 +30,9 @@
 #include "vertexData.h"
 #include "ply.h"
 
+#include <lunchbox/memoryMap.h>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
 
 #if (( __GNUC__ > 4 ) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 4)) )
@@ -42,9 +44,88 @@ using std::sort;
 
 using namespace triply;
 
+/** @cond IGNORE */
+namespace
+{
+/*  Sizes of the PLY_* scalar types in bytes.  */
+const size_t _typeSizes[ PLY_END_TYPE ] = { 0, 1, 2, 4, 1, 2, 4, 4, 8, 4, 1, 4 };
+
+/*  Byte offsets of the properties of a binary element with fixed-size records,
+    where the only list may be triangle vertex indices.  */
+struct _Layout
+{
+    _Layout() : size( 0 ), list( -1 ) {}
+
+    bool init( const PlyElement* element )
+    {
+        for( int i = 0; i < element->nprops; ++i )
+        {
+            const PlyProperty* prop = element->props[i];
+            if( prop->external_type <= PLY_START_TYPE ||
+                prop->external_type >= PLY_END_TYPE )
+            {
+                return false;
+            }
+
+            offsets.push_back( size );
+            if( prop->is_list )
+            {
+                if( list >= 0 || prop->count_external <= PLY_START_TYPE ||
+                    prop->count_external >= PLY_END_TYPE )
+                {
+                    return false;
+                }
+                list = i;
+                size += _typeSizes[ prop->count_external ] +
+                        3 * _typeSizes[ prop->external_type ];
+            }
+            else
+                size += _typeSizes[ prop->external_type ];
+        }
+        return true;
+    }
+
+    /*  @return the offset of the named scalar property of the given type.  */
+    int getOffset( const PlyElement* element, const char* name,
+                   const size_t typeSize, const bool isFloat ) const
+    {
+        for( int i = 0; i < element->nprops; ++i )
+        {
+            const PlyProperty* prop = element->props[i];
+            if( !equal_strings( prop->name, name ))
+                continue;
+
+            const int type = prop->external_type;
+            const bool floatType = type == PLY_FLOAT || type == PLY_FLOAT32 ||
+                                   type == PLY_DOUBLE;
+            if( prop->is_list || floatType != isFloat ||
+                _typeSizes[ type ] != typeSize )
+            {
+                return -1;
+            }
+            return int( offsets[i] );
+        }
+        return -1;
+    }
+
+    size_t size; // of one record in bytes
+    int list;
+    std::vector< size_t > offsets;
+};
+
+bool _isLittleEndian()
+{
+    unsigned char test[2] = { 1, 0 };
+    short* x = reinterpret_cast< short* >( test );
+    return ( *x == 1 );
+}
+}
+/** @endcond */
+
 /*  Contructor.  */
 VertexData::VertexData()
     : _invertFaces( false )
+    , _mappedReader( true )
 {
     _boundingBox[0] = Vertex( 0.0f );
     _boundingBox[1] = Vertex( 0.0f );
@@ -145,6 +226,157 @@ void VertexData::readTriangles( PlyFile* file, const int nFaces )
 }
 
 
+/*  Read the vertices, colors and triangles of a binary file in native byte
+    order with fixed-size records from a memory mapping, using the header
+    parsed by plyfile. Returns false if the file needs the generic reader.  */
+bool VertexData::readMapped( PlyFile* file, const std::string& filename )
+{
+    const int nativeType = _isLittleEndian() ? PLY_BINARY_LE : PLY_BINARY_BE;
+    if( file->file_type != nativeType )
+        return false;
+
+    // the file is positioned after the header, compute the element offsets
+    const long start = ftell( file->fp );
+    if( start <= 0 )
+        return false;
+
+    const PlyElement* vertexElement = 0;
+    const PlyElement* faceElement = 0;
+    _Layout vertexLayout;
+    _Layout faceLayout;
+    size_t vertexStart = 0;
+    size_t faceStart = 0;
+    size_t end = start;
+
+    for( int i = 0; i < file->nelems; ++i )
+    {
+        const PlyElement* element = file->elems[i];
+        _Layout layout;
+        if( !layout.init( element ) || element->num < 0 )
+            return false;
+
+        if( equal_strings( element->name, "vertex" ))
+        {
+            if( layout.list >= 0 )
+                return false;
+            vertexElement = element;
+            vertexLayout = layout;
+            vertexStart = end;
+        }
+        else if( equal_strings( element->name, "face" ))
+        {
+            if( layout.list < 0 || !equal_strings(
+                    element->props[ layout.list ]->name, "vertex_indices" ))
+            {
+                return false;
+            }
+            faceElement = element;
+            faceLayout = layout;
+            faceStart = end;
+        }
+        else if( layout.list >= 0 )
+            return false;
+
+        end += size_t( element->num ) * layout.size;
+    }
+    if( !vertexElement || !faceElement )
+        return false;
+
+    // vertices need float coordinates and optionally uchar colors
+    const int coordinates[3] = {
+        vertexLayout.getOffset( vertexElement, "x", sizeof( float ), true ),
+        vertexLayout.getOffset( vertexElement, "y", sizeof( float ), true ),
+        vertexLayout.getOffset( vertexElement, "z", sizeof( float ), true ) };
+    const int rgb[3] = {
+        vertexLayout.getOffset( vertexElement, "red", 1, false ),
+        vertexLayout.getOffset( vertexElement, "green", 1, false ),
+        vertexLayout.getOffset( vertexElement, "blue", 1, false ) };
+    if( coordinates[0] < 0 || coordinates[1] < 0 || coordinates[2] < 0 )
+        return false;
+
+    bool hasColors = false;
+    for( int i = 0; i < vertexElement->nprops; ++i )
+        if( equal_strings( vertexElement->props[i]->name, "red" ))
+            hasColors = true;
+    if( hasColors && ( rgb[0] < 0 || rgb[1] < 0 || rgb[2] < 0 ))
+        return false;
+
+    // faces need an 8 bit count and int indices
+    const PlyProperty* indices = faceElement->props[ faceLayout.list ];
+    if( _typeSizes[ indices->count_external ] != 1 ||
+        ( indices->external_type != PLY_INT &&
+          indices->external_type != PLY_INT32 &&
+          indices->external_type != PLY_UINT ))
+    {
+        return false;
+    }
+    const size_t countOffset = faceLayout.offsets[ faceLayout.list ];
+
+    // ply_open_for_reading adds the extension if needed
+    std::string name = filename;
+    if( name.length() < 4 || name.compare( name.length() - 4, 4, ".ply" ) != 0 )
+        name += ".ply";
+
+    lunchbox::MemoryMap mapping;
+    const uint8_t* addr = static_cast< const uint8_t* >( mapping.map( name ));
+    if( !addr || mapping.getSize() < end )
+        return false;
+
+    const size_t nVertices = vertexElement->num;
+    const size_t vertexSize = vertexLayout.size;
+    const uint8_t* vertexData = addr + vertexStart;
+    vertices.resize( nVertices );
+    if( hasColors )
+        colors.resize( nVertices );
+
+#pragma omp parallel for
+    for( ssize_t i = 0; i < ssize_t( nVertices ); ++i )
+    {
+        const uint8_t* record = vertexData + i * vertexSize;
+        Vertex& vertex = vertices[i];
+        for( size_t j = 0; j < 3; ++j )
+            memcpy( &vertex[j], record + coordinates[j], sizeof( float ));
+        if( hasColors )
+            colors[i] = Color( record[ rgb[0] ], record[ rgb[1] ],
+                               record[ rgb[2] ] );
+    }
+
+    // a face which is not a triangle is the first misaligned record, since all
+    // preceding records have the triangle size
+    const size_t nFaces = faceElement->num;
+    const size_t faceSize = faceLayout.size;
+    const uint8_t* faceData = addr + faceStart + countOffset;
+    const size_t ind1 = _invertFaces ? 2 : 0;
+    const size_t ind3 = _invertFaces ? 0 : 2;
+    bool triangular = true;
+    triangles.resize( nFaces );
+
+#pragma omp parallel for reduction(&&: triangular)
+    for( ssize_t i = 0; i < ssize_t( nFaces ); ++i )
+    {
+        const uint8_t* record = faceData + i * faceSize;
+        if( record[0] != 3 )
+        {
+            triangular = false;
+            continue;
+        }
+
+        int32_t face[3];
+        memcpy( face, record + 1, sizeof( face ));
+        triangles[i] = Triangle( face[ind1], face[1], face[ind3] );
+    }
+
+    if( triangular )
+        return true;
+
+    // let the generic reader report the error
+    vertices.clear();
+    colors.clear();
+    triangles.clear();
+    return false;
+}
+
+
 /*  Open a PLY file and read vertex, color and index data.  */
 bool VertexData::readPlyFile( const std::string& filename )
 {
@@ -165,7 +397,10 @@ bool VertexData::readPlyFile( const std::string& filename )
     }
     PLYLIBASSERT( elemNames != 0 );
 
-    for( int i = 0; i < nPlyElems; ++i )
+    // read binary files with fixed-size records in place, others with plyfile
+    const bool mapped = _mappedReader && readMapped( file, filename );
+
+    for( int i = 0; !mapped && i < nPlyElems; ++i )
     {
         int nElems;
         int nProps;
@@ -218,7 +453,7 @@ bool VertexData::readPlyFile( const std::string& filename )
         free( elemNames[i] );
     free( elemNames );
 
-    return result;
+    return mapped || result;
 }
 
 
@@ -57,6 +57,10 @@ namespace triply
 
         void useInvertedFaces() { _invertFaces = true; }
 
+        /*  Read binary files with fixed-size records from a memory mapping,
+            enabled by default.  */
+        void useMappedReader( const bool enable ) { _mappedReader = enable; }
+
         std::vector< Vertex >   vertices;
         std::vector< Color >    colors;
         std::vector< Normal >   normals;
@@ -66,9 +70,11 @@ namespace triply
         void readVertices( PlyFile* file, const int nVertices,
                            const bool readColors );
         void readTriangles( PlyFile* file, const int nFaces );
+        bool readMapped( PlyFile* file, const std::string& filename );
 
         BoundingBox _boundingBox;
         bool        _invertFaces;
+        bool        _mappedReader;
     };
 }
 
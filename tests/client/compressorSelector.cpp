@@ -0,0 +1,92 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Tests the adaptive compressor selection using synthetic measurements of two
+// compressors and of links of different bandwidths.
+
+#include <lunchbox/test.h>
+
+#include <eq/detail/compressorSelector.h>
+#include <pression/plugins/compressor.h>
+
+using eq::detail::CompressorSelector;
+
+namespace
+{
+const uint32_t _fast = 0x1000; // ratio .5, 1 GB/s
+const uint32_t _strong = 0x1001; // ratio .1, 100 MB/s
+const uint64_t _size = uint64_t( 8 ) << 20;
+const float _gbit = 125000.f; // 1 GBit/s in bytes/ms
+}
+
+int main( int, char** )
+{
+    CompressorSelector& selector = CompressorSelector::getInstance();
+    std::vector< uint32_t > candidates;
+    candidates.push_back( _fast );
+    candidates.push_back( _strong );
+
+    const co::NodeIDs fastLink( 1, co::NodeID( 0, 1 ));
+    const co::NodeIDs mediumLink( 1, co::NodeID( 0, 2 ));
+    const co::NodeIDs slowLink( 1, co::NodeID( 0, 3 ));
+    const co::NodeIDs bufferedLink( 1, co::NodeID( 0, 4 ));
+
+    // untried compressors are explored first, and used once measured
+    TEST( selector.select( candidates, _size, fastLink ) == _fast );
+    TEST( selector.select( candidates, _size, fastLink ) == _strong );
+    TEST( selector.select( candidates, _size, fastLink ) ==
+          EQ_COMPRESSOR_NONE );
+    TEST( selector.select( std::vector< uint32_t >(), _size, fastLink ) ==
+          EQ_COMPRESSOR_NONE );
+
+    selector.addCompress( _fast, _size, _size / 2, 8.f );
+    selector.addCompress( _strong, _size, _size / 10, 80.f );
+
+    // 1 GB/s: sending raw takes 8 ms, faster than any compression
+    selector.addTransmit( fastLink.front(), _size, 8.f, 0.f );
+    TEST( selector.select( candidates, _size, fastLink ) ==
+          EQ_COMPRESSOR_NONE );
+
+    // 100 MB/s: 80 ms raw, 56 ms fast and 168 ms strong compression
+    selector.addTransmit( mediumLink.front(), _size, 80.f, 0.f );
+    TEST( selector.select( candidates, _size, mediumLink ) == _fast );
+
+    // 10 MB/s: 800 ms raw, 416 ms fast and 240 ms strong compression
+    selector.addTransmit( slowLink.front(), _size, 800.f, 0.f );
+    TEST( selector.select( candidates, _size, slowLink ) == _strong );
+
+    // the slowest receiver decides
+    co::NodeIDs receivers = fastLink;
+    receivers.push_back( slowLink.front( ));
+    TEST( selector.select( candidates, _size, receivers ) == _strong );
+
+    // small sends are latency-bound and ignored
+    selector.addTransmit( bufferedLink.front(), 1024, .001f, 0.f );
+    TESTINFO( selector.getBandwidth( bufferedLink.front( )) == _gbit,
+              selector.getBandwidth( bufferedLink.front( )));
+
+    // a frame absorbed by the socket buffers is limited to the link bandwidth
+    selector.addTransmit( bufferedLink.front(), _size, .1f, _gbit );
+    TESTINFO( selector.getBandwidth( bufferedLink.front( )) == _gbit,
+              selector.getBandwidth( bufferedLink.front( )));
+    TEST( selector.select( candidates, _size, bufferedLink ) == _fast );
+
+    // and to 10 GBit/s for links of unknown bandwidth
+    selector.addTransmit( bufferedLink.front(), _size, .1f, 0.f );
+    TESTINFO( selector.getBandwidth( bufferedLink.front( )) < 10.f * _gbit,
+              selector.getBandwidth( bufferedLink.front( )));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Tests the CPU region of interest analysis of depth and alpha masks in main
+// memory for all instruction sets supported by the CPU.
+
+#include <lunchbox/test.h>
+
+#include <eq/compositor.h>
+#include <eq/roiFinder.h>
+
+using eq::PixelViewport;
+using eq::PixelViewports;
+using eq::ROIFinder;
+
+namespace
+{
+const uint32_t _far = 0xffffffffu;
+const uint32_t _transparent = 0x00ffffffu; // white, on little and big endian
+
+void _fill( std::vector< uint32_t >& mask, const PixelViewport& pvp,
+            const PixelViewport& area, const uint32_t value )
+{
+    for( int32_t y = area.y; y < area.y + area.h; ++y )
+        for( int32_t x = area.x; x < area.x + area.w; ++x )
+            mask[ y * pvp.w + x ] = value;
+}
+
+bool _isOccupied( const uint32_t pixel, const ROIFinder::MaskType type )
+{
+    if( type == ROIFinder::MASK_DEPTH )
+        return pixel != _far;
+    return reinterpret_cast< const uint8_t* >( &pixel )[3] != 0;
+}
+
+/** @return the area of the regions, after testing that they are valid. */
+uint32_t _testRegions( const std::vector< uint32_t >& mask,
+                       const ROIFinder::MaskType type, const PixelViewport& pvp,
+                       const PixelViewports& regions )
+{
+    uint32_t area = 0;
+    for( size_t i = 0; i < regions.size(); ++i )
+    {
+        const PixelViewport& region = regions[i];
+        TESTINFO( region.hasArea(), region );
+        PixelViewport inside = region;
+        inside.intersect( pvp );
+        TESTINFO( inside == region, region << " not in " << pvp );
+
+        for( size_t j = i + 1; j < regions.size(); ++j )
+        {
+            PixelViewport overlap = region;
+            overlap.intersect( regions[j] );
+            TESTINFO( !overlap.hasArea(), region << " and " << regions[j] );
+        }
+        area += region.getArea();
+    }
+
+    for( int32_t y = 0; y < pvp.h; ++y )
+        for( int32_t x = 0; x < pvp.w; ++x )
+        {
+            if( !_isOccupied( mask[ y * pvp.w + x ], type ))
+                continue;
+
+            bool covered = false;
+            for( size_t i = 0; i < regions.size() && !covered; ++i )
+            {
+                const PixelViewport& region = regions[i];
+                covered = pvp.x + x >= region.x &&
+                          pvp.x + x < region.x + region.w &&
+                          pvp.y + y >= region.y &&
+                          pvp.y + y < region.y + region.h;
+            }
+            TESTINFO( covered, "pixel " << x << ", " << y );
+        }
+    return area;
+}
+}
+
+int main( int, char** )
+{
+    ROIFinder finder;
+
+    // not a multiple of the block size, with an offset
+    const PixelViewport pvp( 100, 50, 1500, 1000 );
+    std::vector< uint32_t > mask( pvp.getArea(), _far );
+
+    TEST( finder.findRegions( &mask[0], ROIFinder::MASK_DEPTH, pvp ).empty( ));
+
+    std::fill( mask.begin(), mask.end(), 0 );
+    PixelViewports regions =
+        finder.findRegions( &mask[0], ROIFinder::MASK_DEPTH, pvp );
+    TEST( regions.size() == 1 );
+    TESTINFO( regions.front() == pvp, regions.front( ));
+
+    // two objects in opposite corners and a single pixel in the last block
+    std::fill( mask.begin(), mask.end(), _far );
+    _fill( mask, pvp, PixelViewport( 20, 10, 300, 200 ), 42 );
+    _fill( mask, pvp, PixelViewport( 1100, 700, 399, 290 ), 17 );
+    mask.back() = 0;
+
+    for( int simd = eq::Compositor::SIMD_NONE;
+         simd <= eq::Compositor::SIMD_AVX512; ++simd )
+    {
+        if( !eq::Compositor::setSIMD( eq::Compositor::SIMD( simd )))
+            continue;
+
+        const PixelViewports result =
+            finder.findRegions( &mask[0], ROIFinder::MASK_DEPTH, pvp );
+        if( simd == eq::Compositor::SIMD_NONE )
+            regions = result;
+        else
+            TESTINFO( result == regions, "instruction set " << simd );
+    }
+    TEST( eq::Compositor::setSIMD( eq::Compositor::SIMD_AUTO ));
+
+    const uint32_t area = _testRegions( mask, ROIFinder::MASK_DEPTH, pvp,
+                                        regions );
+    TESTINFO( regions.size() > 1, regions.size( ));
+    TESTINFO( area < pvp.getArea() / 4, area << " of " << pvp.getArea( ));
+
+    // alpha mask, transparent pixels with color are empty
+    std::fill( mask.begin(), mask.end(), _transparent );
+    uint32_t opaque = 0;
+    reinterpret_cast< uint8_t* >( &opaque )[3] = 0x80;
+    _fill( mask, pvp, PixelViewport( 500, 400, 100, 50 ), opaque );
+
+    regions = finder.findRegions( &mask[0], ROIFinder::MASK_ALPHA, pvp );
+    TEST( regions.size() == 1 );
+    _testRegions( mask, ROIFinder::MASK_ALPHA, pvp, regions );
+    TESTINFO( regions.front().getArea() <= 112 * 64, regions.front( ));
+
+    // too large for the 8 bit block coordinates, returned as is
+    const PixelViewport wide( 0, 0, 4100, 16 );
+    mask.assign( wide.getArea(), _far );
+    regions = finder.findRegions( &mask[0], ROIFinder::MASK_DEPTH, wide );
+    TEST( regions.size() == 1 );
+    TEST( regions.front() == wide );
+
+    // slowly moving objects, reusing the unchanged areas of the last frame
+    const PixelViewport full( 0, 0, 1920, 1080 );
+    size_t nReused = 0;
+    for( uint32_t frame = 0; frame < 32; ++frame )
+    {
+        mask.assign( full.getArea(), _far );
+        _fill( mask, full, PixelViewport( 100 + frame * 3, 200, 300, 200 ), 42 );
+        _fill( mask, full, PixelViewport( 300, 700 + frame, 200, 100 ), 17 );
+        _fill( mask, full, PixelViewport( 1500, 100, 200, 800 ), 0 );
+
+        regions = finder.findRegions( &mask[0], ROIFinder::MASK_DEPTH, full,
+                                      0, frame );
+        const uint32_t covered = _testRegions( mask, ROIFinder::MASK_DEPTH,
+                                               full, regions );
+        TESTINFO( covered < full.getArea() / 3, covered << " in " << frame );
+        if( finder.getReusedRatio() > 0.f )
+            ++nReused;
+    }
+    TESTINFO( nReused > 16, nReused );
+
+    // unchanged mask reuses all areas
+    TEST( finder.findRegions( &mask[0], ROIFinder::MASK_DEPTH, full, 0, 32 ) ==
+          regions );
+    TEST( finder.getReusedRatio() == 1.f );
+
+    return EXIT_SUCCESS;
+}
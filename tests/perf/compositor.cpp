@@ -0,0 +1,219 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include <lunchbox/test.h>
+
+#include <eq/compositor.h>
+#include <eq/image.h>
+#include <eq/imageOp.h>
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+#include <eq/pixelData.h>
+
+#include <lunchbox/clock.h>
+#include <lunchbox/rng.h>
+#include <pression/plugins/compressor.h>
+
+// Measures the throughput of the CPU compositing kernels for each instruction
+// set supported by the CPU, and the input bandwidth of the merge modes for an
+// increasing number of images, using synthetic 4K images.
+
+namespace
+{
+const int32_t _width = 3840;
+const int32_t _height = 2160;
+const size_t _nImages = 8;
+const size_t _nLoops = 10;
+
+const char* const _simdNames[] = { "auto", "scalar", "SSE4.1", "AVX2",
+                                   "AVX-512" };
+
+void _setPixels( eq::Image& image, const eq::Frame::Buffer buffer,
+                 const uint32_t internalFormat, const uint32_t externalFormat,
+                 lunchbox::RNG& rng )
+{
+    eq::PixelData pixels;
+    pixels.internalFormat = internalFormat;
+    pixels.externalFormat = externalFormat;
+    pixels.pixelSize = 4;
+    pixels.pvp = image.getPixelViewport();
+    image.setPixelData( buffer, pixels );
+
+    uint32_t* data =
+        reinterpret_cast< uint32_t* >( image.getPixelPointer( buffer ));
+    const size_t nPixels = image.getPixelViewport().getArea();
+    for( size_t i = 0; i < nPixels; ++i )
+        data[i] = rng.get< uint32_t >();
+}
+
+float _measure( const eq::ImageOps& ops, const bool blend )
+{
+    TEST( eq::Compositor::mergeImagesCPU( ops, blend )); // warm up
+
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < _nLoops; ++i )
+        eq::Compositor::mergeImagesCPU( ops, blend );
+    const float time = clock.getTimef();
+
+    const float nPixels = float( _nLoops ) * float( ops.size( )) *
+                          float( _width ) * float( _height );
+    return nPixels / time / 1000.f; // MPixel/s
+}
+
+std::vector< uint8_t > _getResult( const eq::ImageOps& ops, const bool blend,
+                                   const eq::Frame::Buffer buffer )
+{
+    const eq::Image* result = eq::Compositor::mergeImagesCPU( ops, blend );
+    TEST( result );
+    const uint8_t* data = result->getPixelPointer( buffer );
+    return std::vector< uint8_t >( data,
+                                   data + result->getPixelDataSize( buffer ));
+}
+}
+
+int main( int argc, char **argv )
+{
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( argc, argv, &nodeFactory ));
+
+    lunchbox::RNG rng;
+    const eq::PixelViewport pvp( 0, 0, _width, _height );
+    std::vector< eq::Image* > dbImages;
+    std::vector< eq::Image* > colorImages;
+
+    for( size_t i = 0; i < _nImages; ++i )
+    {
+        eq::Image* image = new eq::Image;
+        image->setPixelViewport( pvp );
+        _setPixels( *image, eq::Frame::BUFFER_COLOR,
+                    EQ_COMPRESSOR_DATATYPE_RGBA, EQ_COMPRESSOR_DATATYPE_RGBA,
+                    rng );
+        _setPixels( *image, eq::Frame::BUFFER_DEPTH,
+                    EQ_COMPRESSOR_DATATYPE_DEPTH,
+                    EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT, rng );
+        dbImages.push_back( image );
+
+        image = new eq::Image;
+        image->setPixelViewport( pvp );
+        _setPixels( *image, eq::Frame::BUFFER_COLOR,
+                    EQ_COMPRESSOR_DATATYPE_RGBA, EQ_COMPRESSOR_DATATYPE_RGBA,
+                    rng );
+        colorImages.push_back( image );
+    }
+
+    eq::ImageOps dbOps;
+    eq::ImageOps colorOps;
+    for( size_t i = 0; i < _nImages; ++i )
+    {
+        eq::ImageOp op;
+        op.image = dbImages[i];
+        op.buffers = eq::Frame::BUFFER_COLOR | eq::Frame::BUFFER_DEPTH;
+        dbOps.push_back( op );
+
+        op.image = colorImages[i];
+        op.buffers = eq::Frame::BUFFER_COLOR;
+        colorOps.push_back( op );
+    }
+    const bool canBlend = colorImages.front()->hasAlpha();
+
+    // Reference results of the scalar kernels
+    TEST( eq::Compositor::setSIMD( eq::Compositor::SIMD_NONE ));
+    const std::vector< uint8_t > dbColor =
+        _getResult( dbOps, false, eq::Frame::BUFFER_COLOR );
+    const std::vector< uint8_t > dbDepth =
+        _getResult( dbOps, false, eq::Frame::BUFFER_DEPTH );
+    const std::vector< uint8_t > blended =
+        _getResult( colorOps, true, eq::Frame::BUFFER_COLOR );
+
+    std::cout.setf( std::ios::right, std::ios::adjustfield );
+    std::cout.precision( 5 );
+    std::cout << "    ISA,     DB MP/s,     2D MP/s,  Blend MP/s" << std::endl;
+
+    for( int simd = eq::Compositor::SIMD_NONE;
+         simd <= eq::Compositor::SIMD_AVX512; ++simd )
+    {
+        if( !eq::Compositor::setSIMD( eq::Compositor::SIMD( simd )))
+        {
+            std::cout << std::setw(7) << _simdNames[ simd ]
+                      << ", not supported" << std::endl;
+            continue;
+        }
+
+        TEST( _getResult( dbOps, false, eq::Frame::BUFFER_COLOR ) == dbColor );
+        TEST( _getResult( dbOps, false, eq::Frame::BUFFER_DEPTH ) == dbDepth );
+        TEST( _getResult( colorOps, true, eq::Frame::BUFFER_COLOR ) ==
+              blended );
+
+        std::cout << std::setw(7) << _simdNames[ simd ] << ", "
+                  << std::setw(11) << _measure( dbOps, false ) << ", "
+                  << std::setw(11) << _measure( colorOps, false ) << ", ";
+        if( canBlend )
+            std::cout << std::setw(11) << _measure( colorOps, true );
+        else
+            std::cout << "        n/a";
+        std::cout << std::endl;
+    }
+    TEST( eq::Compositor::setSIMD( eq::Compositor::SIMD_AUTO ));
+
+    // Input bandwidth of the merge modes over the number of DB input images.
+    // Images are reused for more than _nImages inputs, which does not matter
+    // since a 4K image does not fit into any cache.
+    const eq::Compositor::MergeMode modes[] = {
+        eq::Compositor::MERGE_SEQUENTIAL, eq::Compositor::MERGE_TILED,
+        eq::Compositor::MERGE_TREE };
+    const char* const modeNames[] = { "sequential", "tiled", "tree" };
+    const size_t imageSize = dbImages.front()->getPixelDataSize(
+                                 eq::Frame::BUFFER_COLOR ) +
+                             dbImages.front()->getPixelDataSize(
+                                 eq::Frame::BUFFER_DEPTH );
+
+    std::cout << std::endl << "IMAGES, sequential GB/s,      tiled GB/s,"
+              << "       tree GB/s" << std::endl;
+    for( size_t nInputs = 2; nInputs <= 2 * _nImages; nInputs *= 2 )
+    {
+        eq::ImageOps ops;
+        for( size_t i = 0; i < nInputs; ++i )
+            ops.push_back( dbOps[ i % _nImages ] );
+
+        eq::Compositor::setMergeMode( eq::Compositor::MERGE_SEQUENTIAL );
+        const std::vector< uint8_t > color =
+            _getResult( ops, false, eq::Frame::BUFFER_COLOR );
+
+        std::cout << std::setw(6) << nInputs;
+        for( size_t i = 0; i < 3; ++i )
+        {
+            eq::Compositor::setMergeMode( modes[i] );
+            TESTINFO( _getResult( ops, false, eq::Frame::BUFFER_COLOR ) ==
+                      color, modeNames[i] );
+
+            const float mPixels = _measure( ops, false );
+            const float gBytes = mPixels * float( imageSize ) /
+                                 float( pvp.getArea( )) / 1000.f;
+            std::cout << ", " << std::setw(15) << gBytes;
+        }
+        std::cout << std::endl;
+    }
+    eq::Compositor::setMergeMode( eq::Compositor::MERGE_TILED );
+
+    for( size_t i = 0; i < _nImages; ++i )
+    {
+        delete dbImages[i];
+        delete colorImages[i];
+    }
+    TEST( eq::exit( ));
+    return EXIT_SUCCESS;
+}
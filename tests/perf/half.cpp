@@ -0,0 +1,238 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include <lunchbox/test.h>
+
+#include <eq/compositor.h>
+#include <eq/half.h>
+#include <eq/image.h>
+#include <eq/imageOp.h>
+#include <eq/init.h>
+#include <eq/nodeFactory.h>
+#include <eq/pixelData.h>
+
+#include <lunchbox/clock.h>
+#include <lunchbox/rng.h>
+#include <pression/plugins/compressor.h>
+
+// Measures the throughput of the half float array conversions and of the CPU
+// compositing of RGBA16F and RGBA32F images for each instruction set supported
+// by the CPU, and tests that the results are identical to the scalar code.
+
+namespace
+{
+const size_t _nValues = 3840 * 2160 * 4; // 4K RGBA
+const int32_t _width = 1920;
+const int32_t _height = 1080;
+const size_t _nImages = 4;
+const size_t _nLoops = 10;
+
+const char* const _simdNames[] = { "auto", "scalar", "SSE4.1", "AVX2",
+                                   "AVX-512" };
+
+/** Premultiplied colors and depth values in the range of an OpenGL readback. */
+void _setPixels( eq::Image& image, const uint32_t format, const bool depth,
+                 lunchbox::RNG& rng )
+{
+    const bool isHalf = format == EQ_COMPRESSOR_DATATYPE_RGBA16F;
+    const size_t nPixels = image.getPixelViewport().getArea();
+
+    eq::PixelData pixels;
+    pixels.internalFormat = format;
+    pixels.externalFormat = format;
+    pixels.pixelSize = isHalf ? 8 : 16;
+    pixels.pvp = image.getPixelViewport();
+    image.setPixelData( eq::Frame::BUFFER_COLOR, pixels );
+
+    std::vector< float > colors( nPixels * 4 );
+    for( size_t i = 0; i < nPixels * 4; i += 4 )
+    {
+        colors[i+3] = rng.get< float >();
+        for( size_t j = 0; j < 3; ++j )
+            colors[i+j] = colors[i+3] * rng.get< float >();
+    }
+    uint8_t* color = image.getPixelPointer( eq::Frame::BUFFER_COLOR );
+    if( isHalf )
+        half_from_float_array( reinterpret_cast< uint16_t* >( color ),
+                               colors.data(), colors.size( ));
+    else
+        ::memcpy( color, colors.data(), colors.size() * sizeof( float ));
+
+    if( !depth )
+        return;
+
+    pixels.internalFormat = EQ_COMPRESSOR_DATATYPE_DEPTH;
+    pixels.externalFormat = EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT;
+    pixels.pixelSize = 4;
+    image.setPixelData( eq::Frame::BUFFER_DEPTH, pixels );
+
+    uint32_t* depths = reinterpret_cast< uint32_t* >(
+                           image.getPixelPointer( eq::Frame::BUFFER_DEPTH ));
+    for( size_t i = 0; i < nPixels; ++i )
+        depths[i] = rng.get< uint32_t >();
+}
+
+/** @return the conversion throughput in MValues/s */
+template< class D, class S >
+float _measure( void (*convert)( D*, const S*, size_t ), std::vector< D >& dest,
+                const std::vector< S >& source )
+{
+    convert( dest.data(), source.data(), source.size( )); // warm up
+
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < _nLoops; ++i )
+        convert( dest.data(), source.data(), source.size( ));
+    return float( _nLoops ) * float( source.size( )) / clock.getTimef() /
+           1000.f;
+}
+
+/** @return the compositing throughput in MPixel/s */
+float _measure( const eq::ImageOps& ops, const bool blend )
+{
+    TEST( eq::Compositor::mergeImagesCPU( ops, blend )); // warm up
+
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < _nLoops; ++i )
+        eq::Compositor::mergeImagesCPU( ops, blend );
+    const float time = clock.getTimef();
+
+    const float nPixels = float( _nLoops ) * float( ops.size( )) *
+                          float( _width ) * float( _height );
+    return nPixels / time / 1000.f;
+}
+
+std::vector< uint8_t > _getResult( const eq::ImageOps& ops, const bool blend )
+{
+    const eq::Image* result = eq::Compositor::mergeImagesCPU( ops, blend );
+    TEST( result );
+    const uint8_t* data = result->getPixelPointer( eq::Frame::BUFFER_COLOR );
+    return std::vector< uint8_t >( data, data + result->getPixelDataSize(
+                                                    eq::Frame::BUFFER_COLOR ));
+}
+}
+
+int main( int argc, char **argv )
+{
+    eq::NodeFactory nodeFactory;
+    TEST( eq::init( argc, argv, &nodeFactory ));
+
+    // all half values, including denormals, infinities and NaNs
+    lunchbox::RNG rng;
+    std::vector< uint16_t > halfs( _nValues );
+    for( size_t i = 0; i < _nValues; ++i )
+        halfs[i] = uint16_t( i );
+
+    // floats in the range of half floats, with some out of range
+    std::vector< float > floats( _nValues );
+    for( size_t i = 0; i < _nValues; ++i )
+        floats[i] = ( rng.get< float >() - .5f ) * 140000.f;
+
+    const eq::PixelViewport pvp( 0, 0, _width, _height );
+    const uint32_t formats[] = { EQ_COMPRESSOR_DATATYPE_RGBA16F,
+                                 EQ_COMPRESSOR_DATATYPE_RGBA32F };
+    eq::ImageOps ops[2][2]; // [format][ DB, blend ]
+    std::vector< eq::Image* > images;
+
+    for( size_t i = 0; i < 2; ++i )
+    {
+        for( size_t j = 0; j < _nImages; ++j )
+        {
+            eq::Image* image = new eq::Image;
+            image->setPixelViewport( pvp );
+            _setPixels( *image, formats[i], true, rng );
+            images.push_back( image );
+
+            eq::ImageOp op;
+            op.image = image;
+            op.buffers = eq::Frame::BUFFER_COLOR | eq::Frame::BUFFER_DEPTH;
+            ops[i][0].push_back( op );
+
+            // color only images for blending
+            image = new eq::Image;
+            image->setPixelViewport( pvp );
+            _setPixels( *image, formats[i], false, rng );
+            images.push_back( image );
+
+            op.image = image;
+            op.buffers = eq::Frame::BUFFER_COLOR;
+            ops[i][1].push_back( op );
+        }
+    }
+    const bool canBlend = ops[0][1].front().image->hasAlpha() &&
+                          ops[1][1].front().image->hasAlpha();
+
+    // Reference results of the scalar kernels
+    TEST( eq::Compositor::setSIMD( eq::Compositor::SIMD_NONE ));
+    std::vector< float > refFloats( _nValues );
+    std::vector< uint16_t > refHalfs( _nValues );
+    half_to_float_array( refFloats.data(), halfs.data(), _nValues );
+    half_from_float_array( refHalfs.data(), floats.data(), _nValues );
+
+    std::vector< uint8_t > references[2][2];
+    for( size_t i = 0; i < 2; ++i )
+        for( size_t j = 0; j < 2; ++j )
+            references[i][j] = _getResult( ops[i][j], j == 1 );
+
+    std::cout.setf( std::ios::right, std::ios::adjustfield );
+    std::cout.precision( 5 );
+    std::cout << "    ISA, toFloat MV/s,  toHalf MV/s,  16F DB MP/s,"
+              << " 16F Bl MP/s, 32F DB MP/s, 32F Bl MP/s" << std::endl;
+
+    std::vector< float > floatResult( _nValues );
+    std::vector< uint16_t > halfResult( _nValues );
+    for( int simd = eq::Compositor::SIMD_NONE;
+         simd <= eq::Compositor::SIMD_AVX512; ++simd )
+    {
+        if( !eq::Compositor::setSIMD( eq::Compositor::SIMD( simd )))
+        {
+            std::cout << std::setw(7) << _simdNames[ simd ]
+                      << ", not supported" << std::endl;
+            continue;
+        }
+
+        std::cout << std::setw(7) << _simdNames[ simd ] << ", "
+                  << std::setw(12) << _measure( half_to_float_array,
+                                                floatResult, halfs ) << ", "
+                  << std::setw(12) << _measure( half_from_float_array,
+                                                halfResult, floats );
+
+        // compare bits, NaN != NaN
+        TEST( ::memcmp( floatResult.data(), refFloats.data(),
+                        _nValues * sizeof( float )) == 0 );
+        TEST( halfResult == refHalfs );
+
+        for( size_t i = 0; i < 2; ++i )
+            for( size_t j = 0; j < 2; ++j )
+            {
+                if( j == 1 && !canBlend )
+                {
+                    std::cout << ",         n/a";
+                    continue;
+                }
+                TEST( _getResult( ops[i][j], j == 1 ) == references[i][j] );
+                std::cout << ", " << std::setw(11)
+                          << _measure( ops[i][j], j == 1 );
+            }
+        std::cout << std::endl;
+    }
+    TEST( eq::Compositor::setSIMD( eq::Compositor::SIMD_AUTO ));
+
+    for( eq::Image* image : images )
+        delete image;
+    TEST( eq::exit( ));
+    return EXIT_SUCCESS;
+}
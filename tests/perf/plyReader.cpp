@@ -0,0 +1,123 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include <lunchbox/test.h>
+
+#include <triply/vertexData.h>
+
+#include <lunchbox/clock.h>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+// Measures the read throughput of a binary PLY file using the memory-mapped
+// reader and the generic plyfile reader of triply, and tests that both read
+// the same data, using a synthetic colored grid mesh.
+
+namespace
+{
+const uint32_t _gridSize = 2048; // vertices in x and y
+const char* const _filename = "plyReader.ply";
+
+template< class T > void _append( std::vector< char >& buffer, const T& value )
+{
+    const char* data = reinterpret_cast< const char* >( &value );
+    buffer.insert( buffer.end(), data, data + sizeof( T ));
+}
+
+size_t _writeFile()
+{
+    const unsigned char test[2] = { 1, 0 };
+    const bool littleEndian = *reinterpret_cast< const short* >( test ) == 1;
+    const size_t nVertices = _gridSize * _gridSize;
+    const size_t nFaces = ( _gridSize - 1 ) * ( _gridSize - 1 ) * 2;
+
+    std::ofstream file( _filename, std::ios::binary );
+    file << "ply\nformat binary_" << ( littleEndian ? "little" : "big" )
+         << "_endian 1.0\nelement vertex " << nVertices
+         << "\nproperty float x\nproperty float y\nproperty float z"
+         << "\nproperty uchar red\nproperty uchar green\nproperty uchar blue"
+         << "\nelement face " << nFaces
+         << "\nproperty list uchar int vertex_indices\nend_header\n";
+
+    std::vector< char > buffer;
+    for( uint32_t y = 0; y < _gridSize; ++y )
+        for( uint32_t x = 0; x < _gridSize; ++x )
+        {
+            _append( buffer, float( x ));
+            _append( buffer, float( y ));
+            _append( buffer, float(( x * y ) % 17 ) * .1f );
+            _append( buffer, uint8_t( x ));
+            _append( buffer, uint8_t( y ));
+            _append( buffer, uint8_t( x + y ));
+        }
+
+    for( uint32_t y = 0; y < _gridSize - 1; ++y )
+        for( uint32_t x = 0; x < _gridSize - 1; ++x )
+        {
+            const int32_t i = int32_t( y * _gridSize + x );
+            const int32_t faces[2][3] = {{ i, i + 1, i + int32_t( _gridSize ) },
+                                         { i + 1, i + 1 + int32_t( _gridSize ),
+                                           i + int32_t( _gridSize ) }};
+            for( size_t j = 0; j < 2; ++j )
+            {
+                _append( buffer, uint8_t( 3 ));
+                for( size_t k = 0; k < 3; ++k )
+                    _append( buffer, faces[j][k] );
+            }
+        }
+
+    file.write( &buffer[0], buffer.size( ));
+    return size_t( file.tellp( ));
+}
+
+float _read( triply::VertexData& data, const bool mapped, const size_t size )
+{
+    data.useMappedReader( mapped );
+    lunchbox::Clock clock;
+    TEST( data.readPlyFile( _filename ));
+    const float time = clock.getTimef();
+    return float( size ) / 1048576.f / time * 1000.f; // MB/s
+}
+}
+
+int main( int, char** )
+{
+    const size_t size = _writeFile();
+    TEST( size > 0 );
+
+    triply::VertexData generic;
+    triply::VertexData mapped;
+    const float genericSpeed = _read( generic, false, size );
+    const float mappedSpeed = _read( mapped, true, size );
+
+    TEST( mapped.vertices.size() == _gridSize * _gridSize );
+    TEST( mapped.vertices == generic.vertices );
+    TEST( mapped.colors == generic.colors );
+    TEST( mapped.triangles == generic.triangles );
+
+    std::cout.setf( std::ios::right, std::ios::adjustfield );
+    std::cout.precision( 5 );
+    std::cout << "READER,   SIZE MB,       MB/s" << std::endl
+              << "generic, " << std::setw(8) << float( size ) / 1048576.f
+              << ", " << std::setw(10) << genericSpeed << std::endl
+              << " mapped, " << std::setw(8) << float( size ) / 1048576.f
+              << ", " << std::setw(10) << mappedSpeed << std::endl;
+
+    ::remove( _filename );
+    return EXIT_SUCCESS;
+}
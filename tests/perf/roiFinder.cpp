@@ -0,0 +1,174 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include <lunchbox/test.h>
+
+#include <eq/compositor.h>
+#include <eq/roiFinder.h>
+
+#include <lunchbox/clock.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+
+// Measures the time of the CPU region of interest analysis for each
+// instruction set supported by the CPU, using synthetic 4K depth masks with an
+// increasing number of round objects, and reports the fraction of the image
+// left for transmission. Compares the full and the incremental analysis for
+// slowly moving objects.
+
+namespace
+{
+const eq::PixelViewport _pvp( 0, 0, 3840, 2160 );
+const size_t _objects[] = { 0, 1, 8, 64, 512 };
+const size_t _nMasks = sizeof( _objects ) / sizeof( size_t );
+const size_t _nLoops = 20;
+const uint32_t _nFrames = 50;
+
+const char* const _simdNames[] = { "auto", "scalar", "SSE4.1", "AVX2",
+                                   "AVX-512" };
+
+/** Every fourth object moves by frame pixels */
+std::vector< uint32_t > _createMask( const size_t nObjects,
+                                     const uint32_t frame = 0 )
+{
+    std::vector< uint32_t > mask( _pvp.getArea(), 0xffffffffu );
+    std::srand( 42 );
+    for( size_t i = 0; i < nObjects; ++i )
+    {
+        const int32_t radius = 10 + std::rand() % 150;
+        const int32_t offset = i % 4 == 0 ? int32_t( frame ) : 0;
+        const int32_t cx = std::rand() % _pvp.w + offset;
+        const int32_t cy = std::rand() % _pvp.h + offset;
+
+        for( int32_t y = std::max( 0, cy - radius );
+             y < std::min( _pvp.h, cy + radius ); ++y )
+        {
+            for( int32_t x = std::max( 0, cx - radius );
+                 x < std::min( _pvp.w, cx + radius ); ++x )
+            {
+                const int32_t dx = x - cx;
+                const int32_t dy = y - cy;
+                if( dx * dx + dy * dy < radius * radius )
+                    mask[ y * _pvp.w + x ] = uint32_t( dx * dx + dy * dy );
+            }
+        }
+    }
+    return mask;
+}
+
+/** @return the time per analysis in milliseconds. */
+float _measure( eq::ROIFinder& finder, const std::vector< uint32_t >& mask,
+                eq::PixelViewports& regions )
+{
+    lunchbox::Clock clock;
+    for( size_t i = 0; i < _nLoops; ++i )
+        regions = finder.findRegions( &mask[0], eq::ROIFinder::MASK_DEPTH,
+                                      _pvp );
+    return clock.getTimef() / float( _nLoops );
+}
+
+uint32_t _getArea( const eq::PixelViewports& regions )
+{
+    uint32_t area = 0;
+    for( size_t i = 0; i < regions.size(); ++i )
+        area += regions[i].getArea();
+    return area;
+}
+}
+
+int main( int, char** )
+{
+    eq::ROIFinder finder;
+
+    std::cout.setf( std::ios::right, std::ios::adjustfield );
+    std::cout.precision( 5 );
+    std::cout << "OBJECTS,     ISA,         ms, REGIONS,  AREA %" << std::endl;
+
+    for( size_t i = 0; i < _nMasks; ++i )
+    {
+        const std::vector< uint32_t > mask = _createMask( _objects[i] );
+        eq::PixelViewports reference;
+
+        for( int simd = eq::Compositor::SIMD_NONE;
+             simd <= eq::Compositor::SIMD_AVX512; ++simd )
+        {
+            if( !eq::Compositor::setSIMD( eq::Compositor::SIMD( simd )))
+                continue;
+
+            eq::PixelViewports regions;
+            const float time = _measure( finder, mask, regions );
+            if( simd == eq::Compositor::SIMD_NONE )
+                reference = regions;
+            TEST( regions == reference );
+
+            const uint32_t area = _getArea( regions );
+            std::cout << std::setw(7) << _objects[i] << ", "
+                      << std::setw(7) << _simdNames[ simd ] << ", "
+                      << std::setw(10) << time << ", "
+                      << std::setw(7) << regions.size() << ", "
+                      << std::setw(7) << 100.f * float( area ) /
+                                         float( _pvp.getArea( ))
+                      << std::endl;
+        }
+        if( _objects[i] == 0 )
+            TEST( reference.empty( ));
+    }
+    TEST( eq::Compositor::setSIMD( eq::Compositor::SIMD_AUTO ));
+
+    std::cout << std::endl
+              << "OBJECTS,    FULL ms,  AREA %, UPDATE ms,  AREA %,  REUSED %"
+              << std::endl;
+    for( size_t i = 1; i < _nMasks; ++i )
+    {
+        eq::ROIFinder incremental;
+        float times[2] = { 0.f, 0.f };
+        uint32_t areas[2] = { 0, 0 };
+        float reused = 0.f;
+
+        for( uint32_t frame = 0; frame < _nFrames; ++frame )
+        {
+            const std::vector< uint32_t > mask = _createMask( _objects[i],
+                                                              frame );
+            lunchbox::Clock clock;
+            const eq::PixelViewports full =
+                finder.findRegions( &mask[0], eq::ROIFinder::MASK_DEPTH,
+                                    _pvp );
+            times[0] += clock.getTimef();
+
+            clock.reset();
+            const eq::PixelViewports updated =
+                incremental.findRegions( &mask[0], eq::ROIFinder::MASK_DEPTH,
+                                         _pvp, 0, frame );
+            times[1] += clock.getTimef();
+
+            areas[0] += _getArea( full );
+            areas[1] += _getArea( updated );
+            reused += incremental.getReusedRatio();
+        }
+
+        const float total = float( _pvp.getArea( )) * float( _nFrames );
+        std::cout << std::setw(7) << _objects[i] << ", "
+                  << std::setw(10) << times[0] / float( _nFrames ) << ", "
+                  << std::setw(7) << 100.f * float( areas[0] ) / total << ", "
+                  << std::setw(9) << times[1] / float( _nFrames ) << ", "
+                  << std::setw(7) << 100.f * float( areas[1] ) / total << ", "
+                  << std::setw(9) << 100.f * reused / float( _nFrames )
+                  << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include <lunchbox/test.h>
+
+#include <eq/server/config.h>
+#include <eq/server/global.h>
+#include <eq/server/loader.h>
+#include <eq/server/server.h>
+#include <eq/server/simulator.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// Measures the server time to start a frame for generated sort-first
+// load-balanced configurations with 64 to 512 render nodes, using the
+// simulator without render clients: the compound update and the generation of
+// the tasks of all nodes, serially and in parallel, and the size of the task
+// commands sent to the nodes per frame. Usage: serverFrame [dir]
+// also writes the generated configurations to dir, for measurements with
+// render clients using the server frame statistic.
+
+using eq::server::Config;
+using eq::server::Simulator;
+
+namespace
+{
+const size_t _nodes[] = { 64, 128, 256, 512 };
+const size_t _nConfigs = sizeof( _nodes ) / sizeof( size_t );
+const uint32_t _nFrames = 100;
+
+/** One channel per node, all assembled on the application node. */
+std::string _generateConfig( const size_t nNodes )
+{
+    std::ostringstream os;
+    os << "#Equalizer 1.1 ascii\n"
+       << "# " << nNodes << "-node sort-first load-balanced config\n\n"
+       << "server\n{\n"
+       << "    connection { hostname \"127.0.0.1\" }\n"
+       << "    config\n    {\n"
+       << "        appNode { pipe { window { channel { name \"channel0\" }}}}\n";
+
+    for( size_t i = 1; i <= nNodes; ++i )
+        os << "        node\n        {\n"
+           << "            connection { hostname \"node" << i << "\" }\n"
+           << "            pipe { window { channel { name \"channel" << i
+           << "\" }}}\n        }\n";
+
+    os << "        observer {}\n"
+       << "        layout { view { observer 0 }}\n"
+       << "        canvas\n        {\n"
+       << "            layout 0\n            wall {}\n"
+       << "            segment { channel \"channel0\" }\n        }\n"
+       << "        compound\n        {\n"
+       << "            channel ( segment 0 view 0 )\n"
+       << "            load_equalizer { mode 2D }\n"
+       << "            wall\n            {\n"
+       << "                bottom_left  [ -.32 -.20 -.75 ]\n"
+       << "                bottom_right [  .32 -.20 -.75 ]\n"
+       << "                top_left     [ -.32  .20 -.75 ]\n"
+       << "            }\n";
+
+    for( size_t i = 1; i <= nNodes; ++i )
+        os << "            compound { channel \"channel" << i
+           << "\" outputframe {}}\n";
+    for( size_t i = 1; i <= nNodes; ++i )
+        os << "            inputframe { name \"frame.channel" << i << "\" }\n";
+
+    os << "        }\n    }\n}\n";
+    return os.str();
+}
+
+eq::server::ServerPtr _load( const std::string& config )
+{
+    eq::server::Global::clear();
+    eq::server::Loader loader;
+    eq::server::ServerPtr server = loader.parseServer( config.c_str( ));
+    TEST( server );
+    TEST( server->getConfigs().size() == 1 );
+
+    eq::server::Loader::addOutputCompounds( server );
+    eq::server::Loader::addDestinationViews( server );
+    eq::server::Loader::addDefaultObserver( server );
+    eq::server::Loader::convertTo11( server );
+    eq::server::Loader::convertTo12( server );
+    return server;
+}
+
+Simulator::Result _simulate( const std::string& config, const int32_t hint,
+                             const Simulator::CostModel& model )
+{
+    eq::server::ServerPtr server = _load( config );
+    Config* serverConfig = server->getConfigs().front();
+    serverConfig->setIAttribute( Config::IATTR_HINT_PARALLEL_TASKS, hint );
+
+    Simulator simulator( *serverConfig, model );
+    simulator.setTaskGeneration( true );
+    simulator.run( _nFrames );
+
+    const Simulator::Result result = simulator.getResult();
+    TESTINFO( result.frames == _nFrames, result );
+    TESTINFO( result.taskBytes > 0.f, result );
+    return result;
+}
+}
+
+int main( int argc, char** argv )
+{
+    const Simulator::HeatMap model( 1, 1, std::vector< float >( 1, 16.f ));
+
+    std::cout.setf( std::ios::right, std::ios::adjustfield );
+    std::cout.precision( 5 );
+    std::cout << "  NODES,  UPDATE ms,  SERIAL ms, PARALLEL ms,   KB/frame"
+              << std::endl;
+
+    for( size_t i = 0; i < _nConfigs; ++i )
+    {
+        const std::string config = _generateConfig( _nodes[i] );
+        if( argc > 1 )
+        {
+            std::ostringstream filename;
+            filename << argv[1] << "/serverFrame." << _nodes[i] << ".eqc";
+            std::ofstream file( filename.str().c_str( ));
+            file << config;
+            TESTINFO( file.good(), filename.str( ));
+        }
+
+        const Simulator::Result serial = _simulate( config, eq::fabric::OFF,
+                                                    model );
+        const Simulator::Result parallel = _simulate( config, eq::fabric::ON,
+                                                      model );
+
+        std::cout << std::setw(7) << _nodes[i] << ", "
+                  << std::setw(10) << serial.updateTime << ", "
+                  << std::setw(10) << serial.taskTime << ", "
+                  << std::setw(11) << parallel.taskTime << ", "
+                  << std::setw(10) << serial.taskBytes / 1024.f << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include <lunchbox/test.h>
+
+#include <triply/vertexBufferRoot.h>
+
+#include <lunchbox/clock.h>
+#include <lunchbox/file.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+// Measures the size of the binary kd-tree file and the build and load times
+// of a triply model with full and compact data, and tests the error bounds of
+// the compact data, using a synthetic height field mesh.
+
+namespace
+{
+const uint32_t _gridSize = 1024; // vertices in x and y
+const std::string _filename( "triplyCompact.ply" );
+
+// max vertex error for leaves within the model size of 2, and normal error
+const float _maxVertexError = std::sqrt( 3.f ) * .5f / 32767.f;
+const float _maxNormalError = 1.f; // degrees
+
+template< class T > void _append( std::vector< char >& buffer, const T& value )
+{
+    const char* data = reinterpret_cast< const char* >( &value );
+    buffer.insert( buffer.end(), data, data + sizeof( T ));
+}
+
+void _writeFile()
+{
+    const unsigned char test[2] = { 1, 0 };
+    const bool littleEndian = *reinterpret_cast< const short* >( test ) == 1;
+    const size_t nVertices = _gridSize * _gridSize;
+    const size_t nFaces = ( _gridSize - 1 ) * ( _gridSize - 1 ) * 2;
+
+    std::ofstream file( _filename.c_str(), std::ios::binary );
+    file << "ply\nformat binary_" << ( littleEndian ? "little" : "big" )
+         << "_endian 1.0\nelement vertex " << nVertices
+         << "\nproperty float x\nproperty float y\nproperty float z"
+         << "\nelement face " << nFaces
+         << "\nproperty list uchar int vertex_indices\nend_header\n";
+
+    std::vector< char > buffer;
+    for( uint32_t y = 0; y < _gridSize; ++y )
+        for( uint32_t x = 0; x < _gridSize; ++x )
+        {
+            _append( buffer, float( x ));
+            _append( buffer, float( y ));
+            _append( buffer, 50.f * std::sin( float( x ) * .02f ) *
+                                    std::cos( float( y ) * .03f ));
+        }
+
+    for( uint32_t y = 0; y < _gridSize - 1; ++y )
+        for( uint32_t x = 0; x < _gridSize - 1; ++x )
+        {
+            const int32_t i = int32_t( y * _gridSize + x );
+            const int32_t faces[2][3] = {{ i, i + 1, i + int32_t( _gridSize ) },
+                                         { i + 1, i + 1 + int32_t( _gridSize ),
+                                           i + int32_t( _gridSize ) }};
+            for( size_t j = 0; j < 2; ++j )
+            {
+                _append( buffer, uint8_t( 3 ));
+                for( size_t k = 0; k < 3; ++k )
+                    _append( buffer, faces[j][k] );
+            }
+        }
+
+    file.write( &buffer[0], buffer.size( ));
+}
+
+// the binary file written by the last model build
+size_t _getBinarySize( const bool compact )
+{
+    const lunchbox::Strings files =
+        lunchbox::searchDirectory( ".", _filename + "\\..*" );
+    for( const std::string& file : files )
+    {
+        const bool isCompact = file.find( ".compact." ) != std::string::npos;
+        if( isCompact != compact )
+            continue;
+
+        std::ifstream stream( file.c_str(), std::ios::binary | std::ios::ate );
+        return size_t( stream.tellg( ));
+    }
+    return 0;
+}
+
+void _removeFiles()
+{
+    const lunchbox::Strings files =
+        lunchbox::searchDirectory( ".", _filename + ".*" );
+    for( const std::string& file : files )
+        ::remove( file.c_str( ));
+}
+}
+
+int main( int, char** )
+{
+    _removeFiles();
+    _writeFile();
+
+    std::cout.setf( std::ios::right, std::ios::adjustfield );
+    std::cout.precision( 5 );
+    std::cout << "   DATA,    FILE MB,    BUILD s,    LOAD ms, VERTEX ERR,"
+              << " NORMAL DEG" << std::endl;
+
+    size_t sizes[2] = { 0, 0 };
+    for( size_t i = 0; i < 2; ++i )
+    {
+        const bool compact = i == 1;
+
+        triply::VertexBufferRoot built;
+        if( compact )
+            built.useCompactData();
+        lunchbox::Clock clock;
+        TEST( built.readFromFile( _filename ));
+        const float buildTime = clock.getTimef();
+        TEST( built.isCompact() == compact );
+
+        triply::VertexBufferRoot loaded;
+        if( compact )
+            loaded.useCompactData();
+        clock.reset();
+        TEST( loaded.readFromFile( _filename ));
+        const float loadTime = clock.getTimef();
+        TEST( loaded.isCompact() == compact );
+        TEST( loaded.getNumberOfVertices() == built.getNumberOfVertices( ));
+
+        sizes[i] = _getBinarySize( compact );
+        TEST( sizes[i] > 0 );
+
+        std::cout << std::setw(7) << ( compact ? "compact" : "full" ) << ", "
+                  << std::setw(10) << float( sizes[i] ) / 1048576.f << ", "
+                  << std::setw(10) << buildTime / 1000.f << ", "
+                  << std::setw(10) << loadTime << ", "
+                  << std::setw(10) << built.getMaxVertexError() << ", "
+                  << std::setw(10) << built.getMaxNormalError() << std::endl;
+
+        if( compact )
+        {
+            TESTINFO( built.getMaxVertexError() <= _maxVertexError,
+                      built.getMaxVertexError( ));
+            TESTINFO( built.getMaxNormalError() <= _maxNormalError,
+                      built.getMaxNormalError( ));
+        }
+    }
+
+    TESTINFO( sizes[1] * 3 < sizes[0] * 2, sizes[1] << " of " << sizes[0] );
+    _removeFiles();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define TEST_RUNTIME 600 // seconds
+#include <lunchbox/test.h>
+
+#include <triply/vertexBufferRoot.h>
+#include <triply/vertexBufferState.h>
+
+#include <lunchbox/clock.h>
+#include <lunchbox/file.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+// Measures the time of the CPU culling pass of triply models with increasing
+// leaf counts, with and without level-of-detail proxies, for a camera moving
+// around and into synthetic height field meshes. Does not use OpenGL.
+
+namespace
+{
+const uint32_t _gridSizes[] = { 256, 512, 1024, 2048 }; // vertices in x and y
+const size_t _nModels = sizeof( _gridSizes ) / sizeof( uint32_t );
+const size_t _nFrames = 1000;
+const std::string _filename( "triplyCull.ply" );
+
+template< class T > void _append( std::vector< char >& buffer, const T& value )
+{
+    const char* data = reinterpret_cast< const char* >( &value );
+    buffer.insert( buffer.end(), data, data + sizeof( T ));
+}
+
+void _writeFile( const uint32_t gridSize )
+{
+    const unsigned char test[2] = { 1, 0 };
+    const bool littleEndian = *reinterpret_cast< const short* >( test ) == 1;
+    const size_t nVertices = gridSize * gridSize;
+    const size_t nFaces = ( gridSize - 1 ) * ( gridSize - 1 ) * 2;
+
+    std::ofstream file( _filename.c_str(), std::ios::binary );
+    file << "ply\nformat binary_" << ( littleEndian ? "little" : "big" )
+         << "_endian 1.0\nelement vertex " << nVertices
+         << "\nproperty float x\nproperty float y\nproperty float z"
+         << "\nelement face " << nFaces
+         << "\nproperty list uchar int vertex_indices\nend_header\n";
+
+    std::vector< char > buffer;
+    for( uint32_t y = 0; y < gridSize; ++y )
+        for( uint32_t x = 0; x < gridSize; ++x )
+        {
+            _append( buffer, float( x ));
+            _append( buffer, float( y ));
+            _append( buffer, 20.f * std::sin( float( x ) * .02f ) *
+                                    std::cos( float( y ) * .03f ));
+        }
+
+    for( uint32_t y = 0; y < gridSize - 1; ++y )
+        for( uint32_t x = 0; x < gridSize - 1; ++x )
+        {
+            const int32_t i = int32_t( y * gridSize + x );
+            const int32_t faces[2][3] = {{ i, i + 1, i + int32_t( gridSize ) },
+                                         { i + 1, i + 1 + int32_t( gridSize ),
+                                           i + int32_t( gridSize ) }};
+            for( size_t j = 0; j < 2; ++j )
+            {
+                _append( buffer, uint8_t( 3 ));
+                for( size_t k = 0; k < 3; ++k )
+                    _append( buffer, faces[j][k] );
+            }
+        }
+
+    file.write( &buffer[0], buffer.size( ));
+}
+
+void _removeFiles()
+{
+    const lunchbox::Strings files =
+        lunchbox::searchDirectory( ".", _filename + ".*" );
+    for( const std::string& file : files )
+        ::remove( file.c_str( ));
+}
+
+size_t _countLeaves( const triply::VertexBufferBase* node )
+{
+    if( !node->getLeft() && !node->getRight( ))
+        return 1;
+    return ( node->getLeft() ? _countLeaves( node->getLeft( )) : 0 ) +
+           ( node->getRight() ? _countLeaves( node->getRight( )) : 0 );
+}
+
+GLEWContext _glewContext;
+
+/** A state without OpenGL objects for culling only. */
+class State : public triply::VertexBufferState
+{
+public:
+    State() : triply::VertexBufferState( &_glewContext ) {}
+
+    GLuint getDisplayList( const void* ) override { return INVALID; }
+    GLuint newDisplayList( const void* ) override { return INVALID; }
+    GLuint getBufferObject( const void* ) override { return INVALID; }
+    GLuint newBufferObject( const void* ) override { return INVALID; }
+    void deleteAll() override {}
+};
+
+/** 90 degree perspective projection of a camera orbiting the model. */
+triply::Matrix4f _getMatrix( const size_t frame )
+{
+    triply::Matrix4f projection( triply::Matrix4f::ZERO );
+    const float nearPlane = .01f;
+    const float farPlane = 10.f;
+    projection( 0, 0 ) = 1.f;
+    projection( 1, 1 ) = 1.6f; // 16:10
+    projection( 2, 2 ) = -( farPlane + nearPlane ) / ( farPlane - nearPlane );
+    projection( 2, 3 ) = -2.f * farPlane * nearPlane / ( farPlane - nearPlane );
+    projection( 3, 2 ) = -1.f;
+
+    const float angle = float( frame ) * .01f;
+    triply::Matrix4f modelView( triply::Matrix4f::IDENTITY );
+    modelView.rotate_x( -1.f );
+    modelView.rotate_y( angle );
+    const float distance = .2f + std::fabs( std::sin( angle ));
+    modelView.setTranslation( triply::Vertex( 0.f, 0.f, -distance ));
+    return projection * modelView;
+}
+
+/** @return the average culling time in microseconds and draw list size. */
+float _cull( const triply::VertexBufferRoot& model, State& state,
+             size_t& nItems )
+{
+    triply::VertexBufferRoot::DrawList list;
+    nItems = 0;
+    float time = 0.f;
+    for( size_t i = 0; i < _nFrames; ++i )
+    {
+        state.setProjectionModelViewMatrix( _getMatrix( i ));
+        lunchbox::Clock clock;
+        model.cull( state, list );
+        time += clock.getTimef();
+        nItems += list.size();
+    }
+    nItems /= _nFrames;
+    return time * 1000.f / float( _nFrames );
+}
+}
+
+int main( int, char** )
+{
+    std::cout.setf( std::ios::right, std::ios::adjustfield );
+    std::cout.precision( 5 );
+    std::cout << " LEAVES,  TRIANGLES,    FULL us,  ITEMS,     LOD us,  ITEMS"
+              << std::endl;
+
+    State state;
+    state.setViewportSize( 1920.f, 1200.f );
+
+    for( size_t i = 0; i < _nModels; ++i )
+    {
+        _removeFiles();
+        _writeFile( _gridSizes[i] );
+
+        triply::VertexBufferRoot model;
+        TEST( model.readFromFile( _filename ));
+        TEST( model.getLOD( ));
+
+        // culling is deterministic, including the order of the draw list
+        triply::VertexBufferRoot::DrawList list1, list2;
+        state.setLODThreshold( 0.f );
+        state.setProjectionModelViewMatrix( _getMatrix( 42 ));
+        model.cull( state, list1 );
+        model.cull( state, list2 );
+        TEST( !list1.empty( ));
+        TEST( list1 == list2 );
+
+        size_t fullItems = 0;
+        const float fullTime = _cull( model, state, fullItems );
+
+        size_t lodItems = 0;
+        state.setLODThreshold( 1.f );
+        const float lodTime = _cull( model, state, lodItems );
+
+        std::cout << std::setw(7) << _countLeaves( &model ) << ", "
+                  << std::setw(10) << model.getNumberOfVertices() / 3 << ", "
+                  << std::setw(10) << fullTime << ", "
+                  << std::setw(6) << fullItems << ", "
+                  << std::setw(10) << lodTime << ", "
+                  << std::setw(6) << lodItems << std::endl;
+    }
+
+    _removeFiles();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Replays a load trace of four resources through a predictive DB load
+// equalizer driven by the simulator. Tests that the predicted split balances
+// the frame time within two frames of a change of the rendering load, and
+// within three frames if the overheads change as well.
+
+#include <lunchbox/test.h>
+#include <eq/server/channel.h>
+#include <eq/server/config.h>
+#include <eq/server/equalizers/loadModel.h>
+#include <eq/server/global.h>
+#include <eq/server/loader.h>
+#include <eq/server/server.h>
+#include <eq/server/simulator.h>
+
+#include <cmath>
+#include <sstream>
+
+using eq::server::LoadModel;
+using eq::server::Simulator;
+
+namespace
+{
+const size_t _nResources = 4;
+const size_t _nFrames = 80;
+const float _maxImbalance = .05f; // max time over mean time
+const float _scale = 10.f; // of the trace times, statistics are in whole ms
+
+// The actual overhead in ms and time in ms for the full work of each resource
+struct Phase
+{
+    size_t start; // first frame
+    size_t convergence; // frames until balanced
+    float overhead[ _nResources ];
+    float rate[ _nResources ];
+    float drift; // per-frame rate change, simulates camera motion
+};
+
+const Phase _trace[] = {
+    { 0,  2, { 2.f, 0.f, 1.f, 0.f }, { 40.f, 20.f, 30.f, 25.f }, 0.f },
+    { 20, 2, { 2.f, 0.f, 1.f, 0.f }, { 15.f, 60.f, 30.f, 10.f }, 0.f },
+    { 40, 3, { 0.f, 3.f, 0.f, 1.f }, { 20.f, 20.f, 40.f, 40.f }, 0.f },
+    { 60, 0, { 0.f, 3.f, 0.f, 1.f }, { 20.f, 20.f, 40.f, 40.f }, .02f }
+};
+const size_t _nPhases = sizeof( _trace ) / sizeof( Phase );
+
+const Phase& _getPhase( const size_t frame )
+{
+    size_t phase = 0;
+    while( phase + 1 < _nPhases && _trace[ phase + 1 ].start <= frame )
+        ++phase;
+    return _trace[ phase ];
+}
+
+/** The draw time of the trace for the channels "channel0" to "channel3". */
+class TraceModel : public Simulator::CostModel
+{
+public:
+    float getDrawTime( const eq::server::Channel& channel,
+                       const eq::fabric::RenderContext& context,
+                       const uint32_t frameNumber ) const override
+    {
+        const std::string& name = channel.getName();
+        const size_t i = size_t( name[ name.length() - 1 ] - '0' );
+        TEST( i < _nResources );
+
+        const size_t frame = frameNumber - 1; // simulated frames start at 1
+        const Phase& phase = _getPhase( frame );
+        const float rate = phase.rate[i] *
+            std::pow( 1.f + phase.drift, float( frame - phase.start ));
+        const float work = context.vp.getArea() * context.range.getSize();
+
+        // deterministic +-1% measurement noise
+        const float noise = 1.f + .01f * float( int(( frame + i ) % 3 ) - 1);
+        return ( phase.overhead[i] + rate * work ) * noise * _scale;
+    }
+};
+
+/** Four channels rendering a DB range each, without latency. */
+std::string _createConfig()
+{
+    std::ostringstream os;
+    os << "#Equalizer 1.1 ascii\n"
+       << "server\n{\n"
+       << "    connection { hostname \"127.0.0.1\" }\n"
+       << "    config\n    {\n"
+       << "        latency 0\n"
+       << "        appNode\n        {\n"
+       << "            pipe { window { channel { name \"destination\" }}}\n";
+    for( size_t i = 0; i < _nResources; ++i )
+        os << "            pipe { window { channel { name \"channel" << i
+           << "\" }}}\n";
+
+    os << "        }\n"
+       << "        observer {}\n"
+       << "        layout { view { observer 0 }}\n"
+       << "        canvas\n        {\n"
+       << "            layout 0\n            wall {}\n"
+       << "            segment { channel \"destination\" }\n        }\n"
+       << "        compound\n        {\n"
+       << "            channel ( segment 0 view 0 )\n"
+       << "            buffer [ COLOR DEPTH ]\n"
+       << "            load_equalizer { mode DB predictive ON }\n";
+    for( size_t i = 0; i < _nResources; ++i )
+        os << "            compound { channel \"channel" << i
+           << "\" outputframe {}}\n";
+    for( size_t i = 0; i < _nResources; ++i )
+        os << "            inputframe { name \"frame.channel" << i << "\" }\n";
+
+    os << "        }\n    }\n}\n";
+    return os.str();
+}
+}
+
+int main( int, char** )
+{
+    // exact fit with two samples
+    LoadModel model;
+    TEST( !model.isValid( ));
+    model.addSample( .5f, 22.f );
+    TEST( model.isValid( ));
+    model.addSample( .3125f, 14.5f );
+    TESTINFO( std::abs( model.getOverhead() - 2.f ) < .001f, model );
+    TESTINFO( std::abs( model.getRate() - 40.f ) < .001f, model );
+
+    LoadModel other;
+    other.addSample( .5f, 10.f );
+    const float share = LoadModel::split( model, other, 1.f );
+    TESTINFO( std::abs( model.predict( share ) -
+                        other.predict( 1.f - share )) < .001f, share );
+
+    // replay trace through the load equalizer
+    eq::server::Loader loader;
+    const std::string config = _createConfig();
+    eq::server::ServerPtr server = loader.parseServer( config.c_str( ));
+    TEST( server );
+    TEST( server->getConfigs().size() == 1 );
+
+    eq::server::Loader::addOutputCompounds( server );
+    eq::server::Loader::addDestinationViews( server );
+    eq::server::Loader::addDefaultObserver( server );
+    eq::server::Loader::convertTo11( server );
+    eq::server::Loader::convertTo12( server );
+
+    const TraceModel trace;
+    {
+        Simulator simulator( *server->getConfigs().front(), trace );
+        simulator.run( _nFrames );
+
+        const std::vector< float >& imbalances = simulator.getImbalances();
+        TESTINFO( imbalances.size() == _nFrames, imbalances.size( ));
+        for( size_t frame = 0; frame < _nFrames; ++frame )
+        {
+            const Phase& phase = _getPhase( frame );
+            if( frame >= phase.start + phase.convergence )
+                TESTINFO( imbalances[ frame ] < _maxImbalance,
+                          "frame " << frame << " imbalance "
+                          << imbalances[ frame ] );
+        }
+    }
+
+    eq::server::Global::clear();
+    server->deleteConfigs(); // break server <-> config ref circle
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Simulates load-balanced example configurations rendering a scene whose cost
+// is concentrated in one corner of the view, and tests that the equalizers
+// converge and keep the channel times balanced. Usage: simulator [file.eqc]
+// simulates and reports only the given configuration.
+
+#include <lunchbox/test.h>
+
+#include <eq/server/config.h>
+#include <eq/server/global.h>
+#include <eq/server/loader.h>
+#include <eq/server/server.h>
+#include <eq/server/simulator.h>
+
+using eq::server::Simulator;
+
+namespace
+{
+const uint32_t _nFrames = 1000;
+const size_t _size = 8; // heat map cells in x and y
+
+struct Case
+{
+    const char* config;
+    float motion; // heat map cells per frame
+    uint32_t convergence; // max frames until balanced
+    float imbalance; // max mean imbalance once balanced
+};
+
+const Case _cases[] = {
+    { "configs/2-window.2D.lb.eqc",     0.f,   50, .1f },
+    { "configs/2-window.DB.lb.eqc",     0.f,   50, .1f },
+    { "configs/4-window.DB.2D.lb.eqc",  0.f,   50, .1f },
+    { "configs/2-window.2D.lb.eqc",     .02f,  50, .15f },
+    { "configs/4-window.DB.2D.lb.eqc",  .02f,  50, .15f }
+};
+const size_t _nCases = sizeof( _cases ) / sizeof( Case );
+
+std::vector< float > _createCosts()
+{
+    // 67 ms per frame, 60% of it in the bottom left corner
+    std::vector< float > costs( _size * _size );
+    for( size_t y = 0; y < _size; ++y )
+        for( size_t x = 0; x < _size; ++x )
+            costs[ y * _size + x ] = x + y < 4 ? 4.f : .5f;
+    return costs;
+}
+
+bool _simulate( const std::string& filename, const Simulator::HeatMap& model,
+                Simulator::Result& result )
+{
+    eq::server::Loader loader;
+    eq::server::ServerPtr server = loader.loadFile( filename );
+    if( !server || server->getConfigs().empty( ))
+        return false;
+
+    eq::server::Loader::addOutputCompounds( server );
+    eq::server::Loader::addDestinationViews( server );
+    eq::server::Loader::addDefaultObserver( server );
+    eq::server::Loader::convertTo11( server );
+    eq::server::Loader::convertTo12( server );
+
+    {
+        Simulator simulator( *server->getConfigs().front(), model );
+        simulator.run( _nFrames );
+        result = simulator.getResult();
+    }
+
+    eq::server::Global::clear();
+    server->deleteConfigs(); // break server <-> config ref circle
+    return true;
+}
+}
+
+int main( int argc, char** argv )
+{
+    Simulator::HeatMap model( _size, _size, _createCosts( ));
+    Simulator::Result result;
+
+    if( argc > 1 )
+    {
+        TESTINFO( _simulate( argv[1], model, result ),
+                  "Load of " << argv[1] << " failed" );
+        std::cout << argv[1] << ": " << result << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    for( size_t i = 0; i < _nCases; ++i )
+    {
+        const Case& test = _cases[i];
+        model.setMotion( test.motion );
+
+        TESTINFO( _simulate( test.config, model, result ),
+                  "Load of " << test.config << " failed" );
+        std::cout << test.config << " motion " << test.motion << ": "
+                  << result << std::endl;
+
+        TESTINFO( result.frames == _nFrames, result );
+        TESTINFO( result.convergence <= test.convergence,
+                  test.config << ": " << result );
+        TESTINFO( result.imbalance < test.imbalance,
+                  test.config << ": " << result );
+    }
+    return EXIT_SUCCESS;
+}
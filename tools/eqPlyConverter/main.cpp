@@ -28,6 +28,7 @@
 
 #include <eq/eq.h>
 #include <triply/vertexBufferRoot.h>
+#include <lunchbox/clock.h>
 
 namespace
 {
@@ -49,8 +50,14 @@ static bool _isPlyfile( const std::string& filename )
 int main( const int argc, char** argv )
 {
     eq::Strings filenames;
+    bool compact = false;
     for( int i=1; i < argc; ++i )
-        filenames.push_back( argv[i] );
+    {
+        if( std::string( argv[i] ) == "--compact" )
+            compact = true;
+        else
+            filenames.push_back( argv[i] );
+    }
 
     while( !filenames.empty( ))
     {
@@ -60,7 +67,14 @@ int main( const int argc, char** argv )
         if( _isPlyfile( filename ))
         {
             triply::VertexBufferRoot* model = new triply::VertexBufferRoot;
-            if( !model->readFromFile( filename.c_str( )))
+            if( compact )
+                model->useCompactData();
+            lunchbox::Clock clock;
+            if( model->readFromFile( filename.c_str( )))
+                std::cout << filename << ": " << model->getNumberOfVertices()
+                          << " vertices in " << clock.getTimef() / 1000.f
+                          << " s" << std::endl;
+            else
                 LBWARN << "Can't load model: " << filename << std::endl;
 
             delete model;
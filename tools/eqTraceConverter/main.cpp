@@ -0,0 +1,218 @@
+/* Copyright (c) 2016, Stefan Eilemann <eile@equalizergraphics.com>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 2.1 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Converts a statistics trace written by an application run with
+// EQ_TRACE_FILE set into the Chrome trace event JSON format, for viewing in
+// chrome://tracing or Perfetto. Usage: eqTraceConverter trace [output.json]
+
+#include <eq/detail/traceFormat.h>
+
+#include <lunchbox/log.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+
+using eq::detail::TraceEvent;
+
+namespace
+{
+const char* const _trackNames[] = { "main", "readback", "transmit" };
+
+template< class T > bool _read( std::istream& is, T& value )
+{
+    return bool( is.read( reinterpret_cast< char* >( &value ), sizeof( T )));
+}
+
+bool _readName( std::istream& is, uint32_t& id, std::string& name )
+{
+    uint32_t length = 0;
+    if( !_read( is, id ) || !_read( is, length ))
+        return false;
+    name.resize( length );
+    return length == 0 || bool( is.read( &name[0], length ));
+}
+
+std::string _escape( const std::string& string )
+{
+    std::string escaped;
+    for( const char c : string )
+    {
+        if( c == '"' || c == '\\' )
+            escaped += '\\';
+        if( c >= ' ' )
+            escaped += c;
+    }
+    return escaped;
+}
+
+class Converter
+{
+public:
+    explicit Converter( std::ostream& os )
+        : _os( os ), _nEvents( 0 ), _first( true )
+    {
+        _os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    }
+
+    ~Converter() { _os << "\n]}" << std::endl; }
+
+    void setType( const uint32_t type, const std::string& name )
+    {
+        _types[ type ] = _escape( name );
+    }
+
+    void setEntity( const uint32_t originator, const std::string& name )
+    {
+        _next() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":"
+                << originator << ",\"args\":{\"name\":\"" << _escape( name )
+                << "\"}}";
+    }
+
+    void addEvent( const TraceEvent& event )
+    {
+        const std::string& name = _types[ event.type ];
+        const int64_t timestamp = event.startTime * 1000; // ms to us
+        ++_nEvents;
+
+        if( event.track == eq::detail::TRACK_COUNTER )
+        {
+            _next() << "{\"name\":\"" << name << "\",\"ph\":\"C\",\"pid\":"
+                    << event.originator << ",\"ts\":" << timestamp
+                    << ",\"args\":{\"value\":" << event.value << "}}";
+            return;
+        }
+
+        if( _tracks.insert( std::make_pair( event.originator,
+                                            event.track )).second &&
+            event.track < sizeof( _trackNames ) / sizeof( char* ))
+        {
+            _next() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"
+                    << event.originator << ",\"tid\":" << event.track
+                    << ",\"args\":{\"name\":\"" << _trackNames[ event.track ]
+                    << "\"}}";
+        }
+
+        _next() << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":"
+                << event.originator << ",\"tid\":" << event.track
+                << ",\"ts\":" << timestamp << ",\"dur\":"
+                << ( event.endTime - event.startTime ) * 1000
+                << ",\"args\":{\"frame\":" << event.frameNumber
+                << ",\"task\":" << event.task << ",\"values\":["
+                << event.values[0] << ',' << event.values[1]
+                << "],\"value\":" << event.value << "}}";
+    }
+
+    size_t getNumEvents() const { return _nEvents; }
+
+private:
+    std::ostream& _os;
+    std::map< uint32_t, std::string > _types;
+    std::set< std::pair< uint32_t, uint32_t > > _tracks;
+    size_t _nEvents;
+    bool _first;
+
+    std::ostream& _next()
+    {
+        _os << ( _first ? "\n" : ",\n" );
+        _first = false;
+        return _os;
+    }
+};
+}
+
+int main( const int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        std::cerr << "Usage: " << argv[0] << " trace [output.json]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string input = argv[1];
+    const std::string output = argc > 2 ? argv[2] : input + ".json";
+
+    std::ifstream is( input.c_str(), std::ios::binary );
+    char magic[ sizeof( eq::detail::traceMagic )];
+    uint32_t version = 0;
+    if( !is.read( magic, sizeof( magic )) || !_read( is, version ) ||
+        ::memcmp( magic, eq::detail::traceMagic, sizeof( magic )) != 0 )
+    {
+        LBERROR << "Can't read statistics trace " << input << std::endl;
+        return EXIT_FAILURE;
+    }
+    if( version != eq::detail::traceVersion )
+    {
+        LBERROR << "Unsupported trace version " << version
+                << ", or trace written on a machine of different endianness"
+                << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream os( output.c_str( ));
+    if( !os.is_open( ))
+    {
+        LBERROR << "Can't open " << output << " for writing" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    size_t nEvents = 0;
+    {
+        Converter converter( os );
+        uint8_t kind = 0;
+        bool valid = true;
+        while( valid && _read( is, kind ))
+        {
+            uint32_t id = 0;
+            std::string name;
+            TraceEvent event;
+
+            switch( kind )
+            {
+            case eq::detail::TRACE_TYPE:
+                valid = _readName( is, id, name );
+                converter.setType( id, name );
+                break;
+
+            case eq::detail::TRACE_ENTITY:
+                valid = _readName( is, id, name );
+                converter.setEntity( id, name );
+                break;
+
+            case eq::detail::TRACE_EVENT:
+                valid = _read( is, event );
+                if( valid )
+                    converter.addEvent( event );
+                break;
+
+            default:
+                valid = false;
+                break;
+            }
+        }
+        if( !valid ) // a truncated trace of an aborted application
+            LBWARN << "Trace ends with an incomplete or unknown record"
+                   << std::endl;
+        nEvents = converter.getNumEvents();
+    }
+
+    std::cout << "Converted " << nEvents << " events to " << output
+              << std::endl;
+    return EXIT_SUCCESS;
+}